@@ -0,0 +1,369 @@
+#ifndef RIDE_SHARING_BATCH_MATCHER_H
+#define RIDE_SHARING_BATCH_MATCHER_H
+
+#include <vector>
+#include <chrono>
+#include <algorithm>
+#include <limits>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+
+#include "driver_index.h"
+#include "dispatcher.h"
+#include "flat_id_table.h"
+#include "ride_request.h"
+
+/**
+ * @brief Sparse rectangular assignment problem in CSR form
+ * Row r may take the columns columns[rowStart[r] .. rowStart[r + 1]) at costs[e],
+ * or stay unassigned at unassignedCost. Costs are non-negative integers; smaller
+ * is better.
+ */
+struct SparseAssignmentProblem {
+    std::size_t rows = 0;
+    std::size_t columnCount = 0;
+    std::int64_t unassignedCost = 0;
+    std::vector<std::uint32_t> rowStart{ 0 };
+    std::vector<std::uint32_t> columns;
+    std::vector<std::int64_t> costs;
+
+    void addEdge(std::uint32_t column, std::int64_t cost) {
+        columns.push_back(column);
+        costs.push_back(cost);
+        columnCount = std::max<std::size_t>(columnCount, column + 1);
+    }
+
+    void endRow() {
+        rowStart.push_back(static_cast<std::uint32_t>(columns.size()));
+        ++rows;
+    }
+};
+
+struct AssignmentStats {
+    std::size_t augmentations = 0;
+    std::size_t scannedColumns = 0;   // columns settled by the shortest-path searches
+};
+
+constexpr std::uint32_t unassignedColumn = std::numeric_limits<std::uint32_t>::max();
+
+/**
+ * @brief Minimum-cost assignment by successive shortest augmenting paths (sparse Hungarian)
+ * Rows are added one at a time; a Dijkstra search over reduced costs, stopping
+ * at the first free column, finds the cheapest way to fit each one in, so the
+ * result is exactly optimal. Each row has a private column for staying
+ * unassigned. Returns the column of each row, or unassignedColumn.
+ */
+inline std::vector<std::uint32_t> solveAssignment(const SparseAssignmentProblem& problem,
+                                                  AssignmentStats* stats = nullptr) {
+    constexpr std::uint32_t none = unassignedColumn;
+    const std::size_t rows = problem.rows;
+    const std::size_t realColumns = problem.columnCount;
+    const std::vector<std::int64_t>& costs = problem.costs;
+    for (std::int64_t cost : costs) {
+        if (cost < 0) {
+            throw std::invalid_argument("Assignment costs must not be negative");
+        }
+    }
+    if (problem.unassignedCost < 0) {
+        throw std::invalid_argument("Assignment costs must not be negative");
+    }
+
+    // Columns realColumns + r are the unassigned options; potentials keep reduced costs non-negative
+    const std::size_t columnCount = realColumns + rows;
+    std::vector<std::int64_t> potential(columnCount, 0);
+    std::vector<std::int64_t> distance(columnCount, 0);
+    std::vector<std::uint32_t> rowOf(columnCount, none);
+    std::vector<std::uint32_t> viaRow(columnCount, none);
+    std::vector<std::int64_t> viaCost(columnCount, 0);
+    std::vector<bool> settled(columnCount, false);
+    std::vector<std::uint32_t> columnOf(rows, none);
+    std::vector<std::int64_t> assignedCost(rows, 0);
+    std::vector<std::uint32_t> touched;
+    std::vector<std::uint32_t> settledOrder;
+    using Entry = std::pair<std::int64_t, std::uint32_t>;
+    std::vector<Entry> heap;
+    AssignmentStats local;
+
+    auto relax = [&](std::uint32_t column, std::int64_t reached, std::uint32_t row, std::int64_t cost) {
+        if (settled[column]) {
+            return;
+        }
+        if (viaRow[column] == none) {
+            touched.push_back(column);
+        } else if (reached >= distance[column]) {
+            return;
+        }
+        distance[column] = reached;
+        viaRow[column] = row;
+        viaCost[column] = cost;
+        heap.emplace_back(reached, column);
+        std::push_heap(heap.begin(), heap.end(), std::greater<Entry>());
+    };
+    // Every column row may take, reached at offset plus its reduced cost given the row's dual
+    auto relaxRow = [&](std::uint32_t row, std::int64_t offset, std::int64_t dual) {
+        for (std::uint32_t e = problem.rowStart[row]; e < problem.rowStart[row + 1]; ++e) {
+            relax(problem.columns[e], offset + costs[e] - potential[problem.columns[e]] - dual, row, costs[e]);
+        }
+        const auto own = static_cast<std::uint32_t>(realColumns + row);
+        relax(own, offset + problem.unassignedCost - potential[own] - dual, row, problem.unassignedCost);
+    };
+
+    for (std::uint32_t source = 0; source < rows; ++source) {
+        const auto own = static_cast<std::uint32_t>(realColumns + source);
+        std::int64_t dual = problem.unassignedCost - potential[own];
+        for (std::uint32_t e = problem.rowStart[source]; e < problem.rowStart[source + 1]; ++e) {
+            dual = std::min(dual, costs[e] - potential[problem.columns[e]]);
+        }
+        relaxRow(source, 0, dual);
+
+        // The row's own unassigned column is always free, so the search always ends
+        std::uint32_t target = none;
+        while (target == none) {
+            std::pop_heap(heap.begin(), heap.end(), std::greater<Entry>());
+            const Entry next = heap.back();
+            heap.pop_back();
+            const std::uint32_t column = next.second;
+            if (settled[column] || next.first != distance[column]) {
+                continue;
+            }
+            settled[column] = true;
+            settledOrder.push_back(column);
+            const std::uint32_t holder = rowOf[column];
+            if (holder == none) {
+                target = column;
+                break;
+            }
+            // The holder's assigned edge is tight, which fixes its dual
+            relaxRow(holder, distance[column], assignedCost[holder] - potential[column]);
+        }
+
+        const std::int64_t reach = distance[target];
+        for (std::uint32_t column : settledOrder) {
+            potential[column] -= reach - distance[column];
+        }
+        for (std::uint32_t column = target;;) {
+            const std::uint32_t row = viaRow[column];
+            const std::uint32_t previous = columnOf[row];
+            rowOf[column] = row;
+            columnOf[row] = column;
+            assignedCost[row] = viaCost[column];
+            if (row == source) {
+                break;
+            }
+            column = previous;
+        }
+        local.scannedColumns += settledOrder.size();
+        ++local.augmentations;
+        for (std::uint32_t column : touched) {
+            viaRow[column] = none;
+            settled[column] = false;
+        }
+        touched.clear();
+        settledOrder.clear();
+        heap.clear();
+    }
+
+    for (std::uint32_t& column : columnOf) {
+        if (column >= realColumns) {
+            column = none;
+        }
+    }
+    if (stats != nullptr) {
+        *stats = local;
+    }
+    return columnOf;
+}
+
+/**
+ * @brief Cost model for one request/driver pair; lower is better
+ * cost = perKm * km + perEtaMinute * eta + perMissingStar * (5 - rating).
+ * Pairs costing more than maxCost are never offered. BatchMatcher first
+ * maximizes the number of matches and then minimizes their total cost.
+ */
+struct MatchingWeights {
+    double perKm = 1.0;
+    double perEtaMinute = 0.5;
+    double perMissingStar = 2.0;
+    double averageSpeedKmh = 30.0;
+    double maxCost = 60.0;
+    std::size_t candidates = 8;      // nearest drivers offered to each request
+    double maxRadiusKm = 10.0;
+    double costResolution = 0.001;   // costs are rounded to these units before solving
+    std::size_t residualRounds = 2;  // re-matching passes for requests whose candidates were taken
+};
+
+struct BatchMatchStats {
+    std::size_t requests = 0;
+    std::size_t drivers = 0;
+    std::size_t edges = 0;
+    double totalCost = 0.0;
+    AssignmentStats solver;
+};
+
+/**
+ * @brief BatchMatcher class - collects requests over a window and matches them jointly
+ * Candidates come from DriverIndex::nearestAvailable, so each request costs one
+ * index query. Leaving a request unserved costs more than every candidate pair in
+ * the round put together, so solveAssignment() serves as many requests as the
+ * candidate lists allow and, among those matchings, picks the one with the least
+ * total cost (in costResolution units).
+ */
+class BatchMatcher {
+public:
+    using Clock = std::chrono::steady_clock;
+
+private:
+    struct LocalDriver {
+        int id;
+        std::uint32_t slot;
+    };
+
+    MatchingWeights weights;
+    Clock::duration window;
+    std::vector<RideRequest> pending;
+    Clock::time_point windowStart;
+    BatchMatchStats stats;
+
+    double costOf(const DriverMatch& match) const {
+        const double etaMinutes = match.distanceKm / weights.averageSpeedKmh * 60.0;
+        return weights.perKm * match.distanceKm + weights.perEtaMinute * etaMinutes
+             + weights.perMissingStar * (5.0 - match.rating);
+    }
+
+    // One joint assignment over requests; requests left without a driver go to leftover
+    void solveRound(const std::vector<RideRequest>& requests, DriverIndex& index, DispatchResult& result,
+                    std::vector<RideRequest>& leftover) {
+        // Candidate edges per request, with drivers renumbered densely
+        const std::size_t requestCount = requests.size();
+        std::vector<std::uint32_t> edgeStart{ 0 };
+        std::vector<std::uint32_t> edgeDriver;
+        std::vector<DriverMatch> edgeMatch;
+        std::vector<int> driverIDs;
+        FlatIdTable<LocalDriver> local(requestCount * weights.candidates / 2);
+        edgeDriver.reserve(requestCount * weights.candidates);
+        edgeMatch.reserve(requestCount * weights.candidates);
+        for (const RideRequest& request : requests) {
+            for (const DriverMatch& match : index.nearestAvailable(request.pickupPosition, weights.candidates,
+                                                                   weights.maxRadiusKm)) {
+                if (costOf(match) > weights.maxCost) {
+                    continue;
+                }
+                const LocalDriver* known = local.find(match.driverID);
+                if (known == nullptr) {
+                    known = local.insert(LocalDriver{ match.driverID, static_cast<std::uint32_t>(driverIDs.size()) });
+                    driverIDs.push_back(match.driverID);
+                }
+                edgeDriver.push_back(known->slot);
+                edgeMatch.push_back(match);
+            }
+            edgeStart.push_back(static_cast<std::uint32_t>(edgeDriver.size()));
+        }
+        const std::size_t driverCount = driverIDs.size();
+        stats.drivers += driverCount;
+        stats.edges += edgeDriver.size();
+
+        // Any matching's costs total at most matchable * maxUnits, so one more match outweighs them
+        const auto maxUnits = static_cast<std::int64_t>(std::ceil(weights.maxCost / weights.costResolution));
+        const std::size_t matchable = std::min(requestCount, driverCount);
+        const std::int64_t unitLimit = std::numeric_limits<std::int64_t>::max() / 4;
+        if (maxUnits > unitLimit / static_cast<std::int64_t>(matchable + 1)) {
+            throw std::invalid_argument("Matching round is too large for the cost resolution");
+        }
+        SparseAssignmentProblem problem;
+        problem.unassignedCost = static_cast<std::int64_t>(matchable) * maxUnits + 1;
+        problem.rowStart.reserve(requestCount + 1);
+        problem.columns.reserve(edgeDriver.size());
+        problem.costs.reserve(edgeDriver.size());
+        for (std::size_t r = 0; r < requestCount; ++r) {
+            for (std::uint32_t e = edgeStart[r]; e < edgeStart[r + 1]; ++e) {
+                const double units = std::max(0.0, costOf(edgeMatch[e]) / weights.costResolution);
+                problem.addEdge(edgeDriver[e], std::min(maxUnits, static_cast<std::int64_t>(std::llround(units))));
+            }
+            problem.endRow();
+        }
+
+        AssignmentStats solved;
+        const std::vector<std::uint32_t> assignment = solveAssignment(problem, &solved);
+        stats.solver.augmentations += solved.augmentations;
+        stats.solver.scannedColumns += solved.scannedColumns;
+
+        for (std::size_t r = 0; r < requestCount; ++r) {
+            const RideRequest& request = requests[r];
+            const std::uint32_t driver = assignment[r];
+            if (driver == unassignedColumn) {
+                leftover.push_back(request);
+                continue;
+            }
+            for (std::uint32_t e = edgeStart[r]; e < edgeStart[r + 1]; ++e) {
+                if (edgeDriver[e] == driver) {
+                    const DriverMatch& match = edgeMatch[e];
+                    result.assignments.push_back(Assignment{ request.requestID, request.riderID,
+                                                             match.driverID, match.distanceKm, false });
+                    stats.totalCost += costOf(match);
+                    index.setAvailable(match.driverID, false);
+                    break;
+                }
+            }
+        }
+    }
+
+public:
+    explicit BatchMatcher(const MatchingWeights& weights = MatchingWeights{},
+                          Clock::duration window = std::chrono::seconds(2))
+        : weights(weights), window(window) {
+        if (weights.averageSpeedKmh <= 0 || weights.maxCost <= 0 || weights.costResolution <= 0) {
+            throw std::invalid_argument("Matching speed, cost cap and resolution must be greater than 0");
+        }
+        if (weights.candidates == 0) {
+            throw std::invalid_argument("At least one candidate per request is required");
+        }
+    }
+
+    void submit(const RideRequest& request, Clock::time_point now = Clock::now()) {
+        if (pending.empty()) {
+            windowStart = now;
+        }
+        pending.push_back(request);
+    }
+
+    // True once the oldest pending request has waited a full window
+    bool ready(Clock::time_point now = Clock::now()) const {
+        return !pending.empty() && now - windowStart >= window;
+    }
+
+    std::size_t pendingCount() const { return pending.size(); }
+
+    /**
+     * @brief Matches every pending request against the available drivers in index
+     * Requests left unmatched are re-queried (their candidates were taken) for up
+     * to residualRounds more rounds. Matched drivers are marked unavailable in
+     * index; recording rides on Driver and Rider objects is left to the caller,
+     * as with ParallelDispatcher
+     */
+    DispatchResult match(DriverIndex& index) {
+        DispatchResult result;
+        stats = BatchMatchStats{};
+        stats.requests = pending.size();
+        std::vector<RideRequest> round;
+        round.swap(pending);
+        for (std::size_t r = 0; !round.empty(); ++r) {
+            std::vector<RideRequest> leftover;
+            const std::size_t matchedBefore = result.assignments.size();
+            solveRound(round, index, result, leftover);
+            if (r == weights.residualRounds || result.assignments.size() == matchedBefore) {
+                result.unassigned.insert(result.unassigned.end(), leftover.begin(), leftover.end());
+                break;
+            }
+            round.swap(leftover);
+        }
+        return result;
+    }
+
+    // Size and cost of the last match() call, summed over its rounds
+    const BatchMatchStats& lastStats() const { return stats; }
+    const MatchingWeights& getWeights() const { return weights; }
+};
+
+#endif // RIDE_SHARING_BATCH_MATCHER_H
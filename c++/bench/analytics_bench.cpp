@@ -0,0 +1,70 @@
+/**
+ * @brief Benchmark: end-of-day RideReport build time vs. worker count
+ * Built by the analytics_bench CMake target
+ * Usage: analytics_bench [maxWorkers] [rideCount] [locationCount]
+ */
+#include <iostream>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <random>
+#include <thread>
+#include <iomanip>
+#include <cstdlib>
+#include <cmath>
+
+#include "../ride_analytics.h"
+
+int main(int argc, char** argv) {
+    const std::size_t maxWorkers = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : defaultAnalyticsWorkers();
+    const std::size_t rideCount = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 5000000;
+    const int locationCount = argc > 3 ? std::atoi(argv[3]) : 2000;
+
+    std::mt19937 rng(29);
+    std::vector<LocationID> locations;
+    for (int i = 0; i < locationCount; ++i) {
+        locations.push_back(LocationTable::global().intern("Stop " + std::to_string(i)));
+    }
+    std::uniform_int_distribution<int> pick(0, locationCount - 1);
+    std::uniform_real_distribution<double> distance(0.5, 30.0);
+
+    RideRegistry rides;
+    rides.reserve<StandardRide>(rideCount);
+    for (std::size_t i = 0; i < rideCount; ++i) {
+        const LocationID pickup = locations[pick(rng)];
+        const LocationID dropoff = locations[pick(rng)];
+        const RideIndex ride = i % 4 == 0
+            ? rides.create<PremiumRide>(static_cast<int>(i), pickup, dropoff, distance(rng))
+            : rides.create<StandardRide>(static_cast<int>(i), pickup, dropoff, distance(rng));
+        rides[ride].calculateFare();
+    }
+
+    std::cout << std::setw(8) << "workers" << std::setw(12) << "report ms" << std::setw(14) << "revenue"
+              << std::setw(10) << "p50 mi" << std::setw(10) << "p99 mi" << std::endl;
+
+    bool consistent = true;
+    double expectedRevenue = 0.0;
+    for (std::size_t workers = 1; workers <= maxWorkers; workers *= 2) {
+        auto start = std::chrono::steady_clock::now();
+        const RideReport report = RideReport::build(rides, workers);
+        auto stop = std::chrono::steady_clock::now();
+
+        const double revenue = report.overall().fare;
+        if (workers == 1) {
+            expectedRevenue = revenue;
+        }
+        consistent = std::fabs(revenue - expectedRevenue) <= 1e-6 * expectedRevenue && consistent;
+        std::cout << std::setw(8) << workers
+                  << std::setw(12) << std::fixed << std::setprecision(2)
+                  << std::chrono::duration<double, std::milli>(stop - start).count()
+                  << std::setw(14) << revenue
+                  << std::setw(10) << report.distancePercentile(0.50)
+                  << std::setw(10) << report.distancePercentile(0.99) << std::endl;
+    }
+
+    if (!consistent) {
+        std::cerr << "Revenue differs between worker counts" << std::endl;
+        return 1;
+    }
+    return 0;
+}
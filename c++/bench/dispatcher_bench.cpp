@@ -0,0 +1,65 @@
+/**
+ * @brief Benchmark: ParallelDispatcher round latency vs. worker count
+ * Built by the dispatcher_bench CMake target
+ * Usage: dispatcher_bench [maxWorkers] [driverCount] [requestCount]
+ */
+#include <iostream>
+#include <vector>
+#include <unordered_set>
+#include <chrono>
+#include <random>
+#include <thread>
+#include <iomanip>
+#include <cstdlib>
+
+#include "../dispatcher.h"
+
+int main(int argc, char** argv) {
+    const std::size_t hardware = std::thread::hardware_concurrency() ? std::thread::hardware_concurrency() : 1;
+    const std::size_t maxWorkers = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : hardware;
+    const int driverCount = argc > 2 ? std::atoi(argv[2]) : 100000;
+    const int requestCount = argc > 3 ? std::atoi(argv[3]) : 50000;
+
+    std::cout << std::setw(8) << "workers" << std::setw(12) << "round ms" << std::setw(14) << "assigned"
+              << std::setw(10) << "stolen" << std::endl;
+
+    bool consistent = true;
+    for (std::size_t workers = 1; workers <= maxWorkers; workers *= 2) {
+        std::mt19937 rng(11);
+        std::uniform_real_distribution<double> offset(0.0, 0.30);
+        std::uniform_real_distribution<double> rating(3.0, 5.0);
+
+        ParallelDispatcher dispatcher(workers);
+        for (int id = 0; id < driverCount; ++id) {
+            dispatcher.updateDriver(id, rating(rng), GeoPoint{ 40.60 + offset(rng), -74.10 + offset(rng) });
+        }
+        for (int i = 0; i < requestCount; ++i) {
+            RideRequest request{};
+            request.requestID = static_cast<std::uint64_t>(i);
+            request.riderID = i;
+            request.pickupPosition = GeoPoint{ 40.60 + offset(rng), -74.10 + offset(rng) };
+            request.distance = 3.0;
+            dispatcher.submit(request);
+        }
+
+        auto start = std::chrono::steady_clock::now();
+        DispatchResult result = dispatcher.dispatch();
+        auto stop = std::chrono::steady_clock::now();
+
+        std::unordered_set<int> used;
+        for (const Assignment& assignment : result.assignments) {
+            consistent = used.insert(assignment.driverID).second && consistent;
+        }
+        std::cout << std::setw(8) << workers
+                  << std::setw(12) << std::fixed << std::setprecision(2)
+                  << std::chrono::duration<double, std::milli>(stop - start).count()
+                  << std::setw(14) << result.assignments.size()
+                  << std::setw(10) << result.stolen << std::endl;
+    }
+
+    if (!consistent) {
+        std::cerr << "A driver was assigned twice" << std::endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,68 @@
+/**
+ * @brief Micro-benchmark: k-nearest-available-driver queries and position updates
+ * Built by the driver_index_bench CMake target
+ * Usage: driver_index_bench [driverCount] [queryCount] [k]
+ */
+#include <iostream>
+#include <vector>
+#include <chrono>
+#include <random>
+#include <iomanip>
+#include <cstdlib>
+#include <algorithm>
+
+#include "../geo.h"
+#include "../driver_index.h"
+
+int main(int argc, char** argv) {
+    const int driverCount = argc > 1 ? std::atoi(argv[1]) : 100000;
+    const int queryCount = argc > 2 ? std::atoi(argv[2]) : 10000;
+    const std::size_t k = argc > 3 ? std::strtoul(argv[3], nullptr, 10) : 5;
+
+    // A metro-sized box around Manhattan
+    const GeoPoint origin{ 40.60, -74.10 };
+    std::mt19937 rng(7);
+    std::uniform_real_distribution<double> latDist(0.0, 0.30);
+    std::uniform_real_distribution<double> lonDist(0.0, 0.30);
+    std::uniform_real_distribution<double> ratingDist(3.0, 5.0);
+    std::normal_distribution<double> jitter(0.0, 0.0005);
+
+    DriverIndex index;
+    std::vector<GeoPoint> positions(driverCount);
+    auto start = std::chrono::steady_clock::now();
+    for (int id = 0; id < driverCount; ++id) {
+        positions[id] = GeoPoint{ origin.lat + latDist(rng), origin.lon + lonDist(rng) };
+        index.updatePosition(id, ratingDist(rng), positions[id]);
+    }
+    auto stop = std::chrono::steady_clock::now();
+    std::cout << "Inserted " << driverCount << " drivers in "
+              << std::chrono::duration<double, std::milli>(stop - start).count() << " ms" << std::endl;
+
+    start = std::chrono::steady_clock::now();
+    for (int id = 0; id < driverCount; ++id) {
+        positions[id].lat += jitter(rng);
+        positions[id].lon += jitter(rng);
+        index.updatePosition(id, 4.5, positions[id]);
+    }
+    stop = std::chrono::steady_clock::now();
+    std::cout << "Position update: " << std::fixed << std::setprecision(1)
+              << std::chrono::duration<double, std::nano>(stop - start).count() / driverCount
+              << " ns/update" << std::endl;
+
+    std::vector<double> latencies;
+    latencies.reserve(queryCount);
+    std::size_t matched = 0;
+    for (int q = 0; q < queryCount; ++q) {
+        const GeoPoint pickup{ origin.lat + latDist(rng), origin.lon + lonDist(rng) };
+        auto queryStart = std::chrono::steady_clock::now();
+        matched += index.nearestAvailable(pickup, k).size();
+        auto queryStop = std::chrono::steady_clock::now();
+        latencies.push_back(std::chrono::duration<double, std::micro>(queryStop - queryStart).count());
+    }
+    std::sort(latencies.begin(), latencies.end());
+    std::cout << "k=" << k << " query latency: p50 " << latencies[latencies.size() / 2]
+              << " us, p99 " << latencies[latencies.size() * 99 / 100]
+              << " us, max " << latencies.back() << " us" << std::endl;
+
+    return matched == static_cast<std::size_t>(queryCount) * k ? 0 : 1;
+}
@@ -0,0 +1,67 @@
+/**
+ * @brief Check: Driver::emplaceRide() from wire-buffer string_views allocates nothing
+ * Once the registry, the driver's ride list and timeline are reserved and the
+ * location names are interned, a round of emplaced rides must not reach
+ * operator new. Exits nonzero on failure
+ * Built by the emplace_alloc_check CMake target
+ * Usage: emplace_alloc_check [ridesPerRound]
+ */
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <atomic>
+#include <new>
+#include <cstdint>
+#include <cstdlib>
+
+#include "../ride.h"
+#include "../ride_registry.h"
+#include "../location_table.h"
+#include "../driver.h"
+
+// Counts every global operator new between the markers below
+static std::atomic<std::uint64_t> allocationCount{0};
+
+[[gnu::noinline]] void* operator new(std::size_t size) {
+    allocationCount.fetch_add(1, std::memory_order_relaxed);
+    if (void* memory = std::malloc(size == 0 ? 1 : size)) {
+        return memory;
+    }
+    throw std::bad_alloc();
+}
+
+// Kept out of line, like operator new, so GCC does not pair an inlined malloc()/free()
+// with a new/delete-expression and warn about mismatched allocation functions
+[[gnu::noinline]] void operator delete(void* memory) noexcept { std::free(memory); }
+[[gnu::noinline]] void operator delete(void* memory, std::size_t) noexcept { std::free(memory); }
+
+int main(int argc, char** argv) {
+    const int ridesPerRound = argc > 1 ? std::atoi(argv[1]) : 1024;
+    if (ridesPerRound <= 0) {
+        std::cerr << "ridesPerRound must be greater than 0" << std::endl;
+        return 1;
+    }
+    // Names longer than the small-string buffer, sliced out of one wire buffer
+    const std::string wire = "Terminal 4 Departures Level|Convention Center North Entrance";
+    const std::string_view view = wire;
+    const std::string_view pickup = view.substr(0, view.find('|'));
+    const std::string_view dropoff = view.substr(view.find('|') + 1);
+
+    RideRegistry registry;
+    Driver driver(101, "John Doe", 4.8, registry);
+    LocationTable::global().intern(pickup);
+    LocationTable::global().intern(dropoff);
+    registry.reserve<StandardRide>(static_cast<std::size_t>(ridesPerRound));
+    driver.reserveRides(static_cast<std::size_t>(ridesPerRound));
+
+    const std::uint64_t before = allocationCount.load(std::memory_order_relaxed);
+    for (int i = 0; i < ridesPerRound; ++i) {
+        driver.emplaceRide<StandardRide>(registry, i, pickup, dropoff, 5.0);
+    }
+    const std::uint64_t allocations = allocationCount.load(std::memory_order_relaxed) - before;
+
+    const bool ok = allocations == 0 && driver.getAssignedRides().size() == static_cast<std::size_t>(ridesPerRound);
+    std::cout << (ok ? "PASS" : "FAIL") << ": " << allocations << " allocations for " << ridesPerRound
+              << " emplaced rides" << std::endl;
+    return ok ? 0 : 1;
+}
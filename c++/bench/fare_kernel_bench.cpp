@@ -0,0 +1,110 @@
+/**
+ * @brief Micro-benchmark: virtual calculateFare() vs. value rides and batch fare kernels
+ * Built by the fare_kernel_bench CMake target
+ * Usage: fare_kernel_bench [rideCount] [repetitions]
+ */
+#include <iostream>
+#include <vector>
+#include <memory>
+#include <chrono>
+#include <random>
+#include <string>
+#include <iomanip>
+#include <cstdlib>
+#include <functional>
+
+#include "../ride.h"
+#include "../ride_batch.h"
+#include "../fare_kernel.h"
+#include "../ride_value.h"
+
+namespace {
+
+// Runs body `repetitions` times and returns the best time in nanoseconds per ride
+double bestNsPerRide(std::size_t rideCount, int repetitions, const std::function<void()>& body) {
+    double best = 0.0;
+    for (int rep = 0; rep < repetitions; ++rep) {
+        auto start = std::chrono::steady_clock::now();
+        body();
+        auto stop = std::chrono::steady_clock::now();
+        double ns = std::chrono::duration<double, std::nano>(stop - start).count() / rideCount;
+        if (rep == 0 || ns < best) {
+            best = ns;
+        }
+    }
+    return best;
+}
+
+void report(const std::string& name, double nsPerRide, double baseline) {
+    std::cout << std::left << std::setw(20) << name
+              << std::right << std::fixed << std::setprecision(3) << std::setw(10) << nsPerRide << " ns/ride"
+              << std::setprecision(1) << std::setw(10) << baseline / nsPerRide << "x" << std::endl;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const std::size_t rideCount = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 1000000;
+    const int repetitions = argc > 2 ? std::atoi(argv[2]) : 10;
+
+    std::mt19937 rng(42);
+    std::uniform_real_distribution<double> distanceDist(0.5, 40.0);
+    std::bernoulli_distribution premiumDist(0.3);
+
+    std::vector<std::shared_ptr<Ride> > rides;
+    RideBatch batch;
+    rides.reserve(rideCount);
+    batch.reserve(rideCount);
+    for (std::size_t i = 0; i < rideCount; ++i) {
+        const int id = static_cast<int>(i);
+        const double dist = distanceDist(rng);
+        if (premiumDist(rng)) {
+            rides.push_back(std::make_shared<PremiumRide>(id, "A", "B", dist));
+        } else {
+            rides.push_back(std::make_shared<StandardRide>(id, "A", "B", dist));
+        }
+        batch.addRide(id, dist, rides.back()->getRideType());
+    }
+
+    std::cout << "Pricing " << rideCount << " rides, best of " << repetitions << " runs" << std::endl;
+    std::cout << "Detected kernel: " << fareKernelName(detectFareKernel()) << std::endl;
+
+    const double virtualNs = bestNsPerRide(rideCount, repetitions, [&]() {
+        for (const auto& ride : rides) {
+            ride->calculateFare();
+        }
+    });
+    report("virtual dispatch", virtualNs, virtualNs);
+
+    std::vector<RideValue> values;
+    values.reserve(rideCount);
+    for (const auto& ride : rides) {
+        values.push_back(toRideValue(*ride));
+    }
+    const double valueNs = bestNsPerRide(rideCount, repetitions, [&]() { calculateFares(values); });
+    report("variant values", valueNs, virtualNs);
+
+    const double batchNs = bestNsPerRide(rideCount, repetitions, [&]() { calculateFares(batch); });
+    report("batch loop", batchNs, virtualNs);
+
+    const FareKernel kernels[] = { FareKernel::Scalar, FareKernel::Neon, FareKernel::Avx2, FareKernel::Avx512 };
+    bool allMatch = true;
+    for (FareKernel kernel : kernels) {
+        if (!isFareKernelSupported(kernel)) {
+            continue;
+        }
+        const double ns = bestNsPerRide(rideCount, repetitions, [&]() { calculateFares(batch, kernel); });
+        report(std::string("kernel ") + fareKernelName(kernel), ns, virtualNs);
+
+        for (std::size_t i = 0; i < rideCount; ++i) {
+            if (batch.getFare(i) != rides[i]->getFare()) {
+                std::cerr << "Fare mismatch for kernel " << fareKernelName(kernel)
+                          << " at ride " << batch.getRideID(i) << std::endl;
+                allMatch = false;
+                break;
+            }
+        }
+    }
+
+    return allMatch ? 0 : 1;
+}
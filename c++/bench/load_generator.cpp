@@ -0,0 +1,313 @@
+/**
+ * @brief Load generator and replay harness: a simulated city day, end to end
+ * Generates (or replays) riders, drivers and requests with hotspots, a rush-hour
+ * curve and a Standard/Premium/Pooled mix, then runs them window by window
+ * through ParallelDispatcher, the vectorized fare kernel, RideRegistry and the
+ * Driver/Rider histories as fast as the machine allows. Drivers are busy for
+ * the simulated trip and reappear at the dropoff; unmatched requests retry
+ * until maxWait. Reports throughput, per-stage and per-request latency
+ * percentiles, rider wait times and the hourly profile.
+ * Built by the load_generator CMake target
+ * Usage: load_generator [--riders N] [--drivers N] [--requests N] [--workers N]
+ *                       [--window SECONDS] [--seed N] [--record FILE] [--replay FILE]
+ */
+#include <iostream>
+#include <fstream>
+#include <vector>
+#include <queue>
+#include <string>
+#include <chrono>
+#include <thread>
+#include <algorithm>
+#include <iomanip>
+#include <cstdlib>
+#include <cstring>
+#include <stdexcept>
+
+#include "../load_generator.h"
+#include "../dispatcher.h"
+#include "../fare_kernel.h"
+#include "../ride_batch.h"
+#include "../ride_registry.h"
+#include "../participant_registry.h"
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+struct Options {
+    std::size_t riders = 100000;
+    std::size_t drivers = 30000;
+    std::size_t requests = 1000000;
+    std::size_t workers = std::max(1u, std::thread::hardware_concurrency());
+    std::int64_t windowSeconds = 10;
+    std::int64_t maxWaitSeconds = 300;
+    double speedKmh = 25.0;
+    std::uint64_t seed = 1;
+    std::string record;
+    std::string replay;
+};
+
+struct Trip {
+    std::int64_t endsAt;
+    int driverID;
+    GeoPoint dropoff;
+
+    bool operator>(const Trip& other) const { return endsAt > other.endsAt; }
+};
+
+struct Waiting {
+    std::size_t request;   // index into the trace
+    std::int64_t since;
+};
+
+double percentile(std::vector<double>& samples, double q) {
+    if (samples.empty()) {
+        return 0.0;
+    }
+    const std::size_t at = static_cast<std::size_t>(q * (samples.size() - 1));
+    std::nth_element(samples.begin(), samples.begin() + at, samples.end());
+    return samples[at];
+}
+
+void printPercentiles(const char* label, std::vector<double>& samples, const char* unit) {
+    std::cout << std::left << std::setw(22) << label << std::right << std::fixed << std::setprecision(2)
+              << std::setw(11) << percentile(samples, 0.50) << std::setw(11) << percentile(samples, 0.99)
+              << std::setw(11) << percentile(samples, 0.999) << "  " << unit << std::endl;
+}
+
+bool parse(int argc, char** argv, Options& options) {
+    for (int i = 1; i < argc; ++i) {
+        const char* flag = argv[i];
+        if (i + 1 >= argc) {
+            std::cerr << "Missing value for " << flag << std::endl;
+            return false;
+        }
+        const char* value = argv[++i];
+        if (std::strcmp(flag, "--riders") == 0) {
+            options.riders = std::strtoul(value, nullptr, 10);
+        } else if (std::strcmp(flag, "--drivers") == 0) {
+            options.drivers = std::strtoul(value, nullptr, 10);
+        } else if (std::strcmp(flag, "--requests") == 0) {
+            options.requests = std::strtoul(value, nullptr, 10);
+        } else if (std::strcmp(flag, "--workers") == 0) {
+            options.workers = std::strtoul(value, nullptr, 10);
+        } else if (std::strcmp(flag, "--window") == 0) {
+            options.windowSeconds = std::strtol(value, nullptr, 10);
+        } else if (std::strcmp(flag, "--seed") == 0) {
+            options.seed = std::strtoull(value, nullptr, 10);
+        } else if (std::strcmp(flag, "--record") == 0) {
+            options.record = value;
+        } else if (std::strcmp(flag, "--replay") == 0) {
+            options.replay = value;
+        } else {
+            std::cerr << "Unknown option " << flag << std::endl;
+            return false;
+        }
+    }
+    if (options.riders == 0 || options.workers == 0 || options.windowSeconds <= 0) {
+        std::cerr << "riders, workers and window must be greater than 0" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    Options options;
+    if (!parse(argc, argv, options)) {
+        return 1;
+    }
+
+    // Tuesday 2026-03-03 00:00 UTC, so timestamps read as a normal weekday
+    constexpr std::int64_t dayStart = 1772496000;
+    const auto setupStart = Clock::now();
+    TrafficTrace trace;
+    if (!options.replay.empty()) {
+        std::ifstream in(options.replay, std::ios::binary);
+        if (!in) {
+            std::cerr << "Cannot open " << options.replay << std::endl;
+            return 1;
+        }
+        try {
+            trace = traffic_trace::read(in);
+        } catch (const std::runtime_error& error) {
+            std::cerr << options.replay << ": " << error.what() << std::endl;
+            return 1;
+        }
+    } else {
+        TrafficGenerator generator(TrafficProfile::metro(), options.seed);
+        trace = generator.trace(options.riders, options.drivers, options.requests, dayStart);
+    }
+    if (!options.record.empty()) {
+        std::ofstream out(options.record, std::ios::binary);
+        traffic_trace::write(out, trace);
+        std::cout << "Recorded trace to " << options.record << std::endl;
+    }
+    if (trace.drivers.empty() || trace.requests.empty()) {
+        std::cerr << "Trace has no drivers or no requests" << std::endl;
+        return 1;
+    }
+    // Assignments find their request by ID, so replayed traces must be ordered and numbered like generated ones
+    for (std::size_t i = 0; i < trace.requests.size(); ++i) {
+        const RideRequest& request = trace.requests[i].request;
+        if (request.requestID != i + 1 || request.riderID < 1
+            || static_cast<std::size_t>(request.riderID) > trace.riderCount
+            || (i > 0 && trace.requests[i].timestamp < trace.requests[i - 1].timestamp)) {
+            std::cerr << "Trace request " << i << " is out of order or has an unknown rider" << std::endl;
+            return 1;
+        }
+    }
+
+    RideRegistry rides;
+    rides.reserve(trace.requests.size());
+    DriverRegistry drivers(rides, trace.drivers.size());
+    RiderRegistry riders(rides, trace.riderCount);
+    ParallelDispatcher dispatcher(options.workers);
+    for (const GeneratedDriver& driver : trace.drivers) {
+        drivers.add(driver.driverID, "Driver", driver.rating, driver.position);
+        dispatcher.updateDriver(driver.driverID, driver.rating, driver.position);
+    }
+    for (std::size_t r = 1; r <= trace.riderCount; ++r) {
+        riders.add(static_cast<int>(r), "Rider");
+    }
+    const double setupSeconds = std::chrono::duration<double>(Clock::now() - setupStart).count();
+
+    std::priority_queue<Trip, std::vector<Trip>, std::greater<Trip>> trips;
+    std::vector<Waiting> waiting;
+    std::vector<Waiting> retry;
+    std::vector<std::size_t> waitingIndex(trace.requests.size() + 1, 0);   // by request ID
+    std::vector<double> dispatchMicros;
+    std::vector<double> priceMicros;
+    std::vector<double> recordMicros;
+    std::vector<double> requestMicros;   // window start until the request's ride is recorded
+    std::vector<double> waitSeconds;     // simulated time from request to match
+    std::size_t matched = 0;
+    std::size_t abandoned = 0;
+    std::size_t byType[rideTypeCount] = {};
+    double revenue[rideTypeCount] = {};
+    std::size_t hourlyRequests[24] = {};
+    std::size_t hourlyMatched[24] = {};
+    RideBatch batch;
+
+    const auto runStart = Clock::now();
+    std::size_t next = 0;
+    for (std::int64_t windowEnd = trace.requests.front().timestamp + options.windowSeconds;
+         next < trace.requests.size() || !waiting.empty(); windowEnd += options.windowSeconds) {
+        while (!trips.empty() && trips.top().endsAt <= windowEnd) {
+            const Trip trip = trips.top();
+            trips.pop();
+            const DriverStatus& status = *drivers.status(trip.driverID);
+            dispatcher.updateDriver(trip.driverID, status.rating, trip.dropoff);
+            dispatcher.releaseDriver(trip.driverID);
+            drivers.updatePosition(trip.driverID, trip.dropoff);
+        }
+        while (next < trace.requests.size() && trace.requests[next].timestamp < windowEnd) {
+            const GeneratedRequest& generated = trace.requests[next];
+            ++hourlyRequests[((generated.timestamp - dayStart) / 3600 % 24 + 24) % 24];
+            waiting.push_back(Waiting{ next, generated.timestamp });
+            ++next;
+        }
+        if (waiting.empty()) {
+            continue;
+        }
+
+        const auto windowStart = Clock::now();
+        for (std::size_t w = 0; w < waiting.size(); ++w) {
+            const RideRequest& request = trace.requests[waiting[w].request].request;
+            waitingIndex[request.requestID] = w;
+            dispatcher.submit(request);
+        }
+        const DispatchResult result = dispatcher.dispatch();
+        const auto dispatched = Clock::now();
+
+        batch.clear();
+        batch.reserve(result.assignments.size());
+        for (const Assignment& assignment : result.assignments) {
+            const RideRequest& request = trace.requests[assignment.requestID - 1].request;
+            batch.addRide(static_cast<int>(request.requestID), request.distance, request.type);
+        }
+        calculateFaresVectorized(batch);
+        const auto priced = Clock::now();
+
+        for (std::size_t a = 0; a < result.assignments.size(); ++a) {
+            const Assignment& assignment = result.assignments[a];
+            const GeneratedRequest& generated = trace.requests[assignment.requestID - 1];
+            const RideRequest& request = generated.request;
+            RideIndex ride;
+            switch (request.type) {
+                case RideType::Premium:
+                    ride = rides.create<PremiumRide>(static_cast<int>(request.requestID), request.pickupLocation,
+                                                     request.dropoffLocation, request.distance);
+                    break;
+                case RideType::Pooled:
+                    ride = rides.create<PooledRide>(static_cast<int>(request.requestID), request.pickupLocation,
+                                                    request.dropoffLocation, request.distance);
+                    break;
+                default:
+                    ride = rides.create<StandardRide>(static_cast<int>(request.requestID), request.pickupLocation,
+                                                      request.dropoffLocation, request.distance);
+                    break;
+            }
+            const double fare = batch.fareData()[a];
+            rides[ride].restoreFare(fare);
+            const std::int64_t matchedAt = std::max(generated.timestamp, windowEnd);
+            rides[ride].markRequested(generated.timestamp);
+            drivers.get(assignment.driverID).addRide(ride, matchedAt);
+            riders.get(request.riderID).requestRide(ride, generated.timestamp);
+            drivers.setAvailable(assignment.driverID, false);
+
+            const double tripHours = (assignment.distanceKm + request.distance * 1.609344) / options.speedKmh;
+            trips.push(Trip{ matchedAt + static_cast<std::int64_t>(tripHours * 3600.0), assignment.driverID,
+                             generated.dropoffPosition });
+            ++matched;
+            ++byType[static_cast<std::size_t>(request.type)];
+            revenue[static_cast<std::size_t>(request.type)] += fare;
+            ++hourlyMatched[((generated.timestamp - dayStart) / 3600 % 24 + 24) % 24];
+            waitSeconds.push_back(static_cast<double>(matchedAt - generated.timestamp));
+            requestMicros.push_back(std::chrono::duration<double, std::micro>(Clock::now() - windowStart).count());
+        }
+        const auto recorded = Clock::now();
+        dispatchMicros.push_back(std::chrono::duration<double, std::micro>(dispatched - windowStart).count());
+        priceMicros.push_back(std::chrono::duration<double, std::micro>(priced - dispatched).count());
+        recordMicros.push_back(std::chrono::duration<double, std::micro>(recorded - priced).count());
+
+        retry.clear();
+        for (const RideRequest& request : result.unassigned) {
+            const Waiting& entry = waiting[waitingIndex[request.requestID]];
+            if (windowEnd - entry.since >= options.maxWaitSeconds) {
+                ++abandoned;
+            } else {
+                retry.push_back(entry);
+            }
+        }
+        waiting.swap(retry);
+    }
+    const double runSeconds = std::chrono::duration<double>(Clock::now() - runStart).count();
+
+    std::cout << trace.riderCount << " riders, " << trace.drivers.size() << " drivers, "
+              << trace.requests.size() << " requests, " << options.workers << " dispatch workers, "
+              << options.windowSeconds << " s windows\n"
+              << std::fixed << std::setprecision(2) << "setup " << setupSeconds << " s, run " << runSeconds
+              << " s, " << std::setprecision(0) << trace.requests.size() / runSeconds << " requests/sec\n"
+              << matched << " matched, " << abandoned << " abandoned after " << options.maxWaitSeconds << " s\n";
+    for (std::size_t t = 0; t < rideTypeCount; ++t) {
+        std::cout << std::left << std::setw(14) << rideTypeLabel(static_cast<RideType>(t)) << std::right
+                  << std::setw(10) << byType[t] << "  $" << std::setprecision(2) << revenue[t] << '\n';
+    }
+    std::cout << std::left << std::setw(22) << "latency" << std::right << std::setw(11) << "p50"
+              << std::setw(11) << "p99" << std::setw(11) << "p99.9" << std::endl;
+    printPercentiles("dispatch per window", dispatchMicros, "us");
+    printPercentiles("pricing per window", priceMicros, "us");
+    printPercentiles("recording per window", recordMicros, "us");
+    printPercentiles("per request", requestMicros, "us");
+    printPercentiles("rider wait", waitSeconds, "s simulated");
+
+    std::cout << "hour  requests  matched" << std::endl;
+    for (int h = 0; h < 24; ++h) {
+        std::cout << std::setw(4) << h << std::setw(10) << hourlyRequests[h] << std::setw(8) << std::setprecision(1)
+                  << (hourlyRequests[h] ? 100.0 * hourlyMatched[h] / hourlyRequests[h] : 0.0) << '%' << std::endl;
+    }
+    return 0;
+}
@@ -0,0 +1,98 @@
+/**
+ * @brief Benchmark: streamed driver pings/sec with concurrent readers and index flushes
+ * Writer threads ping random drivers while a matcher thread reads snapshots and a
+ * flusher applies the coalesced changes to a DriverIndex every flushMs
+ * Built by the location_bench CMake target
+ * Usage: location_bench [drivers] [writers] [seconds] [flushMs]
+ */
+#include <iostream>
+#include <vector>
+#include <thread>
+#include <atomic>
+#include <chrono>
+#include <random>
+#include <iomanip>
+#include <cstdlib>
+
+#include "../driver_locations.h"
+
+int main(int argc, char** argv) {
+    const std::size_t drivers = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 100000;
+    const std::size_t writers = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 2;
+    const double seconds = argc > 3 ? std::strtod(argv[3], nullptr) : 2.0;
+    const long flushMs = argc > 4 ? std::strtol(argv[4], nullptr, 10) : 100;
+    if (drivers == 0 || writers == 0) {
+        std::cerr << "drivers and writers must be greater than 0" << std::endl;
+        return 1;
+    }
+
+    const GeoPoint center{ 40.7128, -74.0060 };
+    DriverLocationTable table(drivers);
+    DriverIndex index;
+    for (std::size_t i = 0; i < drivers; ++i) {
+        table.registerDriver(static_cast<int>(i + 1), 4.5, center);
+    }
+
+    std::atomic<bool> stop(false);
+    std::atomic<std::uint64_t> reads(0);
+    std::vector<std::thread> threads;
+    for (std::size_t w = 0; w < writers; ++w) {
+        threads.emplace_back([&, w]() {
+            std::mt19937 rng(static_cast<unsigned>(w + 1));
+            std::uniform_int_distribution<std::uint32_t> pick(0, static_cast<std::uint32_t>(drivers - 1));
+            std::uniform_real_distribution<double> jitter(-0.05, 0.05);
+            std::int64_t clock = 0;
+            while (!stop.load(std::memory_order_relaxed)) {
+                for (int i = 0; i < 256; ++i) {
+                    const GeoPoint position{ center.lat + jitter(rng), center.lon + jitter(rng) };
+                    table.update(pick(rng), position, true, ++clock);
+                }
+            }
+        });
+    }
+    threads.emplace_back([&]() {
+        std::mt19937 rng(99);
+        std::uniform_int_distribution<std::uint32_t> pick(0, static_cast<std::uint32_t>(drivers - 1));
+        double checksum = 0.0;
+        std::uint64_t count = 0;
+        while (!stop.load(std::memory_order_relaxed)) {
+            for (int i = 0; i < 256; ++i) {
+                checksum += table.read(pick(rng)).position.lat;
+            }
+            count += 256;
+        }
+        reads.store(count, std::memory_order_relaxed);
+        volatile double sink = checksum;
+        (void)sink;
+    });
+
+    std::size_t flushes = 0;
+    std::size_t applied = 0;
+    double flushSeconds = 0.0;
+    const auto start = std::chrono::steady_clock::now();
+    const auto deadline = start + std::chrono::duration<double>(seconds);
+    while (std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(flushMs));
+        const auto flushStart = std::chrono::steady_clock::now();
+        applied += table.flushTo(index);
+        flushSeconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - flushStart).count();
+        ++flushes;
+    }
+    stop.store(true, std::memory_order_relaxed);
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    const double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    applied += table.flushTo(index);
+
+    const std::uint64_t pings = table.pingCount();
+    std::cout << std::fixed << std::setprecision(0)
+              << "drivers " << drivers << ", writers " << writers << ", flush every " << flushMs << " ms\n"
+              << "pings/sec        " << pings / elapsed << '\n'
+              << "reads/sec        " << reads.load() / elapsed << '\n'
+              << std::setprecision(2)
+              << "pings per index update " << (applied ? static_cast<double>(pings) / applied : 0.0) << '\n'
+              << "ms per flush     " << (flushes ? flushSeconds * 1000.0 / flushes : 0.0) << '\n'
+              << "indexed drivers  " << index.size() << std::endl;
+    return 0;
+}
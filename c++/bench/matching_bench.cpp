@@ -0,0 +1,111 @@
+/**
+ * @brief Benchmark: batched matching vs. one-at-a-time greedy assignment
+ * The batch round runs three times on fresh fleets; the fastest is checked
+ * against the 200 ms budget. Exits nonzero over budget or on an inconsistent
+ * assignment
+ * Built by the matching_bench CMake target
+ * Usage: matching_bench [requestCount] [driverCount] [candidates]
+ */
+#include <iostream>
+#include <vector>
+#include <unordered_set>
+#include <algorithm>
+#include <chrono>
+#include <random>
+#include <iomanip>
+#include <cstdlib>
+
+#include "../batch_matcher.h"
+
+namespace {
+
+constexpr double roundBudgetMs = 200.0;
+constexpr int batchRepeats = 3;
+
+DriverIndex buildFleet(int driverCount) {
+    std::mt19937 rng(31);
+    std::uniform_real_distribution<double> offset(0.0, 0.30);
+    std::uniform_real_distribution<double> rating(3.0, 5.0);
+    DriverIndex index;
+    for (int id = 0; id < driverCount; ++id) {
+        index.updatePosition(id, rating(rng), GeoPoint{ 40.60 + offset(rng), -74.10 + offset(rng) });
+    }
+    return index;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const int requestCount = argc > 1 ? std::atoi(argv[1]) : 10000;
+    const int driverCount = argc > 2 ? std::atoi(argv[2]) : 10000;
+    MatchingWeights weights;
+    weights.candidates = argc > 3 ? std::strtoul(argv[3], nullptr, 10) : weights.candidates;
+
+    std::mt19937 rng(37);
+    std::uniform_real_distribution<double> offset(0.0, 0.30);
+    std::vector<RideRequest> requests(requestCount);
+    for (int i = 0; i < requestCount; ++i) {
+        requests[i] = RideRequest{};
+        requests[i].requestID = static_cast<std::uint64_t>(i);
+        requests[i].riderID = i;
+        requests[i].pickupPosition = GeoPoint{ 40.60 + offset(rng), -74.10 + offset(rng) };
+        requests[i].distance = 3.0;
+    }
+
+    // Greedy: each request takes its cheapest still-available candidate, in arrival order
+    DriverIndex greedyFleet = buildFleet(driverCount);
+    BatchMatcher costModel(weights);
+    auto start = std::chrono::steady_clock::now();
+    std::size_t greedyMatched = 0;
+    double greedyCost = 0.0;
+    for (const RideRequest& request : requests) {
+        BatchMatcher single(weights);
+        single.submit(request);
+        const DispatchResult one = single.match(greedyFleet);
+        greedyMatched += one.assignments.size();
+        greedyCost += single.lastStats().totalCost;
+    }
+    const double greedyMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+    BatchMatcher matcher(weights);
+    DispatchResult batch;
+    double batchMs = 0.0;
+    for (int repeat = 0; repeat < batchRepeats; ++repeat) {
+        DriverIndex batchFleet = buildFleet(driverCount);
+        for (const RideRequest& request : requests) {
+            matcher.submit(request);
+        }
+        start = std::chrono::steady_clock::now();
+        batch = matcher.match(batchFleet);
+        const double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        batchMs = repeat == 0 ? ms : std::min(batchMs, ms);
+    }
+    const BatchMatchStats& stats = matcher.lastStats();
+
+    std::unordered_set<int> used;
+    bool consistent = batch.assignments.size() + batch.unassigned.size() == requests.size();
+    for (const Assignment& assignment : batch.assignments) {
+        consistent = used.insert(assignment.driverID).second && consistent;
+    }
+
+    std::cout << std::fixed << std::setprecision(2)
+              << requestCount << " requests x " << driverCount << " drivers, " << stats.edges << " candidate edges\n"
+              << std::setw(8) << "mode" << std::setw(12) << "round ms" << std::setw(10) << "matched"
+              << std::setw(14) << "avg cost" << std::endl
+              << std::setw(8) << "greedy" << std::setw(12) << greedyMs << std::setw(10) << greedyMatched
+              << std::setw(14) << (greedyMatched ? greedyCost / static_cast<double>(greedyMatched) : 0.0) << std::endl
+              << std::setw(8) << "batch" << std::setw(12) << batchMs << std::setw(10) << batch.assignments.size()
+              << std::setw(14) << (batch.assignments.empty() ? 0.0 : stats.totalCost / static_cast<double>(batch.assignments.size()))
+              << std::endl
+              << "solver: " << stats.solver.augmentations << " augmentations, " << stats.solver.scannedColumns
+              << " columns scanned" << std::endl;
+
+    if (!consistent) {
+        std::cerr << "A driver was assigned twice or a request was lost" << std::endl;
+        return 1;
+    }
+    const bool withinBudget = batchMs <= roundBudgetMs;
+    std::cout << (withinBudget ? "PASS" : "FAIL") << ": batch round " << batchMs << " ms, budget "
+              << roundBudgetMs << " ms" << std::endl;
+    return withinBudget ? 0 : 1;
+}
@@ -0,0 +1,109 @@
+/**
+ * @brief Benchmark: per-event cost of the metrics counters and timers
+ * Checks the counter and the sampled per-ride timer against the 20ns-per-event
+ * budget and the merged totals for consistency; exits nonzero on either failure
+ * Built by the metrics_bench CMake target, always with RIDE_SHARING_METRICS=1
+ * Usage: metrics_bench [events] [threads]
+ */
+#include <iostream>
+#include <vector>
+#include <thread>
+#include <chrono>
+#include <iomanip>
+#include <cstdlib>
+
+#include "../metrics.h"
+#include "../ride_registry.h"
+#include "../driver.h"
+
+namespace {
+
+constexpr double eventBudgetNs = 20.0;
+
+template <typename Fn>
+double nsPerEvent(std::size_t events, Fn&& fn) {
+    const auto start = std::chrono::steady_clock::now();
+    for (std::size_t i = 0; i < events; ++i) {
+        fn(i);
+    }
+    const auto elapsed = std::chrono::steady_clock::now() - start;
+    return std::chrono::duration<double, std::nano>(elapsed).count() / static_cast<double>(events);
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const std::size_t events = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 10000000;
+    const std::size_t threads = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 4;
+
+    // Touch the slab once so its allocation is not counted
+    RIDE_METRICS_COUNT(RidesCreated, 0);
+
+    volatile double sink = 0.0;
+    const double baseline = nsPerEvent(events, [&](std::size_t i) { sink = sink + static_cast<double>(i); });
+    const double clockRead = nsPerEvent(events, [&](std::size_t) { sink = sink + static_cast<double>(metrics::ticks()); });
+    const double counter = nsPerEvent(events, [&](std::size_t i) {
+        RIDE_METRICS_COUNT(FaresCalculated, 1);
+        sink = sink + static_cast<double>(i);
+    });
+    const double timer = nsPerEvent(events, [&](std::size_t i) {
+        RIDE_METRICS_TIME(FareCalculation);
+        sink = sink + static_cast<double>(i);
+    });
+    const double everyEventTimer = nsPerEvent(events, [&](std::size_t i) {
+        RIDE_METRICS_TIME(DriverMatch);
+        sink = sink + static_cast<double>(i);
+    });
+
+    RideRegistry registry;
+    const LocationID pickup = LocationTable::global().intern("Union Square");
+    const LocationID dropoff = LocationTable::global().intern("Pier 39");
+    const RideIndex ride = registry.create<StandardRide>(1, pickup, dropoff, 3.5);
+    Driver driver(1, "Bench", 4.8, registry);
+    driver.reserveRides(events);
+    const double addRide = nsPerEvent(events, [&](std::size_t) { driver.addRide(ride, 0); });
+
+    std::cout << std::fixed << std::setprecision(2)
+              << "loop baseline:        " << baseline << " ns/event\n"
+              << "clock read:           " << clockRead - baseline << " ns (a timer takes two)\n"
+              << "counter increment:    " << counter - baseline << " ns/event\n"
+              << "scoped timer:         " << timer - baseline << " ns/event (1 in "
+              << metrics::sampleEvery(metrics::Histogram::FareCalculation) << " timed)\n"
+              << "unsampled timer:      " << everyEventTimer - baseline << " ns/event (matching and dispatch)\n"
+              << "Driver::addRide:      " << addRide << " ns/call (instrumented)\n";
+
+    // Concurrent writers never share a cache line, so the per-event cost should hold
+    std::vector<std::thread> workers;
+    const auto start = std::chrono::steady_clock::now();
+    for (std::size_t t = 0; t < threads; ++t) {
+        workers.emplace_back([events]() {
+            for (std::size_t i = 0; i < events; ++i) {
+                RIDE_METRICS_TIME(DispatchRound);
+                RIDE_METRICS_COUNT(DispatchAssignments, 1);
+            }
+        });
+    }
+    for (auto& worker : workers) {
+        worker.join();
+    }
+    const double concurrent = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count()
+        / static_cast<double>(events);
+    std::cout << threads << " threads, timer+count: " << concurrent << " ns/event/thread\n";
+
+    const metrics::MetricsSnapshot snapshot = metrics::Registry::global().scrape();
+    const metrics::HistogramSnapshot& rounds = snapshot.histogram(metrics::Histogram::DispatchRound);
+    const bool consistent = snapshot.counter(metrics::Counter::DispatchAssignments) == threads * events
+        && rounds.count == threads * events;
+    std::cout << std::setprecision(1)
+              << "dispatch histogram p50/p99: " << rounds.quantileSeconds(0.50) * 1e9 << " / "
+              << rounds.quantileSeconds(0.99) * 1e9 << " ns\n"
+              << "merged totals: " << (consistent ? "consistent" : "MISMATCH") << "\n\n";
+
+    const std::string text = metrics::Registry::global().prometheus();
+    std::cout << "Prometheus scrape: " << text.size() << " bytes\n"
+              << text.substr(0, text.find("# TYPE ride_sharing_ride_construction_seconds")) << std::endl;
+    const bool withinBudget = counter - baseline < eventBudgetNs && timer - baseline < eventBudgetNs;
+    std::cout << (withinBudget ? "PASS" : "FAIL") << ": counter " << std::setprecision(2) << counter - baseline
+              << " ns, per-ride timer " << timer - baseline << " ns, budget " << eventBudgetNs << " ns" << std::endl;
+    return consistent && withinBudget ? 0 : 1;
+}
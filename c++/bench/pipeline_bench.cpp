@@ -0,0 +1,163 @@
+/**
+ * @brief Benchmark: coroutine request pipeline vs. one thread per request
+ * Every request waits lookupMs on a distance lookup and offerMs on a driver
+ * reply; the pipeline runs them all on a small EventLoop, the baseline gives
+ * each request its own blocking thread
+ * Built by the pipeline_bench CMake target (C++20)
+ * Usage: pipeline_bench [requests] [loopThreads] [lookupMs] [offerMs] [baselineRequests]
+ */
+#include <iostream>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <chrono>
+#include <random>
+#include <iomanip>
+#include <cstdlib>
+
+#include "../request_pipeline.h"
+#include "../location_table.h"
+
+namespace {
+
+struct World {
+    RideRegistry rides;
+    DriverIndex index;
+    DriverRegistry drivers;
+    RiderRegistry riders;
+    std::vector<RideRequest> requests;
+
+    explicit World(std::size_t count) : drivers(rides, count), riders(rides, count) {
+        std::mt19937 rng(7);
+        std::uniform_real_distribution<double> offset(-0.05, 0.05);
+        std::uniform_real_distribution<double> miles(1.0, 15.0);
+        const GeoPoint center{ 40.7128, -74.0060 };
+        LocationTable& names = LocationTable::global();
+        const LocationID pickup = names.intern("Midtown");
+        const LocationID dropoff = names.intern("Downtown");
+        rides.reserve<StandardRide>(count);
+        // One driver per request so every request can be matched
+        for (std::size_t i = 0; i < count; ++i) {
+            const int id = static_cast<int>(i + 1);
+            const GeoPoint position{ center.lat + offset(rng), center.lon + offset(rng) };
+            drivers.add(id, "Driver", 4.5, position);
+            index.updatePosition(id, 4.5, position);
+            riders.add(id, "Rider");
+            RideRequest request{};
+            request.requestID = i + 1;
+            request.riderID = id;
+            request.pickupLocation = pickup;
+            request.dropoffLocation = dropoff;
+            request.type = RideType::Standard;
+            request.pickupPosition = GeoPoint{ center.lat + offset(rng), center.lon + offset(rng) };
+            request.distance = miles(rng);
+            requests.push_back(request);
+        }
+    }
+};
+
+void runPipeline(std::size_t count, std::size_t threads, long lookupMs, long offerMs) {
+    World world(count);
+    EventLoop loop(threads);
+    PipelineServices services;
+    services.lookupDistance = [&loop, lookupMs](const RideRequest& request, Completion<double> done) {
+        const double miles = request.distance;
+        loop.after(std::chrono::milliseconds(lookupMs), [done, miles]() { done.complete(miles); });
+    };
+    services.offerRide = [&loop, offerMs](const RideRequest&, int, Completion<bool> done) {
+        loop.after(std::chrono::milliseconds(offerMs), [done]() { done.complete(true); });
+    };
+    RequestPipeline pipeline(loop, world.rides, world.index, world.drivers, world.riders, services);
+
+    const auto start = std::chrono::steady_clock::now();
+    for (const RideRequest& request : world.requests) {
+        pipeline.submit(request);
+    }
+    loop.waitIdle();
+    const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    const PipelineStats stats = pipeline.stats();
+    std::cout << std::left << std::setw(22) << "coroutine pipeline" << std::right
+              << std::setw(10) << count << std::setw(10) << threads
+              << std::setw(12) << std::fixed << std::setprecision(0) << count / seconds
+              << std::setw(12) << stats.peakInFlight
+              << std::setw(12) << stats.confirmed << std::endl;
+}
+
+void runThreadPerRequest(std::size_t count, long lookupMs, long offerMs) {
+    World world(count);
+    std::mutex state;
+    std::atomic<std::uint64_t> confirmed(0);
+    std::atomic<std::uint64_t> running(0);
+    std::atomic<std::uint64_t> peak(0);
+
+    const auto start = std::chrono::steady_clock::now();
+    std::vector<std::thread> threads;
+    threads.reserve(count);
+    for (const RideRequest& request : world.requests) {
+        threads.emplace_back([&, request]() {
+            const std::uint64_t now = running.fetch_add(1) + 1;
+            std::uint64_t seen = peak.load();
+            while (now > seen && !peak.compare_exchange_weak(seen, now)) {
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(lookupMs));
+            RideIndex ride;
+            int driverID = -1;
+            {
+                std::lock_guard<std::mutex> lock(state);
+                ride = world.rides.create<StandardRide>(static_cast<int>(request.requestID), request.pickupLocation,
+                                                        request.dropoffLocation, request.distance);
+                world.rides[ride].calculateFare();
+                const std::vector<DriverMatch> matches = world.index.nearestAvailable(request.pickupPosition, 1, 10.0);
+                if (!matches.empty()) {
+                    driverID = matches.front().driverID;
+                    world.index.setAvailable(driverID, false);
+                }
+            }
+            if (driverID >= 0) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(offerMs));
+                std::lock_guard<std::mutex> lock(state);
+                world.drivers.get(driverID).addRide(ride);
+                world.riders.get(request.riderID).requestRide(ride);
+                confirmed.fetch_add(1);
+            }
+            running.fetch_sub(1);
+        });
+    }
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+    const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    std::cout << std::left << std::setw(22) << "thread per request" << std::right
+              << std::setw(10) << count << std::setw(10) << count
+              << std::setw(12) << std::fixed << std::setprecision(0) << count / seconds
+              << std::setw(12) << peak.load()
+              << std::setw(12) << confirmed.load() << std::endl;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const std::size_t requests = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 20000;
+    const std::size_t hardware = std::thread::hardware_concurrency() ? std::thread::hardware_concurrency() : 1;
+    const std::size_t threads = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : hardware;
+    const long lookupMs = argc > 3 ? std::strtol(argv[3], nullptr, 10) : 5;
+    const long offerMs = argc > 4 ? std::strtol(argv[4], nullptr, 10) : 200;
+    const std::size_t baseline = argc > 5 ? std::strtoul(argv[5], nullptr, 10) : 2000;
+    if (requests == 0 || threads == 0) {
+        std::cerr << "requests and loopThreads must be greater than 0" << std::endl;
+        return 1;
+    }
+
+    std::cout << "lookup " << lookupMs << " ms, driver reply " << offerMs << " ms\n"
+              << std::left << std::setw(22) << "mode" << std::right << std::setw(10) << "requests"
+              << std::setw(10) << "threads" << std::setw(12) << "req/sec"
+              << std::setw(12) << "peak open" << std::setw(12) << "confirmed" << std::endl;
+    runPipeline(requests, threads, lookupMs, offerMs);
+    if (baseline > 0) {
+        runThreadPerRequest(baseline, lookupMs, offerMs);
+    }
+    return 0;
+}
@@ -0,0 +1,78 @@
+/**
+ * @brief Benchmark: DurableRegistry recovery time (snapshot load + log replay)
+ * Built by the recovery_bench CMake target
+ * Usage: recovery_bench [rideCount] [commitBatch] [directory]
+ */
+#include <iostream>
+#include <string>
+#include <chrono>
+#include <iomanip>
+#include <filesystem>
+#include <cstdlib>
+
+#include "../durable_registry.h"
+
+int main(int argc, char** argv) {
+    const std::uint64_t rideCount = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 50000000;
+    const std::uint64_t commitBatch = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 4096;
+    const std::string directory = argc > 3 ? argv[3] : "recovery_bench_data";
+    const std::uint64_t tailRides = rideCount / 10;   // rides left in the log after the last snapshot
+    const int people = 1000;
+
+    std::filesystem::remove_all(directory);
+    std::uint64_t syncs = 0;
+    double writeSeconds = 0.0;
+    {
+        DurableRegistry durable(directory);
+        LocationTable& table = LocationTable::global();
+        LocationID zones[64];
+        for (int i = 0; i < 64; ++i) {
+            zones[i] = table.intern("Zone " + std::to_string(i));
+        }
+        for (int id = 0; id < people; ++id) {
+            durable.addDriver(id, "Driver " + std::to_string(id), 3.0 + (id % 20) * 0.1);
+            durable.addRider(id, "Rider " + std::to_string(id));
+        }
+
+        auto start = std::chrono::steady_clock::now();
+        for (std::uint64_t i = 0; i < rideCount; ++i) {
+            const RideType type = (i % 4 == 0) ? RideType::Premium : RideType::Standard;
+            const RideIndex ride = durable.createRide(type, static_cast<int>(i), zones[i % 64],
+                                                      zones[(i * 7 + 3) % 64], 1.0 + static_cast<double>(i % 40));
+            durable.assignRide(static_cast<int>(i % people), ride);
+            durable.requestRide(static_cast<int>((i * 13) % people), ride);
+            if ((i + 1) % commitBatch == 0) {
+                durable.commit();
+            }
+            if (i + 1 == rideCount - tailRides) {
+                syncs += durable.getLog().syncs();
+                durable.snapshot();
+            }
+        }
+        durable.commit();
+        syncs += durable.getLog().syncs();
+        writeSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    DurableRegistry recovered(directory);
+    const double recoverSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    const DurableRegistry::RecoveryStats& stats = recovered.getRecoveryStats();
+
+    std::cout << std::fixed << std::setprecision(3)
+              << "rides written:      " << rideCount << " in " << writeSeconds << " s ("
+              << syncs << " fsyncs, batch " << commitBatch << ")" << std::endl
+              << "snapshot rides:     " << stats.snapshotRides << std::endl
+              << "replayed entries:   " << stats.replayedEntries << std::endl
+              << "recovery time:      " << recoverSeconds << " s ("
+              << std::setprecision(1) << recovered.getRides().size() / recoverSeconds / 1e6
+              << " M rides/s)" << std::endl;
+
+    const bool complete = recovered.getRides().size() == rideCount;
+    std::filesystem::remove_all(directory);
+    if (!complete) {
+        std::cerr << "Recovered " << recovered.getRides().size() << " rides, expected " << rideCount << std::endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,90 @@
+/**
+ * @brief Benchmark: RequestQueue throughput (requests/sec) vs. thread count
+ * Runs N producers and N matchers for each N in 1, 2, 4, ... up to maxThreads
+ * Built by the request_queue_bench CMake target
+ * Usage: request_queue_bench [maxThreads] [requestsPerProducer] [batchSize]
+ */
+#include <iostream>
+#include <vector>
+#include <thread>
+#include <atomic>
+#include <chrono>
+#include <iomanip>
+#include <cstdlib>
+
+#include "../request_queue.h"
+
+namespace {
+
+void runRound(std::size_t threads, std::size_t perProducer, std::size_t batchSize) {
+    RequestQueue queue(threads, 4096);
+    const std::uint64_t total = static_cast<std::uint64_t>(threads) * perProducer;
+    std::atomic<std::uint64_t> consumed(0);
+    std::atomic<bool> go(false);
+
+    std::vector<std::thread> workers;
+    for (std::size_t p = 0; p < threads; ++p) {
+        workers.emplace_back([&, p]() {
+            while (!go.load(std::memory_order_acquire)) {
+                std::this_thread::yield();
+            }
+            RideRequest request{};
+            request.riderID = static_cast<int>(p);
+            request.distance = 1.0;
+            for (std::size_t i = 0; i < perProducer; ++i) {
+                request.requestID = i;
+                while (!queue.tryPush(request)) {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+    for (std::size_t c = 0; c < threads; ++c) {
+        workers.emplace_back([&, c]() {
+            std::vector<RideRequest> batch;
+            batch.reserve(batchSize);
+            while (!go.load(std::memory_order_acquire)) {
+                std::this_thread::yield();
+            }
+            while (consumed.load(std::memory_order_relaxed) < total) {
+                batch.clear();
+                const std::size_t n = queue.drainBatch(batch, batchSize, c);
+                if (n == 0) {
+                    std::this_thread::yield();
+                    continue;
+                }
+                consumed.fetch_add(n, std::memory_order_relaxed);
+            }
+        });
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    go.store(true, std::memory_order_release);
+    for (auto& worker : workers) {
+        worker.join();
+    }
+    auto stop = std::chrono::steady_clock::now();
+
+    const double seconds = std::chrono::duration<double>(stop - start).count();
+    const RequestQueueStats stats = queue.stats();
+    std::cout << std::setw(8) << threads
+              << std::setw(16) << std::fixed << std::setprecision(0) << total / seconds
+              << std::setw(12) << stats.spilled
+              << std::setw(12) << stats.rejected << std::endl;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const std::size_t hardware = std::thread::hardware_concurrency() ? std::thread::hardware_concurrency() : 1;
+    const std::size_t maxThreads = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : hardware;
+    const std::size_t perProducer = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 1000000;
+    const std::size_t batchSize = argc > 3 ? std::strtoul(argv[3], nullptr, 10) : 64;
+
+    std::cout << std::setw(8) << "threads" << std::setw(16) << "requests/sec"
+              << std::setw(12) << "spilled" << std::setw(12) << "rejected" << std::endl;
+    for (std::size_t threads = 1; threads <= maxThreads; threads *= 2) {
+        runRound(threads, perProducer, batchSize);
+    }
+    return 0;
+}
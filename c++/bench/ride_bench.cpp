@@ -0,0 +1,854 @@
+/**
+ * @brief Google Benchmark suite for the ride-sharing core
+ * Run with --benchmark_format=json (or the ride_bench_json target) to get
+ * machine-readable results for comparing releases
+ */
+#include <benchmark/benchmark.h>
+
+#include <iostream>
+#include <sstream>
+#include <streambuf>
+#include <vector>
+#include <algorithm>
+#include <memory>
+#include <random>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+#include <string_view>
+#include <cmath>
+#include <atomic>
+#include <thread>
+#include <unordered_map>
+
+#include "../ride.h"
+#include "../ride_pool.h"
+#include "../ride_registry.h"
+#include "../ride_batch.h"
+#include "../fare_kernel.h"
+#include "../ride_value.h"
+#include "../driver.h"
+#include "../rider.h"
+#include "../driver_index.h"
+#include "../request_queue.h"
+#include "../dispatcher.h"
+#include "../ride_writer.h"
+#include "../ride_binary.h"
+#include "../ride_history_store.h"
+#include "../surge_pricing.h"
+#include "../quote_cache.h"
+#include "../distance_provider.h"
+#include "../ride_ingest.h"
+#include "../participant_registry.h"
+#include "../ride_timeline.h"
+#include "../pool_route.h"
+
+// Counts every global operator new, so benchmarks can report allocations per item
+static std::atomic<std::uint64_t> allocationCount{0};
+
+[[gnu::noinline]] void* operator new(std::size_t size) {
+    allocationCount.fetch_add(1, std::memory_order_relaxed);
+    if (void* memory = std::malloc(size == 0 ? 1 : size)) {
+        return memory;
+    }
+    throw std::bad_alloc();
+}
+
+// Kept out of line, like operator new, so GCC does not pair an inlined malloc()/free()
+// with a new/delete-expression and warn about mismatched allocation functions
+[[gnu::noinline]] void operator delete(void* memory) noexcept { std::free(memory); }
+[[gnu::noinline]] void operator delete(void* memory, std::size_t) noexcept { std::free(memory); }
+
+namespace {
+
+// Discards everything written to it, so formatting cost is measured without terminal I/O
+class NullBuffer : public std::streambuf {
+protected:
+    int overflow(int c) override { return traits_type::not_eof(c); }
+    std::streamsize xsputn(const char*, std::streamsize n) override { return n; }
+};
+
+class CoutSilencer {
+private:
+    NullBuffer sink;
+    std::streambuf* previous;
+
+public:
+    CoutSilencer() : previous(std::cout.rdbuf(&sink)) {}
+    ~CoutSilencer() { std::cout.rdbuf(previous); }
+};
+
+GeoPoint randomPoint(std::mt19937& rng) {
+    std::uniform_real_distribution<double> offset(0.0, 0.30);
+    return GeoPoint{ 40.60 + offset(rng), -74.10 + offset(rng) };
+}
+
+// --- Ride construction ---
+
+template <typename T>
+void BM_ConstructRide(benchmark::State& state) {
+    int id = 0;
+    for (auto _ : state) {
+        T ride(id++, "Home", "Work", 5.0);
+        benchmark::DoNotOptimize(ride);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK_TEMPLATE(BM_ConstructRide, StandardRide);
+BENCHMARK_TEMPLATE(BM_ConstructRide, PremiumRide);
+
+void BM_MakeSharedRide(benchmark::State& state) {
+    int id = 0;
+    for (auto _ : state) {
+        auto ride = std::make_shared<StandardRide>(id++, "Home", "Work", 5.0);
+        benchmark::DoNotOptimize(ride);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_MakeSharedRide);
+
+void BM_PoolCreateRide(benchmark::State& state) {
+    RidePool pool;
+    const LocationID home = LocationTable::global().intern("Home");
+    const LocationID work = LocationTable::global().intern("Work");
+    int id = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(pool.create<StandardRide>(id++, home, work, 5.0));
+        if (id % 65536 == 0) {
+            state.PauseTiming();
+            pool.releaseEpoch(pool.getCurrentEpoch());
+            state.ResumeTiming();
+        }
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_PoolCreateRide);
+
+// --- Fare calculation ---
+
+template <typename T>
+void BM_VirtualCalculateFare(benchmark::State& state) {
+    const std::size_t count = static_cast<std::size_t>(state.range(0));
+    std::vector<std::unique_ptr<Ride> > rides;
+    for (std::size_t i = 0; i < count; ++i) {
+        rides.push_back(std::make_unique<T>(static_cast<int>(i), "A", "B", 1.0 + i % 40));
+    }
+    for (auto _ : state) {
+        for (const auto& ride : rides) {
+            ride->calculateFare();
+        }
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * count);
+}
+BENCHMARK_TEMPLATE(BM_VirtualCalculateFare, StandardRide)->Arg(1 << 16);
+BENCHMARK_TEMPLATE(BM_VirtualCalculateFare, PremiumRide)->Arg(1 << 16);
+
+void BM_ValueCalculateFare(benchmark::State& state) {
+    const std::size_t count = static_cast<std::size_t>(state.range(0));
+    std::vector<RideValue> rides;
+    for (std::size_t i = 0; i < count; ++i) {
+        if (i % 3 == 0) {
+            rides.push_back(PremiumRideValue(static_cast<int>(i), "A", "B", 1.0 + i % 40));
+        } else {
+            rides.push_back(StandardRideValue(static_cast<int>(i), "A", "B", 1.0 + i % 40));
+        }
+    }
+    for (auto _ : state) {
+        calculateFares(rides);
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * count);
+}
+BENCHMARK(BM_ValueCalculateFare)->Arg(1 << 16);
+
+void BM_BatchCalculateFare(benchmark::State& state) {
+    const FareKernel kernel = static_cast<FareKernel>(state.range(0));
+    if (!isFareKernelSupported(kernel)) {
+        state.SkipWithError("Fare kernel not supported on this CPU");
+        return;
+    }
+    state.SetLabel(fareKernelName(kernel));
+    const std::size_t count = static_cast<std::size_t>(state.range(1));
+    RideBatch batch;
+    batch.reserve(count);
+    for (std::size_t i = 0; i < count; ++i) {
+        batch.addRide(static_cast<int>(i), 1.0 + i % 40, i % 3 == 0 ? RideType::Premium : RideType::Standard);
+    }
+    for (auto _ : state) {
+        calculateFares(batch, kernel);
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * count);
+}
+BENCHMARK(BM_BatchCalculateFare)
+#if defined(RIDE_SHARING_X86)
+    ->ArgsProduct({ { static_cast<int>(FareKernel::Scalar), static_cast<int>(FareKernel::Avx2),
+                      static_cast<int>(FareKernel::Avx512) },
+                    { 1 << 16 } });
+#elif defined(RIDE_SHARING_NEON)
+    ->ArgsProduct({ { static_cast<int>(FareKernel::Scalar), static_cast<int>(FareKernel::Neon) }, { 1 << 16 } });
+#else
+    ->ArgsProduct({ { static_cast<int>(FareKernel::Scalar) }, { 1 << 16 } });
+#endif
+
+// --- Surge pricing ---
+
+void BM_SurgeQuote(benchmark::State& state) {
+    SurgePricing surge(1024);
+    const std::int64_t now = currentTimestamp();
+    for (ZoneID zone = 0; zone < 1024; ++zone) {
+        surge.update(zone, zone % 40, 10, now);
+    }
+    ZoneID zone = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(surge.quote(zone, now));
+        zone = (zone + 1) & 1023;
+    }
+}
+BENCHMARK(BM_SurgeQuote);
+
+// Quotes while another thread keeps refreshing the same zones
+void BM_SurgeQuoteUnderUpdates(benchmark::State& state) {
+    SurgePricing surge(64);
+    const std::int64_t now = currentTimestamp();
+    std::atomic<bool> stop{false};
+    std::thread writer([&] {
+        std::uint32_t demand = 0;
+        while (!stop.load(std::memory_order_relaxed)) {
+            surge.update(demand & 63, demand % 50, 10, now);
+            ++demand;
+            std::this_thread::yield();
+        }
+    });
+    ZoneID zone = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(surge.quote(zone, now));
+        zone = (zone + 1) & 63;
+    }
+    stop.store(true);
+    writer.join();
+}
+BENCHMARK(BM_SurgeQuoteUnderUpdates);
+
+// Skewed pickup/dropoff pairs against a cache smaller than the key space
+void BM_FareQuoterCached(benchmark::State& state) {
+    static SurgePricing surge(1024);
+    static QuoteCache cache(static_cast<std::size_t>(state.range(0)));
+    FareQuoter quoter(surge, cache, [](LocationID pickup, LocationID dropoff) {
+        const double dLat = static_cast<double>(pickup % 32) - static_cast<double>(dropoff % 32);
+        const double dLon = static_cast<double>(pickup / 32) - static_cast<double>(dropoff / 32);
+        return 0.5 + std::sqrt(dLat * dLat + dLon * dLon);
+    });
+    std::mt19937 rng(static_cast<unsigned>(state.thread_index()) + 1);
+    std::geometric_distribution<LocationID> popular(0.1);
+    const std::int64_t now = currentTimestamp();
+    for (auto _ : state) {
+        const LocationID pickup = popular(rng) % 1024;
+        const LocationID dropoff = popular(rng) % 1024;
+        benchmark::DoNotOptimize(quoter.quote(pickup, dropoff, RideType::Standard, now));
+    }
+    if (state.thread_index() == 0) {
+        const QuoteCacheStats stats = cache.stats();
+        state.counters["hit_rate"] = stats.hitRate();
+        state.counters["evictions"] = static_cast<double>(stats.evictions);
+    }
+}
+BENCHMARK(BM_FareQuoterCached)->Arg(4096)->Threads(1)->Threads(4);
+
+// --- Road distances ---
+
+// Contracted width x width grid with randomly weighted roads, built once per process
+struct GridRoads {
+    RoadGraph graph;
+    std::vector<LocationID> nodes;
+
+    explicit GridRoads(int width) {
+        std::mt19937 rng(5);
+        std::uniform_real_distribution<double> length(0.1, 1.0);
+        for (int i = 0; i < width * width; ++i) {
+            nodes.push_back(LocationTable::global().intern("Grid " + std::to_string(i)));
+        }
+        for (int y = 0; y < width; ++y) {
+            for (int x = 0; x < width; ++x) {
+                const int node = y * width + x;
+                if (x + 1 < width) {
+                    graph.addRoad(nodes[node], nodes[node + 1], length(rng));
+                }
+                if (y + 1 < width) {
+                    graph.addRoad(nodes[node], nodes[node + width], length(rng));
+                }
+            }
+        }
+        graph.contract();
+    }
+
+    static const GridRoads& instance() {
+        static const GridRoads roads(64);
+        return roads;
+    }
+};
+
+void BM_RoadGraphQuery(benchmark::State& state) {
+    const GridRoads& roads = GridRoads::instance();
+    std::mt19937 rng(9);
+    std::uniform_int_distribution<std::size_t> pick(0, roads.nodes.size() - 1);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(roads.graph.distance(roads.nodes[pick(rng)], roads.nodes[pick(rng)]));
+    }
+}
+BENCHMARK(BM_RoadGraphQuery);
+
+// Drivers x pickups scoring table, road graph buckets vs. precomputed matrix
+void BM_ManyToMany(benchmark::State& state) {
+    const GridRoads& roads = GridRoads::instance();
+    const std::size_t side = static_cast<std::size_t>(state.range(1));
+    std::vector<LocationID> drivers(roads.nodes.begin(), roads.nodes.begin() + side);
+    std::vector<LocationID> pickups(roads.nodes.end() - side, roads.nodes.end());
+    std::vector<LocationID> hot(drivers);
+    hot.insert(hot.end(), pickups.begin(), pickups.end());
+    const DistanceMatrix matrix(hot, roads.graph);
+    const DistanceProvider& provider = state.range(0) == 0
+        ? static_cast<const DistanceProvider&>(roads.graph) : matrix;
+    std::vector<double> table;
+    for (auto _ : state) {
+        provider.distances(drivers, pickups, table);
+        benchmark::DoNotOptimize(table.data());
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(side * side));
+    state.SetLabel(state.range(0) == 0 ? "graph" : "matrix");
+}
+BENCHMARK(BM_ManyToMany)->ArgsProduct({ { 0, 1 }, { 64 } });
+
+// --- Ingestion with bad rows ---
+
+// range(0) bad rows per 100; negative distances, as in a dirty feed
+std::vector<RawRideRecord> makeFeed(std::size_t rows, int badPerHundred) {
+    const LocationID home = LocationTable::global().intern("Home");
+    const LocationID work = LocationTable::global().intern("Work");
+    std::vector<RawRideRecord> feed(rows);
+    for (std::size_t i = 0; i < rows; ++i) {
+        const bool bad = static_cast<int>((i * 37) % 100) < badPerHundred;
+        feed[i] = RawRideRecord{ static_cast<int>(i), home, work,
+                                 i % 2 ? RideType::Premium : RideType::Standard, bad ? -1.0 : 5.0 };
+    }
+    return feed;
+}
+
+void BM_IngestThrowing(benchmark::State& state) {
+    const std::vector<RawRideRecord> feed = makeFeed(1 << 14, static_cast<int>(state.range(0)));
+    for (auto _ : state) {
+        RideRegistry registry;
+        std::size_t rejected = 0;
+        for (const RawRideRecord& row : feed) {
+            try {
+                if (row.type == RideType::Premium) {
+                    registry.create<PremiumRide>(row.rideID, row.pickup, row.dropoff, row.distance);
+                } else {
+                    registry.create<StandardRide>(row.rideID, row.pickup, row.dropoff, row.distance);
+                }
+            } catch (const std::invalid_argument&) {
+                ++rejected;
+            }
+        }
+        benchmark::DoNotOptimize(rejected);
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(feed.size()));
+}
+BENCHMARK(BM_IngestThrowing)->Arg(0)->Arg(3);
+
+void BM_IngestValidated(benchmark::State& state) {
+    const std::vector<RawRideRecord> feed = makeFeed(1 << 14, static_cast<int>(state.range(0)));
+    for (auto _ : state) {
+        RideRegistry registry;
+        benchmark::DoNotOptimize(ingestRides(registry, feed));
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(feed.size()));
+}
+BENCHMARK(BM_IngestValidated)->Arg(0)->Arg(3);
+
+// --- Construction from network buffers ---
+
+// Pickup/dropoff names longer than the small-string buffer, sliced out of one wire buffer
+const std::string& wireBuffer() {
+    static const std::string buffer = "Terminal 4 Departures Level|Convention Center North Entrance";
+    return buffer;
+}
+
+// range(0) == 0: copies each field into a std::string first; 1: string_view + emplaceRide
+void BM_EmplaceFromBuffer(benchmark::State& state) {
+    const std::string_view wire = wireBuffer();
+    const std::string_view pickup = wire.substr(0, wire.find('|'));
+    const std::string_view dropoff = wire.substr(wire.find('|') + 1);
+    const bool inPlace = state.range(0) == 1;
+    constexpr int ridesPerRound = 1024;
+    std::uint64_t allocations = 0;
+    for (auto _ : state) {
+        state.PauseTiming();
+        RideRegistry registry;
+        Driver driver(101, "John Doe", 4.8, registry);
+        driver.reserveRides(ridesPerRound);
+        LocationTable::global().intern(pickup);
+        LocationTable::global().intern(dropoff);
+        registry.reserve<StandardRide>(ridesPerRound);
+        const std::uint64_t before = allocationCount.load(std::memory_order_relaxed);
+        state.ResumeTiming();
+        for (int i = 0; i < ridesPerRound; ++i) {
+            if (inPlace) {
+                driver.emplaceRide<StandardRide>(registry, i, pickup, dropoff, 5.0);
+            } else {
+                const std::string pickupName(pickup);
+                const std::string dropoffName(dropoff);
+                const RideIndex ride = registry.create<StandardRide>(i, pickupName, dropoffName, 5.0);
+                registry[ride].calculateFare();
+                driver.addRide(ride);
+            }
+        }
+        state.PauseTiming();
+        allocations += allocationCount.load(std::memory_order_relaxed) - before;
+        state.ResumeTiming();
+    }
+    state.counters["allocs_per_ride"] = benchmark::Counter(
+        static_cast<double>(allocations) / (static_cast<double>(state.iterations()) * ridesPerRound));
+    state.SetItemsProcessed(state.iterations() * ridesPerRound);
+    state.SetLabel(inPlace ? "emplace" : "copy");
+}
+BENCHMARK(BM_EmplaceFromBuffer)->Arg(0)->Arg(1);
+
+// --- Pooled rides ---
+
+// One insertion check against a route already carrying range(0) riders, within a 3 km area
+void BM_PoolFindInsertion(benchmark::State& state) {
+    std::mt19937 rng(41);
+    std::uniform_real_distribution<double> offset(0.0, 0.03);
+    auto nearby = [&]() { return GeoPoint{ 40.75 + offset(rng), -73.99 + offset(rng) }; };
+    RideRegistry registry;
+    const RideIndex ride = registry.create<PooledRide>(1, "Pool Pickup", "Pool Dropoff", 2.0);
+    PoolLimits limits;
+    limits.maxDetourRatio = 1.0;
+    PoolRoute route(nearby(), limits);
+    for (int attempt = 0; attempt < 10000 && route.passengers().size() < static_cast<std::size_t>(state.range(0)); ++attempt) {
+        route.tryAdd(ride, nearby(), nearby());
+    }
+    std::vector<std::pair<GeoPoint, GeoPoint> > requests;
+    for (int i = 0; i < 1024; ++i) {
+        requests.emplace_back(nearby(), nearby());
+    }
+    std::size_t i = 0;
+    std::size_t feasible = 0;
+    for (auto _ : state) {
+        const auto& request = requests[i++ & (requests.size() - 1)];
+        feasible += route.findInsertion(request.first, request.second).feasible;
+    }
+    state.SetItemsProcessed(state.iterations());
+    state.counters["stops"] = static_cast<double>(route.stopCount());
+    state.counters["feasible"] = static_cast<double>(feasible) / static_cast<double>(state.iterations());
+}
+BENCHMARK(BM_PoolFindInsertion)->Arg(1)->Arg(3);
+
+// --- Time-bucketed history ---
+
+// "Last 30 days" totals over a year of rides: a flat scan vs. bucketed prefix sums
+void BM_TimelineLast30Days(benchmark::State& state) {
+    const std::int64_t yearStart = 1700000000;
+    const int ridesPerDay = static_cast<int>(state.range(1));
+    std::mt19937 rng(23);
+    std::uniform_int_distribution<std::int64_t> offset(0, RideTimeline::daySeconds - 1);
+    struct FlatEntry {
+        std::int64_t timestamp;
+        double fare;
+        double distance;
+    };
+    std::vector<FlatEntry> flat;
+    RideRegistry registry;
+    RideTimeline timeline(registry);
+    for (int day = 0; day < 365; ++day) {
+        std::vector<std::int64_t> times(ridesPerDay);
+        for (auto& t : times) {
+            t = yearStart + day * RideTimeline::daySeconds + offset(rng);
+        }
+        std::sort(times.begin(), times.end());
+        for (std::int64_t t : times) {
+            const RideIndex ride = registry.create<StandardRide>(static_cast<int>(flat.size()), "Home", "Work", 5.0);
+            registry[ride].restoreFare(12.5);
+            flat.push_back(FlatEntry{ t, 12.5, 5.0 });
+            timeline.record(t, ride, 12.5, 5.0);
+        }
+    }
+    const std::int64_t to = yearStart + 365 * RideTimeline::daySeconds - 3600;
+    const std::int64_t from = to - 30 * RideTimeline::daySeconds;
+    for (auto _ : state) {
+        if (state.range(0) == 0) {
+            RideTotals totals;
+            for (const FlatEntry& entry : flat) {
+                if (entry.timestamp >= from && entry.timestamp < to) {
+                    totals.add(entry.fare, entry.distance);
+                }
+            }
+            benchmark::DoNotOptimize(totals);
+        } else {
+            benchmark::DoNotOptimize(timeline.totalsBetween(from, to));
+        }
+    }
+    state.SetLabel(state.range(0) == 0 ? "scan" : "timeline");
+}
+BENCHMARK(BM_TimelineLast30Days)->ArgsProduct({ { 0, 1 }, { 20, 200 } });
+
+// --- Driver/Rider history ---
+
+void BM_DriverAddRide(benchmark::State& state) {
+    RideRegistry registry;
+    const RideIndex ride = registry.create<StandardRide>(1, "Home", "Work", 5.0);
+    for (auto _ : state) {
+        state.PauseTiming();
+        Driver driver(101, "John Doe", 4.8, registry);
+        state.ResumeTiming();
+        for (int i = 0; i < 1024; ++i) {
+            driver.addRide(ride);
+        }
+        benchmark::DoNotOptimize(driver);
+    }
+    state.SetItemsProcessed(state.iterations() * 1024);
+}
+BENCHMARK(BM_DriverAddRide);
+
+void BM_RiderRequestRide(benchmark::State& state) {
+    RideRegistry registry;
+    const RideIndex ride = registry.create<StandardRide>(1, "Home", "Work", 5.0);
+    for (auto _ : state) {
+        state.PauseTiming();
+        Rider rider(201, "Alice", registry);
+        state.ResumeTiming();
+        for (int i = 0; i < 1024; ++i) {
+            rider.requestRide(ride);
+        }
+        benchmark::DoNotOptimize(rider);
+    }
+    state.SetItemsProcessed(state.iterations() * 1024);
+}
+BENCHMARK(BM_RiderRequestRide);
+
+// Earnings report: walking the history vs. reading the running aggregates
+void BM_DriverEarningsScan(benchmark::State& state) {
+    RideRegistry registry;
+    Driver driver(101, "John Doe", 4.8, registry);
+    for (int i = 0; i < state.range(0); ++i) {
+        const RideIndex ride = registry.create<StandardRide>(i, "Home", "Work", 1.0 + i % 20);
+        registry[ride].calculateFare();
+        driver.addRide(ride);
+    }
+    for (auto _ : state) {
+        double total = 0.0;
+        for (RideIndex ride : driver.getAssignedRides()) {
+            total += registry[ride].getFare();
+        }
+        benchmark::DoNotOptimize(total);
+    }
+}
+BENCHMARK(BM_DriverEarningsScan)->Arg(100)->Arg(10000);
+
+void BM_DriverEarningsAggregate(benchmark::State& state) {
+    RideRegistry registry;
+    Driver driver(101, "John Doe", 4.8, registry);
+    for (int i = 0; i < state.range(0); ++i) {
+        const RideIndex ride = registry.create<StandardRide>(i, "Home", "Work", 1.0 + i % 20);
+        registry[ride].calculateFare();
+        driver.addRide(ride);
+    }
+    const std::int64_t now = currentTimestamp();
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(driver.getStats().getTotalFare());
+        benchmark::DoNotOptimize(driver.getStats().lastHour(now));
+    }
+}
+BENCHMARK(BM_DriverEarningsAggregate)->Arg(100)->Arg(10000);
+
+void BM_RiderViewRides(benchmark::State& state) {
+    const int count = static_cast<int>(state.range(0));
+    RideRegistry registry;
+    Rider rider(201, "Alice", registry);
+    for (int i = 0; i < count; ++i) {
+        RideIndex ride = i % 2 ? registry.create<PremiumRide>(i, "Home", "Airport", 15.0)
+                               : registry.create<StandardRide>(i, "Home", "Work", 5.0);
+        registry[ride].calculateFare();
+        rider.requestRide(ride);
+    }
+    CoutSilencer silence;
+    for (auto _ : state) {
+        rider.viewRides();
+    }
+    state.SetItemsProcessed(state.iterations() * count);
+}
+BENCHMARK(BM_RiderViewRides)->Arg(100)->Arg(10000);
+
+void BM_RiderViewRidesBuffered(benchmark::State& state) {
+    const int count = static_cast<int>(state.range(0));
+    RideRegistry registry;
+    Rider rider(201, "Alice", registry);
+    for (int i = 0; i < count; ++i) {
+        RideIndex ride = i % 2 ? registry.create<PremiumRide>(i, "Home", "Airport", 15.0)
+                               : registry.create<StandardRide>(i, "Home", "Work", 5.0);
+        registry[ride].calculateFare();
+        rider.requestRide(ride);
+    }
+    std::string out;
+    for (auto _ : state) {
+        out.clear();
+        rider.viewRides(out);
+        benchmark::DoNotOptimize(out.data());
+    }
+    state.SetItemsProcessed(state.iterations() * count);
+    state.SetBytesProcessed(state.iterations() * static_cast<std::int64_t>(out.size()));
+}
+BENCHMARK(BM_RiderViewRidesBuffered)->Arg(100)->Arg(10000);
+
+void BM_WriteRidesToStream(benchmark::State& state) {
+    const int count = static_cast<int>(state.range(0));
+    RideRegistry registry;
+    std::vector<RideIndex> rides;
+    for (int i = 0; i < count; ++i) {
+        rides.push_back(registry.create<StandardRide>(i, "Home", "Work", 5.0));
+        registry[rides.back()].calculateFare();
+    }
+    NullBuffer sinkBuffer;
+    std::ostream sink(&sinkBuffer);
+    for (auto _ : state) {
+        writeRides(registry, rides, sink);
+    }
+    state.SetItemsProcessed(state.iterations() * count);
+}
+BENCHMARK(BM_WriteRidesToStream)->Arg(10000);
+
+// --- Binary persistence ---
+
+std::string encodeRides(int count) {
+    std::ostringstream out;
+    ride_binary::Writer writer(out);
+    writer.beginRides(static_cast<std::uint64_t>(count));
+    for (int i = 0; i < count; ++i) {
+        writer.writeRide(ride_binary::RideRecord{ i, 0, 1, i % 3 ? RideType::Standard : RideType::Premium,
+                                                  1.0 + i % 40, 0.0 });
+    }
+    writer.flush();
+    return out.str();
+}
+
+void BM_BinaryWriteRides(benchmark::State& state) {
+    const int count = static_cast<int>(state.range(0));
+    std::size_t bytes = 0;
+    for (auto _ : state) {
+        bytes = encodeRides(count).size();
+    }
+    state.SetItemsProcessed(state.iterations() * count);
+    state.SetBytesProcessed(state.iterations() * static_cast<std::int64_t>(bytes));
+}
+BENCHMARK(BM_BinaryWriteRides)->Arg(1 << 20);
+
+void BM_BinaryReadRidesBatch(benchmark::State& state) {
+    const int count = static_cast<int>(state.range(0));
+    const std::string encoded = encodeRides(count);
+    for (auto _ : state) {
+        std::istringstream in(encoded);
+        ride_binary::Reader reader(in);
+        ride_binary::SectionHeader section;
+        RideBatch batch;
+        while (reader.nextSection(section)) {
+            reader.readRides(batch);
+        }
+        benchmark::DoNotOptimize(batch.size());
+    }
+    state.SetItemsProcessed(state.iterations() * count);
+    state.SetBytesProcessed(state.iterations() * static_cast<std::int64_t>(encoded.size()));
+}
+BENCHMARK(BM_BinaryReadRidesBatch)->Arg(1 << 20);
+
+void BM_HistoryStoreAppend(benchmark::State& state) {
+    const std::string path = "ride_bench_history.bin";
+    std::remove(path.c_str());
+    std::remove((path + ".loc").c_str());
+    {
+        RideHistoryStore store(path);
+        StandardRide ride(1, "Home", "Work", 5.0);
+        ride.calculateFare();
+        int rider = 0;
+        for (auto _ : state) {
+            store.appendRiderRide(rider++ % 1000, ride);
+        }
+        state.SetItemsProcessed(state.iterations());
+    }
+    std::remove(path.c_str());
+    std::remove((path + ".loc").c_str());
+}
+BENCHMARK(BM_HistoryStoreAppend);
+
+void BM_HistoryStoreScan(benchmark::State& state) {
+    const std::string path = "ride_bench_history.bin";
+    std::remove(path.c_str());
+    std::remove((path + ".loc").c_str());
+    {
+        RideHistoryStore store(path);
+        StandardRide ride(1, "Home", "Work", 5.0);
+        ride.calculateFare();
+        for (int i = 0; i < state.range(0); ++i) {
+            store.appendRiderRide(201, ride);
+        }
+        for (auto _ : state) {
+            double total = 0.0;
+            for (const RideRecordView& record : store.riderHistory(201)) {
+                total += record.getFare();
+            }
+            benchmark::DoNotOptimize(total);
+        }
+        state.SetItemsProcessed(state.iterations() * state.range(0));
+    }
+    std::remove(path.c_str());
+    std::remove((path + ".loc").c_str());
+}
+BENCHMARK(BM_HistoryStoreScan)->Arg(10000);
+
+// --- Dispatch paths ---
+
+// Hot-field lookup at fleet scale: open addressing with inline records vs. node-based map
+void BM_DriverStatusLookup(benchmark::State& state) {
+    const int driverCount = static_cast<int>(state.range(1));
+    std::mt19937 rng(13);
+    std::vector<int> ids(driverCount);
+    for (int i = 0; i < driverCount; ++i) {
+        ids[i] = static_cast<int>(rng());
+    }
+    std::vector<int> events(1 << 16);
+    for (int& id : events) {
+        id = ids[rng() % ids.size()];
+    }
+
+    FlatIdTable<DriverStatus> flat(ids.size());
+    std::unordered_map<int, DriverStatus> nodes;
+    for (int i = 0; i < driverCount; ++i) {
+        DriverStatus status{};
+        status.id = ids[i];
+        status.slot = static_cast<std::uint32_t>(i);
+        status.available = true;
+        if (state.range(0) == 0) {
+            nodes.emplace(ids[i], status);
+        } else {
+            flat.insert(status);
+        }
+    }
+
+    std::size_t i = 0;
+    int available = 0;
+    for (auto _ : state) {
+        const int id = events[i++ & (events.size() - 1)];
+        if (state.range(0) == 0) {
+            available += nodes.find(id)->second.available;
+        } else {
+            available += flat.find(id)->available;
+        }
+    }
+    benchmark::DoNotOptimize(available);
+    state.SetItemsProcessed(state.iterations());
+    state.SetLabel(state.range(0) == 0 ? "unordered_map" : "flat");
+}
+BENCHMARK(BM_DriverStatusLookup)->ArgsProduct({ { 0, 1 }, { 2000000 } });
+
+void BM_DriverRegistryGet(benchmark::State& state) {
+    RideRegistry rides;
+    DriverRegistry registry(rides, static_cast<std::size_t>(state.range(0)));
+    std::mt19937 rng(17);
+    for (int id = 0; id < state.range(0); ++id) {
+        registry.add(id * 7919, "Driver", 4.5, randomPoint(rng));
+    }
+    std::vector<int> events(1 << 16);
+    for (int& id : events) {
+        id = static_cast<int>(rng() % state.range(0)) * 7919;
+    }
+    std::size_t i = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(registry.get(events[i++ & (events.size() - 1)]).getRating());
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_DriverRegistryGet)->Arg(100000);
+
+void BM_DriverIndexNearest(benchmark::State& state) {
+    std::mt19937 rng(7);
+    DriverIndex index;
+    for (int id = 0; id < state.range(0); ++id) {
+        index.updatePosition(id, 4.5, randomPoint(rng));
+    }
+    std::vector<GeoPoint> pickups;
+    for (int i = 0; i < 1024; ++i) {
+        pickups.push_back(randomPoint(rng));
+    }
+    std::size_t i = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(index.nearestAvailable(pickups[i++ % pickups.size()], 5));
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_DriverIndexNearest)->Arg(10000)->Arg(100000);
+
+void BM_DriverIndexUpdate(benchmark::State& state) {
+    std::mt19937 rng(7);
+    std::normal_distribution<double> jitter(0.0, 0.0005);
+    const int count = static_cast<int>(state.range(0));
+    DriverIndex index;
+    std::vector<GeoPoint> positions;
+    for (int id = 0; id < count; ++id) {
+        positions.push_back(randomPoint(rng));
+        index.updatePosition(id, 4.5, positions.back());
+    }
+    int id = 0;
+    for (auto _ : state) {
+        GeoPoint& p = positions[id];
+        p.lat += jitter(rng);
+        p.lon += jitter(rng);
+        index.updatePosition(id, 4.5, p);
+        id = (id + 1) % count;
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_DriverIndexUpdate)->Arg(100000);
+
+void BM_RequestQueuePushPop(benchmark::State& state) {
+    RequestQueue queue(static_cast<std::size_t>(state.range(0)), 4096);
+    std::vector<RideRequest> batch;
+    batch.reserve(64);
+    RideRequest request{};
+    for (auto _ : state) {
+        for (int i = 0; i < 64; ++i) {
+            queue.tryPush(request);
+        }
+        batch.clear();
+        queue.drainBatch(batch, 64);
+    }
+    state.SetItemsProcessed(state.iterations() * 64);
+}
+BENCHMARK(BM_RequestQueuePushPop)->Arg(1)->Arg(4);
+
+void BM_DispatchRound(benchmark::State& state) {
+    const std::size_t workers = static_cast<std::size_t>(state.range(0));
+    const int requests = 2000;
+    for (auto _ : state) {
+        state.PauseTiming();
+        std::mt19937 rng(11);
+        ParallelDispatcher dispatcher(workers);
+        for (int id = 0; id < 20000; ++id) {
+            dispatcher.updateDriver(id, 4.5, randomPoint(rng));
+        }
+        for (int i = 0; i < requests; ++i) {
+            RideRequest request{};
+            request.requestID = static_cast<std::uint64_t>(i);
+            request.pickupPosition = randomPoint(rng);
+            dispatcher.submit(request);
+        }
+        state.ResumeTiming();
+        benchmark::DoNotOptimize(dispatcher.dispatch());
+    }
+    state.SetItemsProcessed(state.iterations() * requests);
+}
+BENCHMARK(BM_DispatchRound)->Arg(1)->Arg(2)->UseRealTime()->Unit(benchmark::kMillisecond);
+
+} // namespace
+
+BENCHMARK_MAIN();
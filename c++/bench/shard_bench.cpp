@@ -0,0 +1,162 @@
+/**
+ * @brief Benchmark: cross-node request routing and driver handoff over LoopbackTransport
+ * Requests enter at a random node and are routed to the owner of their pickup
+ * region; reports local vs. forwarded latency percentiles, bytes per frame,
+ * handoffs while drivers move, and how many regions move when a node joins.
+ * Loopback measures encoding, framing and the remote match, not the network hop.
+ * Built by the shard_bench CMake target
+ * Usage: shard_bench [nodes] [drivers] [requests]
+ */
+#include <iostream>
+#include <vector>
+#include <memory>
+#include <chrono>
+#include <random>
+#include <algorithm>
+#include <iomanip>
+#include <cstdlib>
+
+#include "../shard_node.h"
+
+namespace {
+
+double percentile(std::vector<double>& samples, double q) {
+    if (samples.empty()) {
+        return 0.0;
+    }
+    const std::size_t at = static_cast<std::size_t>(q * (samples.size() - 1));
+    std::nth_element(samples.begin(), samples.begin() + at, samples.end());
+    return samples[at];
+}
+
+void printLatency(const char* label, std::vector<double>& micros) {
+    std::cout << std::left << std::setw(12) << label << std::right << std::setw(10) << micros.size()
+              << std::fixed << std::setprecision(2)
+              << std::setw(10) << percentile(micros, 0.50)
+              << std::setw(10) << percentile(micros, 0.99)
+              << std::setw(10) << percentile(micros, 0.999) << std::endl;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const std::size_t nodeCount = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 4;
+    const std::size_t driverCount = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 20000;
+    const std::size_t requests = argc > 3 ? std::strtoul(argv[3], nullptr, 10) : 200000;
+    if (nodeCount == 0 || driverCount == 0) {
+        std::cerr << "nodes and drivers must be greater than 0" << std::endl;
+        return 1;
+    }
+
+    ShardRing ring;
+    for (std::size_t n = 0; n < nodeCount; ++n) {
+        ring.addNode(static_cast<NodeID>(n));
+    }
+    LoopbackTransport transport;
+    std::vector<std::unique_ptr<ShardNode>> nodes;
+    for (std::size_t n = 0; n < nodeCount; ++n) {
+        nodes.push_back(std::make_unique<ShardNode>(static_cast<NodeID>(n), ring, transport));
+        transport.attach(*nodes.back());
+    }
+
+    // A 40 x 40 km metro around lower Manhattan
+    std::mt19937 rng(11);
+    std::uniform_real_distribution<double> lat(40.55, 40.91);
+    std::uniform_real_distribution<double> lon(-74.20, -73.72);
+    std::vector<GeoPoint> driverPositions(driverCount);
+    std::vector<NodeID> driverNode(driverCount);
+    for (std::size_t i = 0; i < driverCount; ++i) {
+        driverPositions[i] = GeoPoint{ lat(rng), lon(rng) };
+        driverNode[i] = ring.nodeFor(driverPositions[i]);
+        nodes[driverNode[i]]->addDriver(static_cast<int>(i + 1), "Driver", 4.5, driverPositions[i]);
+    }
+
+    LocationTable& names = LocationTable::global();
+    RideRequest request{};
+    request.pickupLocation = names.intern("Pickup");
+    request.dropoffLocation = names.intern("Dropoff");
+    request.type = RideType::Standard;
+    request.distance = 3.0;
+    std::uniform_int_distribution<std::size_t> entry(0, nodeCount - 1);
+    std::vector<double> local;
+    std::vector<double> forwarded;
+    std::size_t confirmed = 0;
+    std::size_t routeFrames = 0;
+    for (std::size_t i = 0; i < requests; ++i) {
+        request.requestID = i + 1;
+        request.riderID = static_cast<int>(i % 50000) + 1;
+        request.pickupPosition = GeoPoint{ lat(rng), lon(rng) };
+        ShardNode& front = *nodes[entry(rng)];
+        const bool remote = !front.owns(request.pickupPosition);
+        shard_wire::RouteReplyMessage result{};
+        const auto start = std::chrono::steady_clock::now();
+        front.route(request, "Rider", [&result](const shard_wire::RouteReplyMessage& reply) { result = reply; });
+        routeFrames += transport.pump();
+        const double micros = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+        (remote ? forwarded : local).push_back(micros);
+        if (result.status == shard_wire::RouteStatus::Confirmed) {
+            ++confirmed;
+            nodes[result.servedBy]->completeRide(result.driverID);
+        }
+    }
+    const std::uint64_t routeBytes = transport.bytesSent();
+
+    std::cout << nodeCount << " nodes, " << driverCount << " drivers, " << confirmed << "/" << requests
+              << " requests confirmed\n"
+              << std::left << std::setw(12) << "route" << std::right << std::setw(10) << "count"
+              << std::setw(10) << "p50 us" << std::setw(10) << "p99 us" << std::setw(10) << "p99.9 us" << std::endl;
+    printLatency("local", local);
+    printLatency("forwarded", forwarded);
+    std::uint64_t queries = 0;
+    std::uint64_t delegated = 0;
+    for (const auto& node : nodes) {
+        queries += node->stats().driverQueries;
+        delegated += node->stats().delegatedRoutes;
+    }
+    std::cout << queries << " neighbour driver queries, " << delegated << " requests served across a region edge"
+              << std::endl;
+    std::cout << "bytes per route frame " << std::setprecision(1)
+              << (routeFrames ? static_cast<double>(routeBytes) / routeFrames : 0.0) << std::endl;
+
+    // Drivers drift ~300 m per step; crossing a region boundary hands them off
+    std::normal_distribution<double> drift(0.0, 0.003);
+    const auto moveStart = std::chrono::steady_clock::now();
+    std::size_t moves = 0;
+    for (int step = 0; step < 20; ++step) {
+        for (std::size_t i = 0; i < driverCount; ++i) {
+            driverPositions[i].lat += drift(rng);
+            driverPositions[i].lon += drift(rng);
+            nodes[driverNode[i]]->updateDriverPosition(static_cast<int>(i + 1), driverPositions[i]);
+            driverNode[i] = ring.nodeFor(driverPositions[i]);
+            ++moves;
+        }
+        transport.pump();
+    }
+    const double moveSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - moveStart).count();
+    std::uint64_t handoffs = 0;
+    for (const auto& node : nodes) {
+        handoffs += node->stats().handoffsOut;
+    }
+    std::cout << moves << " position updates, " << handoffs << " handoffs, "
+              << std::setprecision(0) << moves / moveSeconds << " updates/sec" << std::endl;
+
+    // Share of regions that change owner when one more node joins
+    std::vector<std::uint64_t> regions;
+    for (double a = 40.55; a < 40.91; a += ring.getRegionDegrees()) {
+        for (double b = -74.20; b < -73.72; b += ring.getRegionDegrees()) {
+            regions.push_back(ring.regionOf(GeoPoint{ a, b }));
+        }
+    }
+    std::vector<NodeID> before;
+    for (std::uint64_t region : regions) {
+        before.push_back(ring.nodeForRegion(region));
+    }
+    ring.addNode(static_cast<NodeID>(nodeCount));
+    std::size_t moved = 0;
+    for (std::size_t r = 0; r < regions.size(); ++r) {
+        moved += ring.nodeForRegion(regions[r]) != before[r];
+    }
+    std::cout << "adding node " << nodeCount << " moves " << moved << " of " << regions.size()
+              << " regions (ideal " << std::setprecision(1) << 100.0 / (nodeCount + 1) << "%)" << std::endl;
+    return 0;
+}
@@ -0,0 +1,85 @@
+/**
+ * @brief Check: WriteAheadLog::commit() after a failed write
+ * A file size limit (RLIMIT_FSIZE) makes one batch's write stop partway, leaving
+ * a torn frame. The failed commit must not count as durable, the retry must cut
+ * the torn bytes off, and replay must then see every committed entry.
+ * Exits nonzero on failure
+ * Built by the wal_fault_check CMake target
+ * Usage: wal_fault_check [path]
+ */
+#include <iostream>
+#include <string>
+#include <vector>
+#include <filesystem>
+#include <system_error>
+#include <csignal>
+
+#include <sys/resource.h>
+
+#include "../write_ahead_log.h"
+
+namespace {
+
+bool check(bool condition, const char* what) {
+    if (!condition) {
+        std::cerr << "FAIL: " << what << std::endl;
+    }
+    return condition;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const std::string path = argc > 1 ? argv[1] : "wal_fault_check.log";
+    std::filesystem::remove(path);
+    const unsigned char payload[100] = {};
+    bool ok = true;
+    {
+        WriteAheadLog log(path, 1);
+        for (int i = 0; i < 3; ++i) {
+            log.append(WriteAheadLog::EntryKind::SetFare, payload, 12);
+        }
+        log.commitAll();
+
+        // Let the next batch reach only 20 bytes past the current end of the file
+        std::signal(SIGXFSZ, SIG_IGN);
+        rlimit original;
+        getrlimit(RLIMIT_FSIZE, &original);
+        rlimit limited = original;
+        limited.rlim_cur = static_cast<rlim_t>(std::filesystem::file_size(path) + 20);
+        setrlimit(RLIMIT_FSIZE, &limited);
+        const WriteAheadLog::LSN torn = log.append(WriteAheadLog::EntryKind::SetFare, payload, sizeof(payload));
+        bool threw = false;
+        try {
+            log.commit(torn);
+        } catch (const std::system_error&) {
+            threw = true;
+        }
+        setrlimit(RLIMIT_FSIZE, &original);
+        ok &= check(threw, "commit of a torn batch did not throw");
+        ok &= check(log.syncs() == 1, "failed batch was counted as synced");
+
+        // The failed batch is retried, ahead of entries appended after it
+        const WriteAheadLog::LSN after = log.append(WriteAheadLog::EntryKind::SetFare, payload, 12);
+        try {
+            log.commit(after);
+        } catch (const std::exception& error) {
+            ok &= check(false, "retry after a failed write threw");
+            std::cerr << error.what() << std::endl;
+        }
+    }
+
+    std::vector<std::size_t> sizes;
+    const WriteAheadLog::ReplayResult replayed = WriteAheadLog::replay(
+        path, [&sizes](WriteAheadLog::EntryKind, const unsigned char*, std::size_t size) {
+            sizes.push_back(size);
+            return true;
+        });
+    ok &= check(replayed.entries == 5, "replay lost entries committed after the failure");
+    ok &= check(replayed.validBytes == std::filesystem::file_size(path), "torn bytes were left in the log");
+    ok &= check(sizes.size() == 5 && sizes[3] == sizeof(payload) && sizes[4] == 12, "entries replayed out of order");
+    std::filesystem::remove(path);
+
+    std::cout << (ok ? "PASS" : "FAIL") << ": failed write rolled back and retried" << std::endl;
+    return ok ? 0 : 1;
+}
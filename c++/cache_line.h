@@ -0,0 +1,9 @@
+#ifndef RIDE_SHARING_CACHE_LINE_H
+#define RIDE_SHARING_CACHE_LINE_H
+
+#include <cstddef>
+
+// Alignment used to keep independently written atomics off each other's cache lines
+constexpr std::size_t cacheLineSize = 64;
+
+#endif // RIDE_SHARING_CACHE_LINE_H
@@ -0,0 +1,40 @@
+#ifndef RIDE_SHARING_CRC32_H
+#define RIDE_SHARING_CRC32_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @brief CRC-32 (IEEE, reflected) used to detect torn or corrupt log entries
+ */
+namespace crc32_detail {
+
+inline const std::array<std::uint32_t, 256>& table() {
+    static const std::array<std::uint32_t, 256> values = []() {
+        std::array<std::uint32_t, 256> t{};
+        for (std::uint32_t i = 0; i < 256; ++i) {
+            std::uint32_t c = i;
+            for (int k = 0; k < 8; ++k) {
+                c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+            }
+            t[i] = c;
+        }
+        return t;
+    }();
+    return values;
+}
+
+} // namespace crc32_detail
+
+inline std::uint32_t crc32(const void* data, std::size_t size, std::uint32_t seed = 0) {
+    const auto& t = crc32_detail::table();
+    const unsigned char* bytes = static_cast<const unsigned char*>(data);
+    std::uint32_t c = ~seed;
+    for (std::size_t i = 0; i < size; ++i) {
+        c = t[(c ^ bytes[i]) & 0xFF] ^ (c >> 8);
+    }
+    return ~c;
+}
+
+#endif // RIDE_SHARING_CRC32_H
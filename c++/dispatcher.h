@@ -0,0 +1,415 @@
+#ifndef RIDE_SHARING_DISPATCHER_H
+#define RIDE_SHARING_DISPATCHER_H
+
+#include <vector>
+#include <deque>
+#include <memory>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <exception>
+#include <thread>
+#include <unordered_map>
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+
+#include "cache_line.h"
+#include "geo.h"
+#include "driver.h"
+#include "driver_index.h"
+#include "ride_request.h"
+#include "metrics.h"
+
+/**
+ * @brief Outcome of dispatching one request
+ */
+struct Assignment {
+    std::uint64_t requestID;
+    int riderID;
+    int driverID;
+    double distanceKm;
+    bool recorded;   // the worker already added the request's ride to the linked Driver
+};
+
+struct DispatchResult {
+    std::vector<Assignment> assignments;
+    std::vector<RideRequest> unassigned;
+    std::size_t stolen = 0;
+};
+
+/**
+ * @brief ParallelDispatcher class - geo-sharded, work-stealing ride assignment
+ * The city is cut into coarse cells hashed onto shards; each shard has its own
+ * DriverIndex and lock, and each worker owns one shard's request deque. A
+ * request searches every shard owning a cell within maxRadiusKm of its pickup.
+ * Workers that run dry steal from other deques, preferring requests within
+ * boundaryKm of a cell edge. A driver is handed out by a compare-and-swap on its
+ * claim flag, so two workers can never assign the same driver and no global
+ * lock is involved; a worker that loses every claim searches again. The workers
+ * are started once and sleep between dispatch() rounds.
+ * A request submitted with its ride is also recorded by the worker that wins
+ * the driver: Driver::addRide runs on that worker for drivers registered by
+ * reference. The claim makes it the driver's only writer until releaseDriver().
+ */
+class ParallelDispatcher {
+public:
+    static constexpr double defaultShardCellDegrees = 0.05;   // roughly 5 km
+    static constexpr std::size_t candidatesPerShard = 4;
+    static constexpr RideIndex noRide = UINT32_MAX;   // submit() without a ride to record
+
+private:
+    struct alignas(cacheLineSize) Shard {
+        std::mutex mutex;
+        DriverIndex drivers;
+    };
+
+    struct Queued {
+        RideRequest request;
+        RideIndex ride;
+        std::int64_t assignedAt;
+        bool boundary;
+    };
+
+    struct alignas(cacheLineSize) WorkQueue {
+        std::mutex mutex;
+        std::deque<Queued> requests;
+    };
+
+    struct DriverState {
+        std::size_t shard;
+        std::atomic<bool> claimed;
+        Driver* driver = nullptr;   // set by updateDriver(Driver&); written only by the claiming worker
+    };
+
+    double shardCellDegrees;
+    double boundaryKm;
+    double maxRadiusKm;
+    std::vector<std::unique_ptr<Shard> > shards;
+    std::vector<std::unique_ptr<WorkQueue> > queues;
+    std::unordered_map<int, std::unique_ptr<DriverState> > driverStates;
+
+    // Worker pool; partial[w] is written only by worker w during a round
+    std::mutex poolMutex;
+    std::condition_variable wake;
+    std::condition_variable idle;
+    std::uint64_t round;
+    std::size_t running;
+    bool stopping;
+    std::exception_ptr failure;
+    std::vector<DispatchResult> partial;
+    std::vector<std::thread> workers;
+
+    std::int32_t cellCoord(double degrees) const {
+        return static_cast<std::int32_t>(std::floor(degrees / shardCellDegrees));
+    }
+
+    std::size_t shardOfCell(std::int32_t latCell, std::int32_t lonCell) const {
+        std::uint64_t h = (static_cast<std::uint64_t>(static_cast<std::uint32_t>(latCell)) << 32)
+                        | static_cast<std::uint32_t>(lonCell);
+        h ^= h >> 33;
+        h *= 0xff51afd7ed558ccdULL;
+        h ^= h >> 33;
+        return static_cast<std::size_t>(h % shards.size());
+    }
+
+    // Distance from p to the nearest edge of its shard cell
+    double edgeDistanceKm(const GeoPoint& p) const {
+        const double latOffset = p.lat / shardCellDegrees - std::floor(p.lat / shardCellDegrees);
+        const double lonOffset = p.lon / shardCellDegrees - std::floor(p.lon / shardCellDegrees);
+        const double latEdge = std::min(latOffset, 1.0 - latOffset) * shardCellDegrees * kmPerDegree;
+        const double lonEdge = std::min(lonOffset, 1.0 - lonOffset) * shardCellDegrees * kmPerDegree
+                             * std::cos(degreesToRadians(p.lat));
+        return std::min(latEdge, lonEdge);
+    }
+
+    // Home shard first, then the distinct shards of every other cell within maxRadiusKm of pickup
+    std::vector<std::size_t> candidateShards(const GeoPoint& pickup) const {
+        const std::int32_t latCell = cellCoord(pickup.lat);
+        const std::int32_t lonCell = cellCoord(pickup.lon);
+        std::vector<std::size_t> result{ shardOfCell(latCell, lonCell) };
+        const double latSpan = maxRadiusKm / kmPerDegree;
+        const double lonSpan = maxRadiusKm / (kmPerDegree * std::max(1e-6, std::cos(degreesToRadians(pickup.lat))));
+        for (std::int32_t lat = cellCoord(pickup.lat - latSpan); lat <= cellCoord(pickup.lat + latSpan); ++lat) {
+            for (std::int32_t lon = cellCoord(pickup.lon - lonSpan); lon <= cellCoord(pickup.lon + lonSpan); ++lon) {
+                const std::size_t shard = shardOfCell(lat, lon);
+                if (std::find(result.begin(), result.end(), shard) != result.end()) {
+                    continue;
+                }
+                // Nearest point of the cell to the pickup
+                const GeoPoint nearest{ std::clamp(pickup.lat, lat * shardCellDegrees, (lat + 1) * shardCellDegrees),
+                                        std::clamp(pickup.lon, lon * shardCellDegrees, (lon + 1) * shardCellDegrees) };
+                if (distanceKm(pickup, nearest) <= maxRadiusKm) {
+                    result.push_back(shard);
+                }
+            }
+        }
+        return result;
+    }
+
+    bool tryAssign(const Queued& queued, std::vector<Assignment>& out) {
+        const RideRequest& request = queued.request;
+        const std::vector<std::size_t> searched = candidateShards(request.pickupPosition);
+        std::vector<DriverMatch> candidates;
+        // Claims lost to other workers leave those drivers unavailable, so each search finds fresh ones
+        for (;;) {
+            candidates.clear();
+            for (std::size_t shardIndex : searched) {
+                Shard& shard = *shards[shardIndex];
+                std::lock_guard<std::mutex> lock(shard.mutex);
+                std::vector<DriverMatch> found =
+                    shard.drivers.nearestAvailable(request.pickupPosition, candidatesPerShard, maxRadiusKm);
+                candidates.insert(candidates.end(), found.begin(), found.end());
+            }
+            if (candidates.empty()) {
+                return false;
+            }
+            std::sort(candidates.begin(), candidates.end(),
+                      [](const DriverMatch& a, const DriverMatch& b) { return a.score < b.score; });
+
+            for (const DriverMatch& candidate : candidates) {
+                DriverState& state = *driverStates.at(candidate.driverID);
+                bool expected = false;
+                if (!state.claimed.compare_exchange_strong(expected, true, std::memory_order_acq_rel)) {
+                    continue;
+                }
+                {
+                    Shard& shard = *shards[state.shard];
+                    std::lock_guard<std::mutex> lock(shard.mutex);
+                    shard.drivers.setAvailable(candidate.driverID, false);
+                }
+                const bool record = state.driver != nullptr && queued.ride != noRide;
+                if (record) {
+                    state.driver->addRide(queued.ride, queued.assignedAt);
+                }
+                out.push_back(Assignment{ request.requestID, request.riderID, candidate.driverID, candidate.distanceKm,
+                                          record });
+                return true;
+            }
+            // Let the winners mark their drivers unavailable before searching again
+            std::this_thread::yield();
+        }
+    }
+
+    void runWorker(std::size_t w) {
+        DispatchResult& result = partial[w];
+        Queued queued;
+        for (;;) {
+            if (!popOwn(*queues[w], queued)) {
+                if (!steal(w, queued)) {
+                    break;
+                }
+                ++result.stolen;
+            }
+            if (!tryAssign(queued, result.assignments)) {
+                result.unassigned.push_back(queued.request);
+            }
+        }
+    }
+
+    void workerLoop(std::size_t w) {
+        std::uint64_t seen = 0;
+        std::unique_lock<std::mutex> lock(poolMutex);
+        for (;;) {
+            wake.wait(lock, [this, seen]() { return stopping || round != seen; });
+            if (stopping) {
+                return;
+            }
+            seen = round;
+            lock.unlock();
+            std::exception_ptr error;
+            try {
+                runWorker(w);
+            } catch (...) {
+                error = std::current_exception();
+            }
+            lock.lock();
+            if (error && !failure) {
+                failure = error;
+            }
+            if (--running == 0) {
+                idle.notify_all();
+            }
+        }
+    }
+
+    bool popOwn(WorkQueue& queue, Queued& queued) {
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        if (queue.requests.empty()) {
+            return false;
+        }
+        queued = queue.requests.front();
+        queue.requests.pop_front();
+        return true;
+    }
+
+    // Takes from the back of a victim's deque, preferring a boundary request among the last few
+    bool steal(std::size_t thief, Queued& queued) {
+        const std::size_t count = queues.size();
+        for (std::size_t i = 1; i < count; ++i) {
+            WorkQueue& victim = *queues[(thief + i) % count];
+            std::lock_guard<std::mutex> lock(victim.mutex);
+            if (victim.requests.empty()) {
+                continue;
+            }
+            std::size_t pick = victim.requests.size() - 1;
+            const std::size_t scan = std::min<std::size_t>(victim.requests.size(), 8);
+            for (std::size_t j = 0; j < scan; ++j) {
+                const std::size_t at = victim.requests.size() - 1 - j;
+                if (victim.requests[at].boundary) {
+                    pick = at;
+                    break;
+                }
+            }
+            queued = victim.requests[pick];
+            victim.requests.erase(victim.requests.begin() + static_cast<std::ptrdiff_t>(pick));
+            return true;
+        }
+        return false;
+    }
+
+public:
+    ParallelDispatcher(std::size_t workerCount, double shardCellDegrees = defaultShardCellDegrees,
+                       double boundaryKm = 1.0, double maxRadiusKm = 10.0)
+        : shardCellDegrees(shardCellDegrees), boundaryKm(boundaryKm), maxRadiusKm(maxRadiusKm), round(0), running(0),
+          stopping(false), partial(workerCount) {
+        if (workerCount == 0) {
+            throw std::invalid_argument("Worker count must be greater than 0");
+        }
+        if (shardCellDegrees <= 0) {
+            throw std::invalid_argument("Shard cell size must be greater than 0");
+        }
+        if (!(maxRadiusKm > 0)) {
+            throw std::invalid_argument("Search radius must be greater than 0");
+        }
+        for (std::size_t i = 0; i < workerCount; ++i) {
+            shards.push_back(std::make_unique<Shard>());
+            queues.push_back(std::make_unique<WorkQueue>());
+        }
+        workers.reserve(workerCount);
+        for (std::size_t w = 0; w < workerCount; ++w) {
+            workers.emplace_back([this, w]() { workerLoop(w); });
+        }
+    }
+
+    ParallelDispatcher(const ParallelDispatcher&) = delete;
+    ParallelDispatcher& operator=(const ParallelDispatcher&) = delete;
+
+    ~ParallelDispatcher() {
+        {
+            std::lock_guard<std::mutex> lock(poolMutex);
+            stopping = true;
+        }
+        wake.notify_all();
+        for (std::thread& worker : workers) {
+            worker.join();
+        }
+    }
+
+    std::size_t workerCount() const { return queues.size(); }
+
+    std::size_t shardOf(const GeoPoint& p) const {
+        return shardOfCell(cellCoord(p.lat), cellCoord(p.lon));
+    }
+
+    /**
+     * @brief Registers a driver or moves it, re-homing it when it crosses into another shard
+     * Must not run concurrently with dispatch()
+     */
+    void updateDriver(int driverID, double rating, const GeoPoint& position) {
+        const std::size_t shard = shardOf(position);
+        auto found = driverStates.find(driverID);
+        if (found == driverStates.end()) {
+            auto state = std::make_unique<DriverState>();
+            state->shard = shard;
+            state->claimed.store(false, std::memory_order_relaxed);
+            driverStates.emplace(driverID, std::move(state));
+            shards[shard]->drivers.updatePosition(driverID, rating, position);
+            return;
+        }
+        DriverState& state = *found->second;
+        if (state.shard != shard) {
+            shards[state.shard]->drivers.remove(driverID);
+            state.shard = shard;
+        }
+        shards[shard]->drivers.updatePosition(driverID, rating, position);
+        if (state.claimed.load(std::memory_order_relaxed)) {
+            shards[shard]->drivers.setAvailable(driverID, false);
+        }
+    }
+
+    void updateDriver(const Driver& driver, const GeoPoint& position) {
+        updateDriver(driver.getDriverID(), driver.getRating(), position);
+    }
+
+    // Also links driver, so workers record submitted rides on it; it must outlive the dispatcher
+    void updateDriver(Driver& driver, const GeoPoint& position) {
+        updateDriver(driver.getDriverID(), driver.getRating(), position);
+        driverStates.at(driver.getDriverID())->driver = &driver;
+    }
+
+    // Makes an assigned driver available again once the trip is over
+    void releaseDriver(int driverID) {
+        DriverState& state = *driverStates.at(driverID);
+        Shard& shard = *shards[state.shard];
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        state.claimed.store(false, std::memory_order_release);
+        shard.drivers.setAvailable(driverID, true);
+    }
+
+    bool isClaimed(int driverID) const {
+        return driverStates.at(driverID)->claimed.load(std::memory_order_acquire);
+    }
+
+    /**
+     * @brief Queues a request on the worker that owns its pickup shard
+     * With ride (already created and priced), the winning worker adds it to a
+     * linked Driver at assignedAt; the ride's registry must not change during dispatch()
+     */
+    void submit(const RideRequest& request, RideIndex ride = noRide, std::int64_t assignedAt = currentTimestamp()) {
+        WorkQueue& queue = *queues[shardOf(request.pickupPosition)];
+        const bool nearBoundary = edgeDistanceKm(request.pickupPosition) < boundaryKm;
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        queue.requests.push_back(Queued{ request, ride, assignedAt, nearBoundary });
+    }
+
+    /**
+     * @brief Wakes the workers, one per shard, until every queued request is handled
+     * Rides submitted for linked drivers are recorded by the workers (see
+     * Assignment::recorded); riders are not sharded, so Rider::requestRide and
+     * any unrecorded assignment are left to the caller. Rethrows the first
+     * worker failure
+     */
+    DispatchResult dispatch() {
+        RIDE_METRICS_TIME(DispatchRound);
+        std::exception_ptr error;
+        {
+            std::unique_lock<std::mutex> lock(poolMutex);
+            for (DispatchResult& result : partial) {
+                result = DispatchResult{};
+            }
+            running = workers.size();
+            ++round;
+            wake.notify_all();
+            idle.wait(lock, [this]() { return running == 0; });
+            std::swap(error, failure);
+        }
+        if (error) {
+            std::rethrow_exception(error);
+        }
+
+        DispatchResult merged;
+        for (auto& result : partial) {
+            merged.assignments.insert(merged.assignments.end(), result.assignments.begin(), result.assignments.end());
+            merged.unassigned.insert(merged.unassigned.end(), result.unassigned.begin(), result.unassigned.end());
+            merged.stolen += result.stolen;
+        }
+        RIDE_METRICS_COUNT(DispatchAssignments, merged.assignments.size());
+        RIDE_METRICS_COUNT(DispatchUnassigned, merged.unassigned.size());
+        return merged;
+    }
+};
+
+#endif // RIDE_SHARING_DISPATCHER_H
@@ -0,0 +1,599 @@
+#ifndef RIDE_SHARING_DISTANCE_PROVIDER_H
+#define RIDE_SHARING_DISTANCE_PROVIDER_H
+
+#include <vector>
+#include <queue>
+#include <limits>
+#include <utility>
+#include <functional>
+#include <unordered_map>
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+
+#include "location_table.h"
+#include "ride_registry.h"
+
+/**
+ * @brief DistanceProvider class - pluggable road distance between locations
+ * Distances are in miles, like Ride::getDistance(); +infinity means no route.
+ * distances() is the many-to-many form used for dispatch scoring.
+ */
+class DistanceProvider {
+protected:
+    // out[i * toCount + j] = distance(from[i], to[j])
+    virtual void computeDistances(const LocationID* from, std::size_t fromCount,
+                                  const LocationID* to, std::size_t toCount, double* out) const {
+        for (std::size_t i = 0; i < fromCount; ++i) {
+            for (std::size_t j = 0; j < toCount; ++j) {
+                out[i * toCount + j] = distance(from[i], to[j]);
+            }
+        }
+    }
+
+public:
+    static constexpr double unreachable = std::numeric_limits<double>::infinity();
+
+    virtual ~DistanceProvider() = default;
+
+    virtual double distance(LocationID from, LocationID to) const = 0;
+
+    void distances(const LocationID* from, std::size_t fromCount,
+                   const LocationID* to, std::size_t toCount, double* out) const {
+        computeDistances(from, fromCount, to, toCount, out);
+    }
+
+    // Row-major fromCount x toCount table
+    void distances(const std::vector<LocationID>& from, const std::vector<LocationID>& to,
+                   std::vector<double>& out) const {
+        out.resize(from.size() * to.size());
+        computeDistances(from.data(), from.size(), to.data(), to.size(), out.data());
+    }
+};
+
+/**
+ * @brief DistanceMatrix class - precomputed distances between frequent locations
+ * Stored in blockSize x blockSize tiles so a batch of nearby rows and columns
+ * reads a few contiguous tiles instead of striding across whole rows.
+ */
+class DistanceMatrix : public DistanceProvider {
+public:
+    static constexpr std::size_t blockSize = 16;
+
+private:
+    std::vector<LocationID> locations;
+    std::vector<std::int32_t> indexOfLocation;   // by LocationID; -1 when not in the matrix
+    std::size_t blocksPerRow;
+    std::vector<double> cells;
+
+    std::size_t offset(std::size_t row, std::size_t col) const {
+        return ((row / blockSize) * blocksPerRow + col / blockSize) * blockSize * blockSize
+             + (row % blockSize) * blockSize + col % blockSize;
+    }
+
+    void fill(const DistanceProvider& source) {
+        std::vector<double> table;
+        source.distances(locations, locations, table);
+        for (std::size_t i = 0; i < locations.size(); ++i) {
+            for (std::size_t j = 0; j < locations.size(); ++j) {
+                cells[offset(i, j)] = table[i * locations.size() + j];
+            }
+        }
+    }
+
+protected:
+    void computeDistances(const LocationID* from, std::size_t fromCount,
+                          const LocationID* to, std::size_t toCount, double* out) const override {
+        std::vector<std::int32_t> cols(toCount);
+        for (std::size_t j = 0; j < toCount; ++j) {
+            cols[j] = indexOf(to[j]);
+        }
+        for (std::size_t i = 0; i < fromCount; ++i) {
+            const std::int32_t row = indexOf(from[i]);
+            double* line = out + i * toCount;
+            for (std::size_t j = 0; j < toCount; ++j) {
+                line[j] = row < 0 || cols[j] < 0
+                    ? (from[i] == to[j] ? 0.0 : unreachable)
+                    : cells[offset(static_cast<std::size_t>(row), static_cast<std::size_t>(cols[j]))];
+            }
+        }
+    }
+
+public:
+    // Matrix over locations with no known routes yet: 0 on the diagonal, unreachable elsewhere
+    explicit DistanceMatrix(const std::vector<LocationID>& locations)
+        : locations(locations), blocksPerRow((locations.size() + blockSize - 1) / blockSize),
+          cells(blocksPerRow * blocksPerRow * blockSize * blockSize, unreachable) {
+        for (std::size_t i = 0; i < locations.size(); ++i) {
+            const LocationID id = locations[i];
+            if (id >= indexOfLocation.size()) {
+                indexOfLocation.resize(static_cast<std::size_t>(id) + 1, -1);
+            }
+            if (indexOfLocation[id] >= 0) {
+                throw std::invalid_argument("Duplicate location in distance matrix");
+            }
+            indexOfLocation[id] = static_cast<std::int32_t>(i);
+            cells[offset(i, i)] = 0.0;
+        }
+    }
+
+    // Precomputes every pair with one many-to-many query against source
+    DistanceMatrix(const std::vector<LocationID>& locations, const DistanceProvider& source)
+        : DistanceMatrix(locations) {
+        fill(source);
+    }
+
+    void set(LocationID from, LocationID to, double miles) {
+        const std::int32_t row = indexOf(from);
+        const std::int32_t col = indexOf(to);
+        if (row < 0 || col < 0) {
+            throw std::invalid_argument("Location is not in the distance matrix");
+        }
+        cells[offset(static_cast<std::size_t>(row), static_cast<std::size_t>(col))] = miles;
+    }
+
+    std::int32_t indexOf(LocationID id) const {
+        return id < indexOfLocation.size() ? indexOfLocation[id] : -1;
+    }
+
+    bool contains(LocationID id) const { return indexOf(id) >= 0; }
+
+    double distance(LocationID from, LocationID to) const override {
+        const std::int32_t row = indexOf(from);
+        const std::int32_t col = indexOf(to);
+        if (row < 0 || col < 0) {
+            return from == to ? 0.0 : unreachable;
+        }
+        return cells[offset(static_cast<std::size_t>(row), static_cast<std::size_t>(col))];
+    }
+
+    const std::vector<LocationID>& getLocations() const { return locations; }
+    std::size_t size() const { return locations.size(); }
+};
+
+/**
+ * @brief RoadGraph class - road network with contraction-hierarchy queries
+ * Add roads, then contract() once: nodes are removed in order of importance
+ * and shortcuts keep the remaining distances exact. A query is a bidirectional
+ * Dijkstra that only climbs to higher-ranked nodes, so it settles a few hundred
+ * nodes instead of the whole city. Roads are two-way.
+ */
+class RoadGraph : public DistanceProvider {
+private:
+    struct Arc {
+        std::uint32_t to;
+        double miles;
+    };
+
+    using QueueEntry = std::pair<double, std::uint32_t>;
+
+    // Min-heap whose storage survives between searches
+    struct MinQueue : std::priority_queue<QueueEntry, std::vector<QueueEntry>, std::greater<QueueEntry>> {
+        void clear() { c.clear(); }
+    };
+
+    std::unordered_map<LocationID, std::uint32_t> nodeOfLocation;
+    std::vector<std::vector<Arc>> roads;
+    std::vector<std::vector<Arc>> upward;   // arcs to higher-ranked nodes, shortcuts included
+    std::size_t shortcuts;
+    bool contracted;
+
+    static void relaxArc(std::vector<Arc>& arcs, std::uint32_t to, double miles) {
+        for (Arc& arc : arcs) {
+            if (arc.to == to) {
+                arc.miles = std::min(arc.miles, miles);
+                return;
+            }
+        }
+        arcs.push_back(Arc{ to, miles });
+    }
+
+    std::uint32_t nodeFor(LocationID location) {
+        auto found = nodeOfLocation.find(location);
+        if (found != nodeOfLocation.end()) {
+            return found->second;
+        }
+        const std::uint32_t node = static_cast<std::uint32_t>(roads.size());
+        nodeOfLocation.emplace(location, node);
+        roads.emplace_back();
+        return node;
+    }
+
+    std::int64_t nodeOf(LocationID location) const {
+        auto found = nodeOfLocation.find(location);
+        return found == nodeOfLocation.end() ? -1 : static_cast<std::int64_t>(found->second);
+    }
+
+    // Per-search distances, reset through the touched list instead of refilling
+    struct SearchScratch {
+        std::vector<double> dist;
+        std::vector<std::uint32_t> touched;
+        MinQueue queue;
+
+        void reset() {
+            for (std::uint32_t node : touched) {
+                dist[node] = unreachable;
+            }
+            touched.clear();
+            queue.clear();
+        }
+
+        void prepare(std::size_t nodes) {
+            reset();
+            if (dist.size() < nodes) {
+                dist.resize(nodes, unreachable);
+            }
+        }
+    };
+
+    // One scratch pair per thread so const queries stay safe to run concurrently
+    static SearchScratch& scratch(int which) {
+        thread_local SearchScratch spaces[2];
+        return spaces[which];
+    }
+
+    // Dijkstra from source over uncontracted nodes, skipping via, settling at most limit nodes
+    static void witness(const std::vector<std::vector<Arc>>& graph, const std::vector<bool>& removed,
+                        std::uint32_t source, std::uint32_t via, double maxMiles, std::size_t limit,
+                        SearchScratch& search) {
+        search.reset();
+        MinQueue& queue = search.queue;
+        search.dist[source] = 0.0;
+        search.touched.push_back(source);
+        queue.push({ 0.0, source });
+        std::size_t settled = 0;
+        while (!queue.empty() && settled < limit) {
+            const auto [d, node] = queue.top();
+            queue.pop();
+            if (d > search.dist[node]) {
+                continue;
+            }
+            if (d > maxMiles) {
+                break;
+            }
+            ++settled;
+            for (const Arc& arc : graph[node]) {
+                if (arc.to == via || removed[arc.to]) {
+                    continue;
+                }
+                const double next = d + arc.miles;
+                if (next < search.dist[arc.to]) {
+                    if (search.dist[arc.to] == unreachable) {
+                        search.touched.push_back(arc.to);
+                    }
+                    search.dist[arc.to] = next;
+                    queue.push({ next, arc.to });
+                }
+            }
+        }
+    }
+
+    // Shortcuts needed to remove node; added to graph when apply is set
+    static std::size_t contractNode(std::vector<std::vector<Arc>>& graph, const std::vector<bool>& removed,
+                                    std::uint32_t node, std::size_t limit, SearchScratch& search, bool apply) {
+        std::vector<Arc> neighbours;
+        double longest = 0.0;
+        for (const Arc& arc : graph[node]) {
+            if (!removed[arc.to]) {
+                neighbours.push_back(arc);
+                longest = std::max(longest, arc.miles);
+            }
+        }
+        std::size_t added = 0;
+        for (const Arc& in : neighbours) {
+            witness(graph, removed, in.to, node, in.miles + longest, limit, search);
+            for (const Arc& out : neighbours) {
+                if (out.to <= in.to) {
+                    continue;   // each unordered pair once
+                }
+                const double via = in.miles + out.miles;
+                if (search.dist[out.to] <= via) {
+                    continue;
+                }
+                ++added;
+                if (apply) {
+                    relaxArc(graph[in.to], out.to, via);
+                    relaxArc(graph[out.to], in.to, via);
+                }
+            }
+        }
+        return added;
+    }
+
+    /**
+     * @brief Upward Dijkstra from source, reporting each settled node and its distance
+     * Explores the whole upward search space unless visit returns false. A node
+     * reached more cheaply through a higher-ranked neighbour is stalled: its
+     * distance is not a shortest path, so its arcs are not expanded.
+     */
+    template <typename Visit>
+    void upwardSearch(std::uint32_t source, SearchScratch& search, Visit&& visit) const {
+        search.prepare(upward.size());
+        MinQueue& queue = search.queue;
+        search.dist[source] = 0.0;
+        search.touched.push_back(source);
+        queue.push({ 0.0, source });
+        while (!queue.empty()) {
+            const auto [d, node] = queue.top();
+            queue.pop();
+            if (d > search.dist[node]) {
+                continue;
+            }
+            bool stalled = false;
+            for (const Arc& arc : upward[node]) {
+                if (search.dist[arc.to] + arc.miles < d) {
+                    stalled = true;
+                    break;
+                }
+            }
+            if (stalled) {
+                continue;
+            }
+            if (!visit(node, d)) {
+                return;
+            }
+            for (const Arc& arc : upward[node]) {
+                const double next = d + arc.miles;
+                if (next < search.dist[arc.to]) {
+                    if (search.dist[arc.to] == unreachable) {
+                        search.touched.push_back(arc.to);
+                    }
+                    search.dist[arc.to] = next;
+                    queue.push({ next, arc.to });
+                }
+            }
+        }
+    }
+
+    void requireContracted() const {
+        if (!contracted) {
+            throw std::logic_error("RoadGraph::contract() must run before distance queries");
+        }
+    }
+
+protected:
+    // Bucket many-to-many: one upward search per target, one per source
+    void computeDistances(const LocationID* from, std::size_t fromCount,
+                          const LocationID* to, std::size_t toCount, double* out) const override {
+        requireContracted();
+        std::fill(out, out + fromCount * toCount, unreachable);
+        std::unordered_map<std::uint32_t, std::vector<std::pair<std::uint32_t, double>>> buckets;
+        SearchScratch& dist = scratch(0);
+        for (std::size_t j = 0; j < toCount; ++j) {
+            const std::int64_t target = nodeOf(to[j]);
+            if (target < 0) {
+                continue;
+            }
+            upwardSearch(static_cast<std::uint32_t>(target), dist, [&](std::uint32_t node, double d) {
+                buckets[node].push_back({ static_cast<std::uint32_t>(j), d });
+                return true;
+            });
+        }
+        for (std::size_t i = 0; i < fromCount; ++i) {
+            double* line = out + i * toCount;
+            for (std::size_t j = 0; j < toCount; ++j) {
+                if (from[i] == to[j]) {
+                    line[j] = 0.0;
+                }
+            }
+            const std::int64_t source = nodeOf(from[i]);
+            if (source < 0) {
+                continue;
+            }
+            upwardSearch(static_cast<std::uint32_t>(source), dist, [&](std::uint32_t node, double d) {
+                auto bucket = buckets.find(node);
+                if (bucket != buckets.end()) {
+                    for (const auto& [j, back] : bucket->second) {
+                        line[j] = std::min(line[j], d + back);
+                    }
+                }
+                return true;
+            });
+        }
+    }
+
+public:
+    RoadGraph() : shortcuts(0), contracted(false) {}
+
+    // Two-way road of the given length; parallel roads keep the shorter one
+    void addRoad(LocationID a, LocationID b, double miles) {
+        if (!(miles > 0) || !std::isfinite(miles)) {
+            throw std::invalid_argument("Road length must be greater than 0");
+        }
+        if (a == b) {
+            throw std::invalid_argument("Road must join two different locations");
+        }
+        const std::uint32_t from = nodeFor(a);
+        const std::uint32_t to = nodeFor(b);
+        relaxArc(roads[from], to, miles);
+        relaxArc(roads[to], from, miles);
+        contracted = false;
+    }
+
+    void addRoad(const std::string& a, const std::string& b, double miles) {
+        LocationTable& table = LocationTable::global();
+        const LocationID from = table.intern(a);
+        addRoad(from, table.intern(b), miles);
+    }
+
+    /**
+     * @brief Builds the hierarchy; call again after adding roads
+     * Nodes are ordered lazily by edge difference plus removed neighbours;
+     * witnessLimit bounds each witness search, trading extra shortcuts for build time
+     */
+    void contract(std::size_t witnessLimit = 256) {
+        const std::size_t n = roads.size();
+        std::vector<std::vector<Arc>> graph = roads;
+        std::vector<bool> removed(n, false);
+        std::vector<std::size_t> removedNeighbours(n, 0);
+        SearchScratch search;
+        search.dist.assign(n, unreachable);
+        upward.assign(n, {});
+        shortcuts = 0;
+
+        auto priority = [&](std::uint32_t node) {
+            std::size_t degree = 0;
+            for (const Arc& arc : graph[node]) {
+                degree += removed[arc.to] ? 0 : 1;
+            }
+            const std::size_t added = contractNode(graph, removed, node, witnessLimit, search, false);
+            return static_cast<double>(added) - static_cast<double>(degree)
+                 + 2.0 * static_cast<double>(removedNeighbours[node]);
+        };
+
+        MinQueue order;
+        for (std::uint32_t node = 0; node < n; ++node) {
+            order.push({ priority(node), node });
+        }
+        while (!order.empty()) {
+            const std::uint32_t node = order.top().second;
+            order.pop();
+            if (removed[node]) {
+                continue;
+            }
+            const double current = priority(node);
+            if (!order.empty() && current > order.top().first) {
+                order.push({ current, node });   // stale priority; try again later
+                continue;
+            }
+            shortcuts += contractNode(graph, removed, node, witnessLimit, search, true);
+            for (const Arc& arc : graph[node]) {
+                if (!removed[arc.to]) {
+                    upward[node].push_back(arc);
+                    ++removedNeighbours[arc.to];
+                }
+            }
+            removed[node] = true;
+        }
+        contracted = true;
+    }
+
+    double distance(LocationID from, LocationID to) const override {
+        requireContracted();
+        if (from == to) {
+            return 0.0;
+        }
+        const std::int64_t source = nodeOf(from);
+        const std::int64_t target = nodeOf(to);
+        if (source < 0 || target < 0) {
+            return unreachable;
+        }
+        SearchScratch& forward = scratch(0);
+        upwardSearch(static_cast<std::uint32_t>(source), forward, [](std::uint32_t, double) { return true; });
+        double best = unreachable;
+        upwardSearch(static_cast<std::uint32_t>(target), scratch(1), [&](std::uint32_t node, double d) {
+            if (d >= best) {
+                return false;   // nothing settled later can improve on best
+            }
+            best = std::min(best, forward.dist[node] + d);
+            return true;
+        });
+        return best;
+    }
+
+    bool contains(LocationID location) const { return nodeOf(location) >= 0; }
+    bool isContracted() const { return contracted; }
+    std::size_t nodeCount() const { return roads.size(); }
+    std::size_t shortcutCount() const { return shortcuts; }
+};
+
+/**
+ * @brief TieredDistanceProvider class - matrix for frequent pairs, road graph for the rest
+ */
+class TieredDistanceProvider : public DistanceProvider {
+private:
+    const DistanceMatrix& matrix;
+    const RoadGraph& graph;
+
+protected:
+    // Positions of the matrix-covered (hot) and other (cold) locations in ids
+    void split(const LocationID* ids, std::size_t count, std::vector<std::size_t>& hot,
+               std::vector<std::size_t>& cold) const {
+        for (std::size_t i = 0; i < count; ++i) {
+            (matrix.contains(ids[i]) ? hot : cold).push_back(i);
+        }
+    }
+
+    // Computes the rows x cols sub-table with provider and scatters it into out
+    static void fill(const DistanceProvider& provider, const LocationID* from, const std::vector<std::size_t>& rows,
+                     const LocationID* to, const std::vector<std::size_t>& cols, std::size_t toCount, double* out) {
+        if (rows.empty() || cols.empty()) {
+            return;
+        }
+        std::vector<LocationID> fromIDs(rows.size());
+        std::vector<LocationID> toIDs(cols.size());
+        for (std::size_t i = 0; i < rows.size(); ++i) {
+            fromIDs[i] = from[rows[i]];
+        }
+        for (std::size_t j = 0; j < cols.size(); ++j) {
+            toIDs[j] = to[cols[j]];
+        }
+        std::vector<double> table;
+        provider.distances(fromIDs, toIDs, table);
+        for (std::size_t i = 0; i < rows.size(); ++i) {
+            for (std::size_t j = 0; j < cols.size(); ++j) {
+                out[rows[i] * toCount + cols[j]] = table[i * cols.size() + j];
+            }
+        }
+    }
+
+    // Same answer per cell as distance(): hot x hot from the matrix, any pair with a cold end from the graph
+    void computeDistances(const LocationID* from, std::size_t fromCount,
+                          const LocationID* to, std::size_t toCount, double* out) const override {
+        std::vector<std::size_t> hotRows, coldRows, hotCols, coldCols;
+        split(from, fromCount, hotRows, coldRows);
+        split(to, toCount, hotCols, coldCols);
+        if (coldRows.empty() && coldCols.empty()) {
+            matrix.distances(from, fromCount, to, toCount, out);
+            return;
+        }
+        if (hotRows.empty() || hotCols.empty()) {
+            graph.distances(from, fromCount, to, toCount, out);
+            return;
+        }
+        std::vector<std::size_t> allCols(toCount);
+        for (std::size_t j = 0; j < toCount; ++j) {
+            allCols[j] = j;
+        }
+        fill(matrix, from, hotRows, to, hotCols, toCount, out);
+        fill(graph, from, hotRows, to, coldCols, toCount, out);
+        fill(graph, from, coldRows, to, allCols, toCount, out);
+    }
+
+public:
+    TieredDistanceProvider(const DistanceMatrix& matrix, const RoadGraph& graph)
+        : matrix(matrix), graph(graph) {}
+
+    double distance(LocationID from, LocationID to) const override {
+        if (matrix.contains(from) && matrix.contains(to)) {
+            return matrix.distance(from, to);
+        }
+        return graph.distance(from, to);
+    }
+};
+
+/**
+ * @brief Creates a ride whose distance comes from the provider
+ * Throws std::invalid_argument when there is no route between the two locations
+ */
+template <typename T>
+RideIndex createRide(RideRegistry& registry, const DistanceProvider& provider,
+                     int id, LocationID pickup, LocationID dropoff) {
+    const double miles = provider.distance(pickup, dropoff);
+    if (!std::isfinite(miles)) {
+        throw std::invalid_argument("No route between pickup and dropoff");
+    }
+    return registry.create<T>(id, pickup, dropoff, miles);
+}
+
+template <typename T>
+RideIndex createRide(RideRegistry& registry, const DistanceProvider& provider,
+                     int id, std::string_view pickup, std::string_view dropoff) {
+    LocationTable& table = LocationTable::global();
+    const LocationID pickupID = table.intern(pickup);
+    return createRide<T>(registry, provider, id, pickupID, table.intern(dropoff));
+}
+
+#endif // RIDE_SHARING_DISTANCE_PROVIDER_H
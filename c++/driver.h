@@ -0,0 +1,146 @@
+#ifndef RIDE_SHARING_DRIVER_H
+#define RIDE_SHARING_DRIVER_H
+
+#include <iostream>
+#include <vector>
+#include <string>
+#include <utility>
+#include <iomanip>
+#include <stdexcept>
+
+#include "ride.h"
+#include "ride_registry.h"
+#include "text_format.h"
+#include "ride_stats.h"
+#include "ride_timeline.h"
+#include "validation.h"
+#include "metrics.h"
+
+/**
+ * @brief Driver class - demonstrates encapsulation
+ * Keeps driver details private and provides public methods for access
+ */
+class Driver {
+private:
+    int driverID;
+    std::string name;
+    double rating;
+    const RideRegistry* rideTable;
+    std::vector<RideIndex> assignedRides;
+    RideStats stats;
+    RideTimeline timeline;
+
+public:
+    // name is taken by value so temporaries are moved in rather than copied
+    Driver(int id, std::string name, double rating,
+           const RideRegistry& rides = RideRegistry::global())
+        : driverID(id), name(std::move(name)), rating(rating), rideTable(&rides), timeline(rides) {
+        if (validateRating(rating) != ValidationError::None) {
+            throw std::invalid_argument(validationMessage(ValidationError::InvalidRating));
+        }
+    }
+
+    static ValidationError validateRating(double rating) {
+        return rating >= 0 && rating <= 5 ? ValidationError::None : ValidationError::InvalidRating;
+    }
+
+    // Non-throwing factory; rejects the rating before any Driver is built
+    static Result<Driver> tryCreate(int id, std::string name, double rating,
+                                    const RideRegistry& rides = RideRegistry::global()) {
+        const ValidationError error = validateRating(rating);
+        if (error != ValidationError::None) {
+            return Result<Driver>::rejected(error);
+        }
+        return Driver(id, std::move(name), rating, rides);
+    }
+
+    void addRide(RideIndex ride) { addRide(ride, currentTimestamp()); }
+
+    // Also reserves the timeline bucket of timestamp, so a batch recorded then does not allocate
+    void reserveRides(std::size_t count, std::int64_t timestamp = currentTimestamp()) {
+        assignedRides.reserve(assignedRides.size() + count);
+        timeline.reserve(count, timestamp);
+    }
+
+    // Same as addRide, reporting an unknown index instead of throwing
+    ValidationError tryAddRide(RideIndex ride, std::int64_t timestamp = currentTimestamp()) {
+        RIDE_METRICS_TIME(AddRide);
+        if (!rideTable->contains(ride)) {
+            return ValidationError::InvalidRideIndex;
+        }
+        assignedRides.push_back(ride);
+        const Ride& recorded = rideTable->get(ride);
+        stats.record(recorded, timestamp);
+        timeline.record(timestamp, ride, recorded.getFare(), recorded.getDistance());
+        RIDE_METRICS_COUNT(RidesAssigned, 1);
+        return ValidationError::None;
+    }
+
+    // timestamp (Unix seconds) places the ride in the rolling hour/day windows
+    void addRide(RideIndex ride, std::int64_t timestamp) {
+        const ValidationError error = tryAddRide(ride, timestamp);
+        if (error != ValidationError::None) {
+            throw std::invalid_argument(validationMessage(error));
+        }
+    }
+
+    /**
+     * @brief Builds a ride in place in registry, prices it and assigns it
+     * registry must be the one this driver was created with; the ride is
+     * constructed directly in its pool, with no temporary Ride or name copies
+     */
+    template <typename T, typename... Args>
+    RideIndex emplaceRide(RideRegistry& registry, Args&&... args) {
+        if (&registry != rideTable) {
+            throw std::invalid_argument("Ride registry does not belong to this driver");
+        }
+        const RideIndex ride = registry.create<T>(std::forward<Args>(args)...);
+        const std::int64_t now = currentTimestamp();
+        Ride& created = registry[ride];
+        created.calculateFare();
+        created.markCompleted(now);
+        assignedRides.push_back(ride);
+        stats.record(created, now);
+        timeline.record(now, ride, created.getFare(), created.getDistance());
+        RIDE_METRICS_COUNT(RidesAssigned, 1);
+        return ride;
+    }
+
+    void getDriverInfo() const {
+        std::cout << "Driver ID: " << driverID
+                  << "\nName: " << name
+                  << "\nRating: " << std::fixed << std::setprecision(2) << rating
+                  << "\nCompleted Rides: " << assignedRides.size()
+                  << "\nTotal Earnings: $" << stats.getTotalFare() << std::endl;
+    }
+
+    // Appends the same text to out without touching std::cout
+    void getDriverInfo(std::string& out) const {
+        out += "Driver ID: ";
+        appendInt(out, driverID);
+        out += "\nName: ";
+        out += name;
+        out += "\nRating: ";
+        appendFixed2(out, rating);
+        out += "\nCompleted Rides: ";
+        appendInt(out, static_cast<long long>(assignedRides.size()));
+        out += "\nTotal Earnings: $";
+        appendFixed2(out, stats.getTotalFare());
+        out += '\n';
+    }
+
+    int getDriverID() const { return driverID; }
+    const std::string& getName() const { return name; }
+    double getRating() const { return rating; }
+    const std::vector<RideIndex>& getAssignedRides() const { return assignedRides; }
+    const RideRegistry& getRideRegistry() const { return *rideTable; }
+    const RideStats& getStats() const { return stats; }
+
+    // Assigned rides by time, for range queries such as the last 30 days
+    const RideTimeline& getTimeline() const { return timeline; }
+
+    // Drops per-ride timeline entries older than cutoff, keeping their bucket totals
+    std::size_t compactTimelineBefore(std::int64_t cutoff) { return timeline.compactBefore(cutoff); }
+};
+
+#endif // RIDE_SHARING_DRIVER_H
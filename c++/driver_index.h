@@ -0,0 +1,284 @@
+#ifndef RIDE_SHARING_DRIVER_INDEX_H
+#define RIDE_SHARING_DRIVER_INDEX_H
+
+#include <vector>
+#include <unordered_map>
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+
+#include "geo.h"
+#include "driver.h"
+#include "metrics.h"
+
+/**
+ * @brief Candidate returned by a nearest-driver query
+ * score is the distance inflated by the rating penalty; lower is better
+ */
+struct DriverMatch {
+    int driverID;
+    double distanceKm;
+    double score;
+    double rating;
+};
+
+/**
+ * @brief DriverIndex class - uniform lat/lon grid over driver positions
+ * Answers k-nearest-available-driver queries by searching rings of cells
+ * outward from the pickup, and moves a driver between cells only when a
+ * position update actually crosses a cell boundary
+ */
+class DriverIndex {
+public:
+    static constexpr double defaultCellDegrees = 0.01;   // roughly 1 km
+    static constexpr double defaultRatingWeight = 0.5;   // a 0-star driver costs 1.5x distance
+
+private:
+    struct CellEntry {
+        std::uint32_t slot;
+        GeoPoint position;
+    };
+
+    struct Entry {
+        int driverID;
+        double rating;
+        bool available;
+        std::uint64_t cell;
+        std::uint32_t cellIndex;   // position in cells[cell]
+        GeoPoint position;
+    };
+
+    double cellDegrees;
+    double ratingWeight;
+    std::vector<Entry> entries;
+    std::vector<std::uint32_t> freeSlots;
+    std::unordered_map<int, std::uint32_t> slots;
+    std::unordered_map<std::uint64_t, std::vector<CellEntry> > cells;
+    std::size_t availableCount;
+
+    std::int32_t cellCoord(double degrees) const {
+        return static_cast<std::int32_t>(std::floor(degrees / cellDegrees));
+    }
+
+    static std::uint64_t cellKey(std::int32_t latCell, std::int32_t lonCell) {
+        return (static_cast<std::uint64_t>(static_cast<std::uint32_t>(latCell)) << 32)
+             | static_cast<std::uint32_t>(lonCell);
+    }
+
+    std::uint64_t cellOf(const GeoPoint& p) const {
+        return cellKey(cellCoord(p.lat), cellCoord(p.lon));
+    }
+
+    double ratingPenalty(double rating) const {
+        return 1.0 + ratingWeight * (5.0 - rating) / 5.0;
+    }
+
+    void insertIntoCell(std::uint32_t slot) {
+        Entry& entry = entries[slot];
+        auto& cell = cells[entry.cell];
+        entry.cellIndex = static_cast<std::uint32_t>(cell.size());
+        cell.push_back(CellEntry{ slot, entry.position });
+    }
+
+    // Swap-and-pop removal keeps cells dense
+    void removeFromCell(std::uint32_t slot) {
+        Entry& entry = entries[slot];
+        auto it = cells.find(entry.cell);
+        auto& cell = it->second;
+        const std::uint32_t index = entry.cellIndex;
+        cell[index] = cell.back();
+        entries[cell[index].slot].cellIndex = index;
+        cell.pop_back();
+        if (cell.empty()) {
+            cells.erase(it);
+        }
+    }
+
+    void validateRating(double rating) const {
+        if (rating < 0 || rating > 5) {
+            throw std::invalid_argument("Rating must be between 0 and 5");
+        }
+    }
+
+public:
+    explicit DriverIndex(double cellDegrees = defaultCellDegrees, double ratingWeight = defaultRatingWeight)
+        : cellDegrees(cellDegrees), ratingWeight(ratingWeight), availableCount(0) {
+        if (cellDegrees <= 0) {
+            throw std::invalid_argument("Cell size must be greater than 0");
+        }
+        if (ratingWeight < 0) {
+            throw std::invalid_argument("Rating weight must not be negative");
+        }
+    }
+
+    /**
+     * @brief Inserts a driver or moves an existing one
+     * Same-cell moves only rewrite the stored position
+     */
+    void updatePosition(int driverID, double rating, const GeoPoint& position) {
+        validateRating(rating);
+        auto found = slots.find(driverID);
+        if (found == slots.end()) {
+            std::uint32_t slot;
+            if (freeSlots.empty()) {
+                slot = static_cast<std::uint32_t>(entries.size());
+                entries.push_back(Entry());
+            } else {
+                slot = freeSlots.back();
+                freeSlots.pop_back();
+            }
+            entries[slot] = Entry{ driverID, rating, true, cellOf(position), 0, position };
+            slots.emplace(driverID, slot);
+            insertIntoCell(slot);
+            ++availableCount;
+            return;
+        }
+
+        const std::uint32_t slot = found->second;
+        Entry& entry = entries[slot];
+        entry.rating = rating;
+        const std::uint64_t cell = cellOf(position);
+        if (cell == entry.cell) {
+            entry.position = position;
+            cells[cell][entry.cellIndex].position = position;
+            return;
+        }
+        removeFromCell(slot);
+        entry.cell = cell;
+        entry.position = position;
+        insertIntoCell(slot);
+    }
+
+    void updatePosition(const Driver& driver, const GeoPoint& position) {
+        updatePosition(driver.getDriverID(), driver.getRating(), position);
+    }
+
+    void setAvailable(int driverID, bool available) {
+        auto found = slots.find(driverID);
+        if (found == slots.end()) {
+            throw std::invalid_argument("Unknown driver");
+        }
+        Entry& entry = entries[found->second];
+        if (entry.available != available) {
+            entry.available = available;
+            if (available) {
+                ++availableCount;
+            } else {
+                --availableCount;
+            }
+        }
+    }
+
+    void remove(int driverID) {
+        auto found = slots.find(driverID);
+        if (found == slots.end()) {
+            return;
+        }
+        const std::uint32_t slot = found->second;
+        removeFromCell(slot);
+        if (entries[slot].available) {
+            --availableCount;
+        }
+        freeSlots.push_back(slot);
+        slots.erase(found);
+    }
+
+    bool contains(int driverID) const { return slots.count(driverID) != 0; }
+
+    bool getPosition(int driverID, GeoPoint& position) const {
+        auto found = slots.find(driverID);
+        if (found == slots.end()) {
+            return false;
+        }
+        position = entries[found->second].position;
+        return true;
+    }
+
+    std::size_t size() const { return slots.size(); }
+    std::size_t availableSize() const { return availableCount; }
+
+    /**
+     * @brief Returns up to k available drivers with the lowest rating-weighted distance
+     * Rings are searched until no unvisited cell can beat the current k-th score
+     * (score >= distance, so the ring's minimum distance is a safe bound),
+     * every available driver has been seen, or maxRadiusKm is exceeded.
+     */
+    std::vector<DriverMatch> nearestAvailable(const GeoPoint& pickup, std::size_t k,
+                                              double maxRadiusKm = 50.0) const {
+        RIDE_METRICS_TIME(DriverMatch);
+        RIDE_METRICS_COUNT(DriverMatches, 1);
+        std::vector<DriverMatch> best;
+        if (k == 0 || availableCount == 0) {
+            return best;
+        }
+        best.reserve(k + 1);
+
+        std::size_t seenAvailable = 0;
+        auto byScore = [](const DriverMatch& a, const DriverMatch& b) { return a.score < b.score; };
+        auto consider = [&](const CellEntry& candidate) {
+            const Entry& entry = entries[candidate.slot];
+            if (!entry.available) {
+                return;
+            }
+            ++seenAvailable;
+            const double dist = distanceKm(pickup, candidate.position);
+            if (dist > maxRadiusKm) {
+                return;
+            }
+            const double score = dist * ratingPenalty(entry.rating);
+            if (best.size() == k && score >= best.back().score) {
+                return;
+            }
+            DriverMatch match{ entry.driverID, dist, score, entry.rating };
+            best.insert(std::upper_bound(best.begin(), best.end(), match, byScore), match);
+            if (best.size() > k) {
+                best.pop_back();
+            }
+        };
+        auto visit = [&](std::int32_t latCell, std::int32_t lonCell) {
+            auto it = cells.find(cellKey(latCell, lonCell));
+            if (it == cells.end()) {
+                return;
+            }
+            for (const CellEntry& candidate : it->second) {
+                consider(candidate);
+            }
+        };
+
+        const std::int32_t centerLat = cellCoord(pickup.lat);
+        const std::int32_t centerLon = cellCoord(pickup.lon);
+        for (std::int32_t ring = 0; ; ++ring) {
+            if (ring == 0) {
+                visit(centerLat, centerLon);
+            } else {
+                for (std::int32_t d = -ring; d <= ring; ++d) {
+                    visit(centerLat - ring, centerLon + d);
+                    visit(centerLat + ring, centerLon + d);
+                }
+                for (std::int32_t d = -ring + 1; d <= ring - 1; ++d) {
+                    visit(centerLat + d, centerLon - ring);
+                    visit(centerLat + d, centerLon + ring);
+                }
+            }
+
+            // Any point outside rings 0..ring is at least `ring` cell widths away
+            const double edgeLat = std::min(90.0, std::fabs(pickup.lat) + (ring + 1) * cellDegrees);
+            const double cellKm = cellDegrees * kmPerDegree * std::cos(degreesToRadians(edgeLat));
+            const double nextRingKm = ring * cellKm;
+            if (nextRingKm > maxRadiusKm || cellKm <= 0) {
+                break;
+            }
+            if (best.size() == k && nextRingKm >= best.back().score) {
+                break;
+            }
+            if (seenAvailable == availableCount) {
+                break;
+            }
+        }
+        return best;
+    }
+};
+
+#endif // RIDE_SHARING_DRIVER_INDEX_H
@@ -0,0 +1,302 @@
+#ifndef RIDE_SHARING_DRIVER_LOCATIONS_H
+#define RIDE_SHARING_DRIVER_LOCATIONS_H
+
+#include <atomic>
+#include <memory>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+
+#include "cache_line.h"
+#include "geo.h"
+#include "driver_index.h"
+#include "flat_id_table.h"
+#include "mpmc_queue.h"
+
+/**
+ * @brief Consistent copy of one driver's streamed state
+ * version is even and grows with every accepted ping
+ */
+struct DriverLocation {
+    int driverID;
+    double rating;
+    GeoPoint position;
+    bool available;           // as last streamed by the driver
+    bool assigned;            // claimed by a matcher; never indexed as available while set
+    std::int64_t timestamp;   // sender's clock, e.g. Unix milliseconds
+    std::uint32_t version;
+};
+
+/**
+ * @brief DriverLocationTable class - live driver positions and availability
+ *
+ * Each driver owns one cache line guarded by a sequence counter. A writer takes
+ * the line by moving the counter from even to odd with a compare-and-swap, so
+ * pings for different drivers never contend; readers copy the fields and retry
+ * only if the counter moved, so matcher threads never block ingestion.
+ * The first ping after a flush queues the driver once; flushTo() then applies the
+ * latest state of each queued driver to a DriverIndex, so a driver pinging every
+ * few seconds moves between grid cells at most once per flush.
+ * A driver app keeps reporting itself available until it hears about its trip,
+ * so a matcher that takes a driver claim()s it here: flushTo() then indexes the
+ * driver as unavailable whatever its pings say, until release().
+ * Drivers must be registered before pings for them are streamed.
+ */
+class DriverLocationTable {
+private:
+    struct alignas(cacheLineSize) Slot {
+        std::atomic<std::uint32_t> sequence{0};
+        std::atomic<bool> queued{false};
+        std::atomic<bool> available{false};
+        std::atomic<bool> assigned{false};
+        std::atomic<std::uint64_t> latBits{0};
+        std::atomic<std::uint64_t> lonBits{0};
+        std::atomic<std::int64_t> timestamp{0};
+        int driverID = 0;
+        double rating = 0.0;
+    };
+
+    struct Entry {
+        int id;
+        std::uint32_t slot;
+    };
+
+    std::unique_ptr<Slot[]> slots;
+    std::size_t capacity;
+    std::size_t registered;
+    FlatIdTable<Entry> byID;
+    MpmcQueue<std::uint32_t> dirty;
+    std::atomic<std::uint64_t> pings{0};
+    std::atomic<std::uint64_t> stale{0};
+
+    static std::uint64_t toBits(double value) {
+        std::uint64_t bits;
+        std::memcpy(&bits, &value, sizeof(bits));
+        return bits;
+    }
+
+    static double fromBits(std::uint64_t bits) {
+        double value;
+        std::memcpy(&value, &bits, sizeof(value));
+        return value;
+    }
+
+    std::uint32_t slotOf(int driverID) const {
+        const Entry* entry = byID.find(driverID);
+        if (entry == nullptr) {
+            throw std::invalid_argument("Unknown driver ID");
+        }
+        return entry->slot;
+    }
+
+    // Takes the slot from even to odd; concurrent writers of one driver spin here briefly
+    static std::uint32_t beginWrite(Slot& slot) {
+        std::uint32_t sequence = slot.sequence.load(std::memory_order_relaxed);
+        for (;;) {
+            if ((sequence & 1u) == 0
+                && slot.sequence.compare_exchange_weak(sequence, sequence + 1, std::memory_order_acquire,
+                                                       std::memory_order_relaxed)) {
+                break;
+            }
+            sequence = slot.sequence.load(std::memory_order_relaxed);
+        }
+        std::atomic_thread_fence(std::memory_order_release);
+        return sequence;
+    }
+
+    static void endWrite(Slot& slot, std::uint32_t sequence) {
+        slot.sequence.store(sequence + 2, std::memory_order_release);
+    }
+
+    Slot& checkedSlot(std::uint32_t slotIndex) {
+        if (slotIndex >= registered) {
+            throw std::invalid_argument("Invalid driver slot");
+        }
+        return slots[slotIndex];
+    }
+
+    void markDirty(std::uint32_t slotIndex) {
+        Slot& slot = slots[slotIndex];
+        // Pairs with the fence in flush(): either the flusher's read sees this ping or we see queued cleared
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (!slot.queued.load(std::memory_order_relaxed) && !slot.queued.exchange(true, std::memory_order_acq_rel)) {
+            // Each slot is queued at most once and the queue holds every slot, so this cannot fail
+            dirty.tryPush(slotIndex);
+        }
+    }
+
+    /**
+     * @brief Takes the slot for a ping stamped timestamp, or returns false for a stale one
+     * The age check runs under the write side so racing pings cannot land out of order;
+     * a rejected ping restores the old sequence since nothing changed
+     */
+    bool beginPing(Slot& slot, std::int64_t timestamp, std::uint32_t& sequence) {
+        pings.fetch_add(1, std::memory_order_relaxed);
+        sequence = beginWrite(slot);
+        if (timestamp < slot.timestamp.load(std::memory_order_relaxed)) {
+            slot.sequence.store(sequence, std::memory_order_release);
+            stale.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+        return true;
+    }
+
+public:
+    explicit DriverLocationTable(std::size_t maxDrivers)
+        : slots(new Slot[maxDrivers]), capacity(maxDrivers), registered(0), byID(maxDrivers),
+          dirty(maxDrivers == 0 ? 1 : maxDrivers) {
+        if (maxDrivers == 0) {
+            throw std::invalid_argument("Driver capacity must be greater than 0");
+        }
+    }
+
+    DriverLocationTable(const DriverLocationTable&) = delete;
+    DriverLocationTable& operator=(const DriverLocationTable&) = delete;
+
+    /**
+     * @brief Adds a driver, initially unavailable at position; returns its slot
+     * Not thread-safe: register drivers before streaming pings
+     */
+    std::uint32_t registerDriver(int driverID, double rating, const GeoPoint& position = GeoPoint{ 0.0, 0.0 }) {
+        if (rating < 0 || rating > 5) {
+            throw std::invalid_argument("Rating must be between 0 and 5");
+        }
+        if (registered == capacity) {
+            throw std::length_error("Driver location table is full");
+        }
+        const std::uint32_t slot = static_cast<std::uint32_t>(registered);
+        if (byID.insert(Entry{ driverID, slot }) == nullptr) {
+            throw std::invalid_argument("Driver ID is already registered");
+        }
+        ++registered;
+        slots[slot].driverID = driverID;
+        slots[slot].rating = rating;
+        slots[slot].latBits.store(toBits(position.lat), std::memory_order_relaxed);
+        slots[slot].lonBits.store(toBits(position.lon), std::memory_order_relaxed);
+        return slot;
+    }
+
+    std::uint32_t registerDriver(const Driver& driver, const GeoPoint& position = GeoPoint{ 0.0, 0.0 }) {
+        return registerDriver(driver.getDriverID(), driver.getRating(), position);
+    }
+
+    /**
+     * @brief Records a GPS ping; safe from any number of threads
+     * Pings older than the stored timestamp are dropped (out-of-order delivery),
+     * and false is returned for them
+     */
+    bool update(std::uint32_t slotIndex, const GeoPoint& position, bool available, std::int64_t timestamp) {
+        Slot& slot = checkedSlot(slotIndex);
+        std::uint32_t sequence;
+        if (!beginPing(slot, timestamp, sequence)) {
+            return false;
+        }
+        slot.latBits.store(toBits(position.lat), std::memory_order_relaxed);
+        slot.lonBits.store(toBits(position.lon), std::memory_order_relaxed);
+        slot.available.store(available, std::memory_order_relaxed);
+        slot.timestamp.store(timestamp, std::memory_order_relaxed);
+        endWrite(slot, sequence);
+        markDirty(slotIndex);
+        return true;
+    }
+
+    bool update(int driverID, const GeoPoint& position, bool available, std::int64_t timestamp) {
+        return update(slotOf(driverID), position, available, timestamp);
+    }
+
+    // Availability change without a new position, e.g. a trip starting; keeps the last streamed position
+    bool setAvailable(int driverID, bool available, std::int64_t timestamp) {
+        const std::uint32_t slotIndex = slotOf(driverID);
+        Slot& slot = slots[slotIndex];
+        std::uint32_t sequence;
+        if (!beginPing(slot, timestamp, sequence)) {
+            return false;
+        }
+        slot.available.store(available, std::memory_order_relaxed);
+        slot.timestamp.store(timestamp, std::memory_order_relaxed);
+        endWrite(slot, sequence);
+        markDirty(slotIndex);
+        return true;
+    }
+
+    /**
+     * @brief Marks the driver as taken by a matcher; false if already claimed
+     * The next flush indexes the driver as unavailable, and no later ping can
+     * raise it again until release()
+     */
+    bool claim(int driverID) {
+        const std::uint32_t slotIndex = slotOf(driverID);
+        if (slots[slotIndex].assigned.exchange(true, std::memory_order_acq_rel)) {
+            return false;
+        }
+        markDirty(slotIndex);
+        return true;
+    }
+
+    // Ends a claim; the next flush applies the driver's streamed availability again
+    void release(int driverID) {
+        const std::uint32_t slotIndex = slotOf(driverID);
+        slots[slotIndex].assigned.store(false, std::memory_order_release);
+        markDirty(slotIndex);
+    }
+
+    // Lock-free consistent read; never blocks writers
+    DriverLocation read(std::uint32_t slotIndex) const {
+        const Slot& slot = const_cast<DriverLocationTable*>(this)->checkedSlot(slotIndex);
+        for (;;) {
+            const std::uint32_t before = slot.sequence.load(std::memory_order_acquire);
+            if ((before & 1u) != 0) {
+                continue;   // writer mid-update
+            }
+            const std::uint64_t lat = slot.latBits.load(std::memory_order_relaxed);
+            const std::uint64_t lon = slot.lonBits.load(std::memory_order_relaxed);
+            const bool available = slot.available.load(std::memory_order_relaxed);
+            const std::int64_t timestamp = slot.timestamp.load(std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (slot.sequence.load(std::memory_order_relaxed) != before) {
+                continue;
+            }
+            // Claims are not sequenced with pings; acquire pairs with release()
+            const bool assigned = slot.assigned.load(std::memory_order_acquire);
+            return DriverLocation{ slot.driverID, slot.rating, GeoPoint{ fromBits(lat), fromBits(lon) },
+                                   available, assigned, timestamp, before };
+        }
+    }
+
+    DriverLocation read(int driverID) const { return read(slotOf(driverID)); }
+
+    /**
+     * @brief Calls apply(const DriverLocation&) once for every driver pinged since the last flush
+     * Only one thread may flush at a time. A ping racing with the flush either
+     * makes this flush or re-queues its driver for the next one; at most size()
+     * drivers are applied per call so busy writers cannot keep a flush running.
+     */
+    template <typename Apply>
+    std::size_t flush(Apply&& apply) {
+        std::size_t applied = 0;
+        std::uint32_t slotIndex;
+        while (applied < registered && dirty.tryPop(slotIndex)) {
+            slots[slotIndex].queued.store(false, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            apply(read(slotIndex));
+            ++applied;
+        }
+        return applied;
+    }
+
+    // Moves every changed driver in index: one updatePosition/setAvailable per driver per flush; claimed drivers stay unavailable
+    std::size_t flushTo(DriverIndex& index) {
+        return flush([&index](const DriverLocation& location) {
+            index.updatePosition(location.driverID, location.rating, location.position);
+            index.setAvailable(location.driverID, location.available && !location.assigned);
+        });
+    }
+
+    std::size_t size() const { return registered; }
+    std::uint64_t pingCount() const { return pings.load(std::memory_order_relaxed); }
+    std::uint64_t stalePingCount() const { return stale.load(std::memory_order_relaxed); }
+};
+
+#endif // RIDE_SHARING_DRIVER_LOCATIONS_H
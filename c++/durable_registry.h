@@ -0,0 +1,513 @@
+#ifndef RIDE_SHARING_DURABLE_REGISTRY_H
+#define RIDE_SHARING_DURABLE_REGISTRY_H
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <fstream>
+#include <unordered_map>
+#include <filesystem>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <system_error>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "ride.h"
+#include "driver.h"
+#include "rider.h"
+#include "ride_registry.h"
+#include "location_table.h"
+#include "ride_binary.h"
+#include "write_ahead_log.h"
+
+/**
+ * @brief DurableRegistry class - rides, drivers and riders backed by snapshot + WAL
+ *
+ * The directory holds snapshot-<G>.bin (ride_binary format) and wal-<G>.log,
+ * the changes made since that snapshot. Recovery loads the newest complete
+ * snapshot and replays its log tail. Mutations are logged when they are made
+ * but only become durable at commit(), so a batch of rides costs one fsync.
+ * Mutators validate, log, then apply; createRide() builds the ride before
+ * logging it, since the record carries the computed fare, but only once
+ * validation has shown it cannot be rejected. Replay applies each entry exactly
+ * as it was applied live, timestamps included, and ends the valid log at an
+ * entry whose payload is too short for its kind. Mutators are meant for a single
+ * writer thread; commit() may be called from any thread and joins the
+ * in-flight group commit.
+ */
+class DurableRegistry {
+public:
+    struct RecoveryStats {
+        std::uint64_t generation = 0;
+        std::uint64_t snapshotRides = 0;
+        std::uint64_t replayedEntries = 0;
+    };
+
+private:
+    std::filesystem::path directory;
+    std::uint64_t snapshotInterval;
+
+    RideRegistry rides;
+    std::vector<Driver> drivers;
+    std::vector<Rider> riders;
+    std::unordered_map<int, std::size_t> driverSlots;
+    std::unordered_map<int, std::size_t> riderSlots;
+    std::vector<bool> inHistory;   // ride is in some driver's or rider's stats, so its fare is final
+
+    std::unique_ptr<WriteAheadLog> wal;
+    std::uint64_t generation;
+    std::uint64_t entriesSinceSnapshot;
+    RecoveryStats recovery;
+
+    // Log-local location IDs, so each log is self-describing without the snapshot's table
+    std::unordered_map<LocationID, std::uint32_t> liveToLog;
+    std::vector<LocationID> logToLive;
+
+    std::filesystem::path snapshotPath(std::uint64_t gen) const {
+        return directory / ("snapshot-" + std::to_string(gen) + ".bin");
+    }
+
+    std::filesystem::path logPath(std::uint64_t gen) const {
+        return directory / ("wal-" + std::to_string(gen) + ".log");
+    }
+
+    static void syncPath(const std::filesystem::path& path, int flags) {
+        const int fd = ::open(path.c_str(), flags);
+        if (fd < 0) {
+            throw std::system_error(errno, std::generic_category(), "Failed to open " + path.string());
+        }
+        const int rc = ::fsync(fd);
+        ::close(fd);
+        if (rc != 0) {
+            throw std::system_error(errno, std::generic_category(), "Failed to sync " + path.string());
+        }
+    }
+
+    std::size_t driverSlot(int driverID) const {
+        auto it = driverSlots.find(driverID);
+        if (it == driverSlots.end()) {
+            throw std::invalid_argument("Unknown driver ID");
+        }
+        return it->second;
+    }
+
+    std::size_t riderSlot(int riderID) const {
+        auto it = riderSlots.find(riderID);
+        if (it == riderSlots.end()) {
+            throw std::invalid_argument("Unknown rider ID");
+        }
+        return it->second;
+    }
+
+    void log(WriteAheadLog::EntryKind kind, const unsigned char* payload, std::size_t size) {
+        wal->append(kind, payload, size);
+        ++entriesSinceSnapshot;
+    }
+
+    std::uint32_t logLocation(LocationID id) {
+        auto it = liveToLog.find(id);
+        if (it != liveToLog.end()) {
+            return it->second;
+        }
+        const std::uint32_t logID = static_cast<std::uint32_t>(logToLive.size());
+        const std::string& name = LocationTable::global().name(id);
+        std::vector<unsigned char> payload(4 + name.size());
+        ride_binary::detail::storeLE<std::uint32_t>(payload.data(), logID);
+        name.copy(reinterpret_cast<char*>(payload.data() + 4), name.size());
+        log(WriteAheadLog::EntryKind::Location, payload.data(), payload.size());
+        liveToLog.emplace(id, logID);
+        logToLive.push_back(id);
+        return logID;
+    }
+
+    static std::string payloadName(const unsigned char* data, std::size_t size) {
+        return std::string(reinterpret_cast<const char*>(data), size);
+    }
+
+    // The slot is added only once the object exists, so a throwing constructor leaves no dangling slot
+    void insertDriver(int driverID, const std::string& name, double rating) {
+        drivers.emplace_back(driverID, name, rating, rides);
+        driverSlots.emplace(driverID, drivers.size() - 1);
+    }
+
+    void insertRider(int riderID, const std::string& name) {
+        riders.emplace_back(riderID, name, rides);
+        riderSlots.emplace(riderID, riders.size() - 1);
+    }
+
+    // Smallest payload each entry kind can decode from; see WriteAheadLog::EntryKind
+    static std::size_t minimumPayload(WriteAheadLog::EntryKind kind) {
+        switch (kind) {
+            case WriteAheadLog::EntryKind::Location: return 4;
+            case WriteAheadLog::EntryKind::AddDriver: return 12;
+            case WriteAheadLog::EntryKind::AddRider: return 4;
+            case WriteAheadLog::EntryKind::CreateRide: return ride_binary::rideRecordSize;
+            case WriteAheadLog::EntryKind::AssignRide: return 8;
+            case WriteAheadLog::EntryKind::RequestRide: return 8;
+            case WriteAheadLog::EntryKind::SetFare: return 12;
+        }
+        return 0;
+    }
+
+    RideIndex insertRide(int rideID, LocationID pickup, LocationID dropoff, double distance, RideType type) {
+        RideIndex ride;
+        switch (type) {
+            case RideType::Standard:
+                ride = rides.create<StandardRide>(rideID, pickup, dropoff, distance);
+                break;
+            case RideType::Premium:
+                ride = rides.create<PremiumRide>(rideID, pickup, dropoff, distance);
+                break;
+            case RideType::Pooled:
+                ride = rides.create<PooledRide>(rideID, pickup, dropoff, distance);
+                break;
+            default:
+                throw std::invalid_argument("Invalid ride type");
+        }
+        inHistory.push_back(false);
+        return ride;
+    }
+
+    // The ride keeps its first completion and request times, so snapshots restore histories at them
+    void applyAssign(std::size_t slot, RideIndex ride, std::int64_t timestamp) {
+        if (rides[ride].getCompletedAt() == 0) {
+            rides[ride].markCompleted(timestamp);
+        }
+        drivers[slot].addRide(ride, timestamp);
+        inHistory[ride] = true;
+    }
+
+    void applyRequest(std::size_t slot, RideIndex ride, std::int64_t timestamp) {
+        if (rides[ride].getRequestedAt() == 0) {
+            rides[ride].markRequested(timestamp);
+        }
+        riders[slot].requestRide(ride, timestamp);
+        inHistory[ride] = true;
+    }
+
+    RideIndex loggedRide(std::uint32_t ride) const {
+        if (!rides.contains(ride)) {
+            throw std::runtime_error("Write-ahead log references an unknown ride");
+        }
+        return ride;
+    }
+
+    // Logs written before timestamps carry none; fall back to the ride's own
+    static std::int64_t loggedTimestamp(const unsigned char* data, std::size_t size, std::int64_t rideTime) {
+        if (size >= 16) {
+            return ride_binary::detail::loadLE<std::int64_t>(data + 8);
+        }
+        return rideTime != 0 ? rideTime : currentTimestamp();
+    }
+
+    void loadSnapshot(std::uint64_t gen) {
+        std::ifstream in(snapshotPath(gen), std::ios::binary);
+        if (!in) {
+            throw std::runtime_error("Failed to open snapshot " + snapshotPath(gen).string());
+        }
+        ride_binary::Reader reader(in);
+        ride_binary::SectionHeader header;
+        while (reader.nextSection(header)) {
+            switch (header.kind) {
+                case ride_binary::SectionKind::Locations:
+                    reader.readLocations(LocationTable::global());
+                    break;
+                case ride_binary::SectionKind::Rides:
+                    reader.readRides(rides);
+                    break;
+                case ride_binary::SectionKind::Drivers:
+                    reader.readDrivers(rides, drivers);
+                    break;
+                case ride_binary::SectionKind::Riders:
+                    reader.readRiders(rides, riders);
+                    break;
+                default:
+                    throw std::runtime_error("Unknown section in snapshot");
+            }
+        }
+        for (std::size_t i = 0; i < drivers.size(); ++i) {
+            driverSlots.emplace(drivers[i].getDriverID(), i);
+        }
+        for (std::size_t i = 0; i < riders.size(); ++i) {
+            riderSlots.emplace(riders[i].getRiderID(), i);
+        }
+        inHistory.assign(rides.size(), false);
+        for (const Driver& driver : drivers) {
+            for (RideIndex ride : driver.getAssignedRides()) {
+                inHistory[ride] = true;
+            }
+        }
+        for (const Rider& rider : riders) {
+            for (RideIndex ride : rider.getRequestedRides()) {
+                inHistory[ride] = true;
+            }
+        }
+        recovery.snapshotRides = rides.size();
+    }
+
+    // False for a payload too short for its kind, which ends the valid log there
+    bool replayEntry(WriteAheadLog::EntryKind kind, const unsigned char* data, std::size_t size) {
+        using ride_binary::detail::loadLE;
+        if (size < minimumPayload(kind)) {
+            return false;
+        }
+        switch (kind) {
+            case WriteAheadLog::EntryKind::Location: {
+                const LocationID live = LocationTable::global().intern(payloadName(data + 4, size - 4));
+                liveToLog.emplace(live, loadLE<std::uint32_t>(data));
+                logToLive.push_back(live);
+                break;
+            }
+            case WriteAheadLog::EntryKind::AddDriver:
+                insertDriver(loadLE<std::int32_t>(data), payloadName(data + 12, size - 12),
+                             loadLE<double>(data + 4));
+                break;
+            case WriteAheadLog::EntryKind::AddRider:
+                insertRider(loadLE<std::int32_t>(data), payloadName(data + 4, size - 4));
+                break;
+            case WriteAheadLog::EntryKind::CreateRide: {
+                const ride_binary::RideRecord record = ride_binary::detail::decodeRide(data);
+                if (record.pickup >= logToLive.size() || record.dropoff >= logToLive.size()) {
+                    throw std::runtime_error("Write-ahead log references an undefined location");
+                }
+                const RideIndex ride = insertRide(record.rideID, logToLive[record.pickup],
+                                                  logToLive[record.dropoff], record.distance, record.type);
+                rides[ride].restoreFare(record.fare);
+                break;
+            }
+            case WriteAheadLog::EntryKind::AssignRide: {
+                const RideIndex ride = loggedRide(loadLE<std::uint32_t>(data + 4));
+                applyAssign(driverSlot(loadLE<std::int32_t>(data)), ride,
+                            loggedTimestamp(data, size, rides[ride].getCompletedAt()));
+                break;
+            }
+            case WriteAheadLog::EntryKind::RequestRide: {
+                const RideIndex ride = loggedRide(loadLE<std::uint32_t>(data + 4));
+                applyRequest(riderSlot(loadLE<std::int32_t>(data)), ride,
+                             loggedTimestamp(data, size, rides[ride].getRequestedAt()));
+                break;
+            }
+            case WriteAheadLog::EntryKind::SetFare:
+                rides[loggedRide(loadLE<std::uint32_t>(data))].restoreFare(loadLE<double>(data + 4));
+                break;
+            default:
+                throw std::runtime_error("Unknown write-ahead log entry");
+        }
+        ++recovery.replayedEntries;
+        return true;
+    }
+
+    void recover() {
+        std::uint64_t newest = 0;
+        bool haveSnapshot = false;
+        for (const auto& entry : std::filesystem::directory_iterator(directory)) {
+            const std::string file = entry.path().filename().string();
+            if (file.rfind("snapshot-", 0) != 0 || entry.path().extension() != ".bin") {
+                continue;   // also skips snapshot-<G>.tmp left by an interrupted snapshot
+            }
+            const std::uint64_t gen = std::stoull(file.substr(9));
+            if (!haveSnapshot || gen > newest) {
+                newest = gen;
+                haveSnapshot = true;
+            }
+        }
+        generation = newest;
+        recovery.generation = generation;
+        if (haveSnapshot) {
+            loadSnapshot(generation);
+        }
+        const WriteAheadLog::ReplayResult tail = WriteAheadLog::replay(
+            logPath(generation).string(),
+            [this](WriteAheadLog::EntryKind kind, const unsigned char* data, std::size_t size) {
+                return replayEntry(kind, data, size);
+            });
+        if (tail.validBytes != 0 && tail.generation != generation) {
+            throw std::runtime_error("Write-ahead log does not match snapshot generation");
+        }
+        wal.reset(new WriteAheadLog(logPath(generation).string(), generation, tail.validBytes));
+    }
+
+public:
+    /**
+     * @brief Opens the registry in directory, recovering whatever is there
+     * snapshotInterval > 0 takes a snapshot from commit() once that many entries are logged
+     */
+    explicit DurableRegistry(const std::string& directory, std::uint64_t snapshotInterval = 0)
+        : directory(directory), snapshotInterval(snapshotInterval), generation(0),
+          entriesSinceSnapshot(0) {
+        std::filesystem::create_directories(this->directory);
+        recover();
+    }
+
+    DurableRegistry(const DurableRegistry&) = delete;
+    DurableRegistry& operator=(const DurableRegistry&) = delete;
+
+    void addDriver(int driverID, const std::string& name, double rating) {
+        if (driverSlots.count(driverID) != 0) {
+            throw std::invalid_argument("Duplicate driver ID");
+        }
+        const ValidationError error = Driver::validateRating(rating);
+        if (error != ValidationError::None) {
+            throw std::invalid_argument(validationMessage(error));
+        }
+        std::vector<unsigned char> payload(12 + name.size());
+        ride_binary::detail::storeLE<std::int32_t>(payload.data(), driverID);
+        ride_binary::detail::storeLE<double>(payload.data() + 4, rating);
+        name.copy(reinterpret_cast<char*>(payload.data() + 12), name.size());
+        log(WriteAheadLog::EntryKind::AddDriver, payload.data(), payload.size());
+        insertDriver(driverID, name, rating);
+    }
+
+    void addRider(int riderID, const std::string& name) {
+        if (riderSlots.count(riderID) != 0) {
+            throw std::invalid_argument("Duplicate rider ID");
+        }
+        std::vector<unsigned char> payload(4 + name.size());
+        ride_binary::detail::storeLE<std::int32_t>(payload.data(), riderID);
+        name.copy(reinterpret_cast<char*>(payload.data() + 4), name.size());
+        log(WriteAheadLog::EntryKind::AddRider, payload.data(), payload.size());
+        insertRider(riderID, name);
+    }
+
+    // Creates and prices a ride; the logged record carries the fare
+    RideIndex createRide(RideType type, int rideID, LocationID pickup, LocationID dropoff, double distance) {
+        const ValidationError error = Ride::validate(pickup, dropoff, distance);
+        if (error != ValidationError::None) {
+            throw std::invalid_argument(validationMessage(error));
+        }
+        if (!isValidRideType(type)) {
+            throw std::invalid_argument("Invalid ride type");
+        }
+        const RideIndex ride = insertRide(rideID, pickup, dropoff, distance, type);
+        rides[ride].calculateFare();
+        ride_binary::RideRecord record = ride_binary::toRecord(rides[ride]);
+        record.pickup = logLocation(pickup);
+        record.dropoff = logLocation(dropoff);
+        unsigned char payload[ride_binary::rideRecordSize];
+        ride_binary::detail::encodeRide(payload, record);
+        log(WriteAheadLog::EntryKind::CreateRide, payload, sizeof(payload));
+        return ride;
+    }
+
+    RideIndex createRide(RideType type, int rideID, const std::string& pickup,
+                         const std::string& dropoff, double distance) {
+        LocationTable& table = LocationTable::global();
+        const LocationID pickupID = table.intern(pickup);
+        return createRide(type, rideID, pickupID, table.intern(dropoff), distance);
+    }
+
+    // timestamp (Unix seconds) is logged, so replay puts the ride in the same stats windows
+    void assignRide(int driverID, RideIndex ride, std::int64_t timestamp = currentTimestamp()) {
+        const std::size_t slot = driverSlot(driverID);
+        if (!rides.contains(ride)) {
+            throw std::invalid_argument("Invalid ride index");
+        }
+        unsigned char payload[16];
+        ride_binary::detail::storeLE<std::int32_t>(payload, driverID);
+        ride_binary::detail::storeLE<std::uint32_t>(payload + 4, ride);
+        ride_binary::detail::storeLE<std::int64_t>(payload + 8, timestamp);
+        log(WriteAheadLog::EntryKind::AssignRide, payload, sizeof(payload));
+        applyAssign(slot, ride, timestamp);
+    }
+
+    void requestRide(int riderID, RideIndex ride, std::int64_t timestamp = currentTimestamp()) {
+        const std::size_t slot = riderSlot(riderID);
+        if (!rides.contains(ride)) {
+            throw std::invalid_argument("Invalid ride index");
+        }
+        unsigned char payload[16];
+        ride_binary::detail::storeLE<std::int32_t>(payload, riderID);
+        ride_binary::detail::storeLE<std::uint32_t>(payload + 4, ride);
+        ride_binary::detail::storeLE<std::int64_t>(payload + 8, timestamp);
+        log(WriteAheadLog::EntryKind::RequestRide, payload, sizeof(payload));
+        applyRequest(slot, ride, timestamp);
+    }
+
+    /**
+     * @brief Logs a fare change, e.g. a re-price after the ride was created
+     * Only before the ride is assigned or requested: driver and rider stats fold
+     * the fare in at that point, so a later change would leave them disagreeing
+     * with the ride and with a snapshot reload
+     */
+    void recordFare(RideIndex ride, double fare) {
+        if (!rides.contains(ride)) {
+            throw std::invalid_argument("Invalid ride index");
+        }
+        if (inHistory[ride]) {
+            throw std::invalid_argument("Fare cannot change once the ride is assigned or requested");
+        }
+        unsigned char payload[12];
+        ride_binary::detail::storeLE<std::uint32_t>(payload, ride);
+        ride_binary::detail::storeLE<double>(payload + 4, fare);
+        log(WriteAheadLog::EntryKind::SetFare, payload, sizeof(payload));
+        rides[ride].restoreFare(fare);
+    }
+
+    // Makes every change so far durable with a single group commit
+    void commit() {
+        wal->commitAll();
+        if (snapshotInterval != 0 && entriesSinceSnapshot >= snapshotInterval) {
+            snapshot();
+        }
+    }
+
+    /**
+     * @brief Writes the full registry as a new generation and starts an empty log
+     * The snapshot is fsynced and renamed into place before the old generation is
+     * removed, so a crash at any point leaves one complete snapshot + log pair
+     */
+    void snapshot() {
+        wal->commitAll();
+        const std::uint64_t next = generation + 1;
+        const std::filesystem::path temporary = directory / ("snapshot-" + std::to_string(next) + ".tmp");
+        {
+            std::ofstream out(temporary, std::ios::binary | std::ios::trunc);
+            if (!out) {
+                throw std::runtime_error("Failed to create snapshot " + temporary.string());
+            }
+            ride_binary::Writer writer(out);
+            writer.writeLocations(LocationTable::global());
+            writer.writeRides(rides);
+            writer.beginDrivers(drivers.size());
+            for (const Driver& driver : drivers) {
+                writer.writeDriver(driver);
+            }
+            writer.beginRiders(riders.size());
+            for (const Rider& rider : riders) {
+                writer.writeRider(rider);
+            }
+            writer.flush();
+            out.close();
+            if (!out) {
+                throw std::runtime_error("Failed to write snapshot " + temporary.string());
+            }
+        }
+        syncPath(temporary, O_RDONLY);
+        std::filesystem::rename(temporary, snapshotPath(next));
+        syncPath(directory, O_RDONLY | O_DIRECTORY);
+
+        wal.reset(new WriteAheadLog(logPath(next).string(), next));
+        std::error_code ignored;
+        std::filesystem::remove(logPath(generation), ignored);
+        std::filesystem::remove(snapshotPath(generation), ignored);
+        generation = next;
+        entriesSinceSnapshot = 0;
+        liveToLog.clear();
+        logToLive.clear();
+    }
+
+    const RideRegistry& getRides() const { return rides; }
+    const std::vector<Driver>& getDrivers() const { return drivers; }
+    const std::vector<Rider>& getRiders() const { return riders; }
+    const Driver& getDriver(int driverID) const { return drivers[driverSlot(driverID)]; }
+    const Rider& getRider(int riderID) const { return riders[riderSlot(riderID)]; }
+
+    std::uint64_t getGeneration() const { return generation; }
+    const RecoveryStats& getRecoveryStats() const { return recovery; }
+    WriteAheadLog& getLog() { return *wal; }
+};
+
+#endif // RIDE_SHARING_DURABLE_REGISTRY_H
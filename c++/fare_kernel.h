@@ -0,0 +1,192 @@
+#ifndef RIDE_SHARING_FARE_KERNEL_H
+#define RIDE_SHARING_FARE_KERNEL_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+
+#include "ride_batch.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define RIDE_SHARING_X86 1
+#elif defined(__aarch64__) && defined(__ARM_NEON)
+#include <arm_neon.h>
+#define RIDE_SHARING_NEON 1
+#endif
+
+/**
+ * @brief Instruction set used by the vectorized fare kernel
+ * The best one supported by the running CPU is picked once at runtime
+ */
+enum class FareKernel {
+    Scalar,
+    Neon,
+    Avx2,
+    Avx512
+};
+
+inline const char* fareKernelName(FareKernel kernel) {
+    switch (kernel) {
+        case FareKernel::Neon: return "neon";
+        case FareKernel::Avx2: return "avx2";
+        case FareKernel::Avx512: return "avx512";
+        case FareKernel::Scalar: break;
+    }
+    return "scalar";
+}
+
+namespace fare_kernel_detail {
+
+// Rate table padded to one 512-bit register so the AVX-512 path can permute from it
+alignas(64) inline constexpr double paddedRates[8] = {
+    rideRatePerMile[0], rideRatePerMile[1], rideRatePerMile[2], 0.0, 0.0, 0.0, 0.0, 0.0
+};
+
+static_assert(sizeof(rideRatePerMile) / sizeof(rideRatePerMile[0]) <= 8,
+              "paddedRates must hold every ride type");
+
+inline void priceScalar(const double* distances, const RideType* types, double* fares,
+                        std::size_t begin, std::size_t count) {
+    for (std::size_t i = begin; i < count; ++i) {
+        fares[i] = distances[i] * rideRatePerMile[static_cast<std::size_t>(types[i])];
+    }
+}
+
+#if defined(RIDE_SHARING_X86)
+
+// GCC 12's intrinsic headers trip -Wmaybe-uninitialized on the _undefined_ helpers (GCC PR 105593)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+
+// 4 rides per step: widen the byte tags to 32-bit indices and gather the rates
+__attribute__((target("avx2")))
+inline void priceAvx2(const double* distances, const RideType* types, double* fares,
+                      std::size_t count) {
+    std::size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        std::int32_t packed;
+        std::memcpy(&packed, types + i, sizeof(packed));
+        __m128i index = _mm_cvtepu8_epi32(_mm_cvtsi32_si128(packed));
+        __m256d rates = _mm256_i32gather_pd(paddedRates, index, sizeof(double));
+        __m256d dist = _mm256_loadu_pd(distances + i);
+        _mm256_storeu_pd(fares + i, _mm256_mul_pd(dist, rates));
+    }
+    priceScalar(distances, types, fares, i, count);
+}
+
+// 8 rides per step: the whole rate table lives in one register, so select with a permute
+__attribute__((target("avx512f")))
+inline void priceAvx512(const double* distances, const RideType* types, double* fares,
+                        std::size_t count) {
+    const __m512d table = _mm512_load_pd(paddedRates);
+    std::size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        __m128i packed = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(types + i));
+        __m512i index = _mm512_cvtepu8_epi64(packed);
+        __m512d rates = _mm512_permutexvar_pd(index, table);
+        __m512d dist = _mm512_loadu_pd(distances + i);
+        _mm512_storeu_pd(fares + i, _mm512_mul_pd(dist, rates));
+    }
+    priceScalar(distances, types, fares, i, count);
+}
+
+#pragma GCC diagnostic pop
+
+#endif // RIDE_SHARING_X86
+
+#if defined(RIDE_SHARING_NEON)
+
+// 2 rides per step: no gather on NEON, so the rate lanes are filled from the table
+inline void priceNeon(const double* distances, const RideType* types, double* fares,
+                      std::size_t count) {
+    std::size_t i = 0;
+    for (; i + 2 <= count; i += 2) {
+        float64x2_t rates = vdupq_n_f64(paddedRates[static_cast<std::size_t>(types[i])]);
+        rates = vsetq_lane_f64(paddedRates[static_cast<std::size_t>(types[i + 1])], rates, 1);
+        float64x2_t dist = vld1q_f64(distances + i);
+        vst1q_f64(fares + i, vmulq_f64(dist, rates));
+    }
+    priceScalar(distances, types, fares, i, count);
+}
+
+#endif // RIDE_SHARING_NEON
+
+} // namespace fare_kernel_detail
+
+/**
+ * @brief Returns the widest fare kernel the running CPU supports
+ */
+inline FareKernel detectFareKernel() {
+#if defined(RIDE_SHARING_X86)
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f")) {
+        return FareKernel::Avx512;
+    }
+    if (__builtin_cpu_supports("avx2")) {
+        return FareKernel::Avx2;
+    }
+#elif defined(RIDE_SHARING_NEON)
+    return FareKernel::Neon;
+#endif
+    return FareKernel::Scalar;
+}
+
+inline bool isFareKernelSupported(FareKernel kernel) {
+    static const FareKernel best = detectFareKernel();
+    switch (kernel) {
+        case FareKernel::Scalar: return true;
+        case FareKernel::Neon: return best == FareKernel::Neon;
+        case FareKernel::Avx2: return best == FareKernel::Avx2 || best == FareKernel::Avx512;
+        case FareKernel::Avx512: return best == FareKernel::Avx512;
+    }
+    return false;
+}
+
+/**
+ * @brief Prices the batch with an explicitly chosen kernel
+ * Throws if the running CPU cannot execute the requested instruction set
+ */
+inline void calculateFares(RideBatch& batch, FareKernel kernel) {
+    if (!isFareKernelSupported(kernel)) {
+        throw std::invalid_argument("Fare kernel not supported on this CPU");
+    }
+
+    const std::size_t count = batch.size();
+    const double* distances = batch.distanceData();
+    const RideType* types = batch.typeData();
+    double* fares = batch.fareData();
+    // Counted up front since every case returns; the kernels cannot fail
+    RIDE_METRICS_COUNT(FaresCalculated, count);
+
+    switch (kernel) {
+#if defined(RIDE_SHARING_X86)
+        case FareKernel::Avx512:
+            fare_kernel_detail::priceAvx512(distances, types, fares, count);
+            return;
+        case FareKernel::Avx2:
+            fare_kernel_detail::priceAvx2(distances, types, fares, count);
+            return;
+#endif
+#if defined(RIDE_SHARING_NEON)
+        case FareKernel::Neon:
+            fare_kernel_detail::priceNeon(distances, types, fares, count);
+            return;
+#endif
+        default:
+            fare_kernel_detail::priceScalar(distances, types, fares, 0, count);
+            return;
+    }
+}
+
+/**
+ * @brief Prices the batch with the best kernel for this CPU
+ * The kernel is detected once and reused; fares stay bit-identical to the scalar path
+ */
+inline void calculateFaresVectorized(RideBatch& batch) {
+    static const FareKernel kernel = detectFareKernel();
+    calculateFares(batch, kernel);
+}
+
+#endif // RIDE_SHARING_FARE_KERNEL_H
@@ -0,0 +1,114 @@
+#ifndef RIDE_SHARING_FLAT_ID_TABLE_H
+#define RIDE_SHARING_FLAT_ID_TABLE_H
+
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+
+/**
+ * @brief FlatIdTable class - open-addressing map from an int ID to a small record
+ * Entry must be trivially copyable with `int id` and `std::uint32_t slot` members;
+ * slot == emptySlot marks a free bucket, so every int is a valid ID. Records
+ * live inline in the buckets (linear probing, load <= 1/2), so a hit usually
+ * reads the one cache line holding its home bucket.
+ */
+template <typename Entry>
+class FlatIdTable {
+public:
+    static constexpr std::uint32_t emptySlot = 0xFFFFFFFFu;
+
+private:
+    std::vector<Entry> buckets;
+    std::size_t mask;
+    unsigned shift;
+    std::size_t count;
+
+    // Fibonacci hashing spreads sequential IDs across the table
+    std::size_t home(int id) const {
+        return static_cast<std::size_t>((static_cast<std::uint64_t>(static_cast<std::uint32_t>(id))
+                                         * 0x9E3779B97F4A7C15ull) >> shift);
+    }
+
+    static Entry emptyEntry() {
+        Entry entry{};
+        entry.slot = emptySlot;
+        return entry;
+    }
+
+    void rehash(std::size_t capacity) {
+        std::vector<Entry> old(capacity, emptyEntry());
+        old.swap(buckets);
+        mask = capacity - 1;
+        shift = 64;
+        for (std::size_t c = capacity; c > 1; c >>= 1) {
+            --shift;
+        }
+        for (const Entry& entry : old) {
+            if (entry.slot != emptySlot) {
+                std::size_t i = home(entry.id);
+                while (buckets[i].slot != emptySlot) {
+                    i = (i + 1) & mask;
+                }
+                buckets[i] = entry;
+            }
+        }
+    }
+
+public:
+    explicit FlatIdTable(std::size_t expected = 0) : mask(0), shift(64), count(0) {
+        reserve(expected);
+    }
+
+    // Sizes the table so expected entries fit without a rehash
+    void reserve(std::size_t expected) {
+        std::size_t capacity = 16;
+        while (capacity < expected * 2) {
+            capacity <<= 1;
+        }
+        if (capacity > buckets.size()) {
+            rehash(capacity);
+        }
+    }
+
+    Entry* find(int id) {
+        for (std::size_t i = home(id);; i = (i + 1) & mask) {
+            Entry& entry = buckets[i];
+            if (entry.slot == emptySlot) {
+                return nullptr;
+            }
+            if (entry.id == id) {
+                return &entry;
+            }
+        }
+    }
+
+    const Entry* find(int id) const { return const_cast<FlatIdTable*>(this)->find(id); }
+
+    // Returns nullptr when id is already present
+    Entry* insert(const Entry& entry) {
+        if (entry.slot == emptySlot) {
+            throw std::invalid_argument("Entry slot must not be the empty marker");
+        }
+        if ((count + 1) * 2 > buckets.size()) {
+            rehash(buckets.size() * 2);
+        }
+        std::size_t i = home(entry.id);
+        for (; buckets[i].slot != emptySlot; i = (i + 1) & mask) {
+            if (buckets[i].id == entry.id) {
+                return nullptr;
+            }
+        }
+        buckets[i] = entry;
+        ++count;
+        return &buckets[i];
+    }
+
+    // Starts pulling id's home bucket into cache ahead of a find()
+    void prefetch(int id) const { __builtin_prefetch(&buckets[home(id)]); }
+
+    std::size_t size() const { return count; }
+    std::size_t capacity() const { return buckets.size(); }
+};
+
+#endif // RIDE_SHARING_FLAT_ID_TABLE_H
@@ -0,0 +1,31 @@
+#ifndef RIDE_SHARING_GEO_H
+#define RIDE_SHARING_GEO_H
+
+#include <cmath>
+
+/**
+ * @brief Latitude/longitude position in degrees
+ */
+struct GeoPoint {
+    double lat;
+    double lon;
+};
+
+constexpr double earthRadiusKm = 6371.0;
+constexpr double kmPerDegree = earthRadiusKm * 3.14159265358979323846 / 180.0;
+
+inline double degreesToRadians(double degrees) {
+    return degrees * (3.14159265358979323846 / 180.0);
+}
+
+/**
+ * @brief Equirectangular distance approximation in kilometres
+ * Accurate to well under 1% at city scale and much cheaper than haversine
+ */
+inline double distanceKm(const GeoPoint& a, const GeoPoint& b) {
+    const double x = (b.lon - a.lon) * std::cos(degreesToRadians((a.lat + b.lat) * 0.5));
+    const double y = b.lat - a.lat;
+    return std::sqrt(x * x + y * y) * kmPerDegree;
+}
+
+#endif // RIDE_SHARING_GEO_H
@@ -0,0 +1,450 @@
+#ifndef RIDE_SHARING_LOAD_GENERATOR_H
+#define RIDE_SHARING_LOAD_GENERATOR_H
+
+#include <array>
+#include <vector>
+#include <string>
+#include <random>
+#include <istream>
+#include <ostream>
+#include <algorithm>
+#include <numeric>
+#include <utility>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+
+#include "geo.h"
+#include "ride.h"
+#include "ride_request.h"
+#include "ride_binary.h"
+#include "location_table.h"
+
+/**
+ * @brief Named area where pickups and dropoffs cluster
+ * weight is its share among hotspots; points fall off as a Gaussian of spreadKm
+ */
+struct Hotspot {
+    std::string name;
+    GeoPoint center;
+    double spreadKm;
+    double weight;
+};
+
+/**
+ * @brief Shape of a city's traffic: where, when and what kind of rides
+ * hourlyWeights[h] is the relative request rate in local hour h
+ */
+struct TrafficProfile {
+    GeoPoint center;
+    double radiusKm = 15.0;                // background trips fall uniformly inside this disc
+    std::vector<Hotspot> hotspots;
+    double hotspotShare = 0.7;             // remaining trips use the background disc
+    double premiumShare = 0.15;
+    double pooledShare = 0.10;
+    double roadFactor = 1.3;               // road miles per straight-line mile
+    double minTripMiles = 0.5;
+    std::array<double, 24> hourlyWeights{};
+
+    // Overnight floor, morning and evening commute peaks and a late-night bump
+    static std::array<double, 24> rushHourCurve() {
+        std::array<double, 24> weights{};
+        for (int h = 0; h < 24; ++h) {
+            const double hour = h + 0.5;
+            const auto peak = [hour](double at, double height, double width) {
+                return height * std::exp(-0.5 * (hour - at) * (hour - at) / (width * width));
+            };
+            weights[h] = 0.15 + peak(8.5, 1.0, 1.2) + peak(18.0, 1.2, 1.6) + peak(23.5, 0.4, 1.5)
+                       + 0.35 * (h >= 7 && h <= 21);
+        }
+        return weights;
+    }
+
+    // New York-like preset: Midtown and Downtown dominate, airports draw long trips
+    static TrafficProfile metro() {
+        TrafficProfile profile;
+        profile.center = GeoPoint{ 40.7380, -73.9900 };
+        profile.hotspots = {
+            { "Midtown", GeoPoint{ 40.7549, -73.9840 }, 1.2, 0.30 },
+            { "Financial District", GeoPoint{ 40.7075, -74.0113 }, 0.8, 0.18 },
+            { "Upper East Side", GeoPoint{ 40.7736, -73.9566 }, 1.5, 0.12 },
+            { "Williamsburg", GeoPoint{ 40.7081, -73.9571 }, 1.2, 0.12 },
+            { "Downtown Brooklyn", GeoPoint{ 40.6928, -73.9903 }, 1.0, 0.10 },
+            { "Long Island City", GeoPoint{ 40.7447, -73.9485 }, 1.0, 0.08 },
+            { "LaGuardia Airport", GeoPoint{ 40.7769, -73.8740 }, 0.6, 0.05 },
+            { "JFK Airport", GeoPoint{ 40.6413, -73.7781 }, 0.8, 0.05 }
+        };
+        profile.hourlyWeights = rushHourCurve();
+        return profile;
+    }
+};
+
+struct GeneratedDriver {
+    int driverID;
+    double rating;
+    GeoPoint position;
+};
+
+// request.requestID grows with timestamp; riders are numbered 1..riderCount
+struct GeneratedRequest {
+    std::int64_t timestamp;   // Unix seconds
+    RideRequest request;
+    GeoPoint dropoffPosition;  // where the driver ends up
+};
+
+struct TrafficTrace {
+    std::size_t riderCount = 0;
+    std::vector<GeneratedDriver> drivers;
+    std::vector<GeneratedRequest> requests;   // sorted by timestamp
+};
+
+/**
+ * @brief TrafficGenerator class - seeded synthetic city traffic
+ * The same profile and seed always produce the same trace
+ */
+class TrafficGenerator {
+private:
+    TrafficProfile profile;
+    std::mt19937_64 rng;
+    std::vector<LocationID> hotspotIDs;
+    LocationID backgroundID;
+    std::discrete_distribution<int> hotspotPick;
+    std::discrete_distribution<int> hourPick;
+    std::uniform_real_distribution<double> unit{ 0.0, 1.0 };
+    std::normal_distribution<double> gaussian{ 0.0, 1.0 };
+
+    // Offsets p by (northKm, eastKm)
+    static GeoPoint offset(const GeoPoint& p, double northKm, double eastKm) {
+        return GeoPoint{ p.lat + northKm / kmPerDegree,
+                         p.lon + eastKm / (kmPerDegree * std::cos(degreesToRadians(p.lat))) };
+    }
+
+    // Returns the point and the hotspot it came from, or -1 for background
+    GeoPoint samplePoint(int& hotspot) {
+        if (!profile.hotspots.empty() && unit(rng) < profile.hotspotShare) {
+            hotspot = hotspotPick(rng);
+            const Hotspot& spot = profile.hotspots[hotspot];
+            return offset(spot.center, gaussian(rng) * spot.spreadKm, gaussian(rng) * spot.spreadKm);
+        }
+        hotspot = -1;
+        const double r = profile.radiusKm * std::sqrt(unit(rng));
+        const double angle = 2.0 * 3.14159265358979323846 * unit(rng);
+        return offset(profile.center, r * std::cos(angle), r * std::sin(angle));
+    }
+
+    RideType sampleType() {
+        const double u = unit(rng);
+        if (u < profile.premiumShare) {
+            return RideType::Premium;
+        }
+        if (u < profile.premiumShare + profile.pooledShare) {
+            return RideType::Pooled;
+        }
+        return RideType::Standard;
+    }
+
+public:
+    explicit TrafficGenerator(TrafficProfile traffic = TrafficProfile::metro(), std::uint64_t seed = 1,
+                              LocationTable& locations = LocationTable::global())
+        : profile(std::move(traffic)), rng(seed) {
+        if (profile.premiumShare < 0 || profile.pooledShare < 0 || profile.premiumShare + profile.pooledShare > 1) {
+            throw std::invalid_argument("Ride type shares must be between 0 and 1");
+        }
+        if (!(profile.radiusKm > 0)) {
+            throw std::invalid_argument("Radius must be greater than 0");
+        }
+        std::vector<double> weights;
+        for (const Hotspot& spot : profile.hotspots) {
+            if (!(spot.weight > 0) || !(spot.spreadKm > 0)) {
+                throw std::invalid_argument("Hotspot weight and spread must be greater than 0");
+            }
+            hotspotIDs.push_back(locations.intern(spot.name));
+            weights.push_back(spot.weight);
+        }
+        backgroundID = locations.intern("Citywide");
+        hotspotPick = std::discrete_distribution<int>(weights.begin(), weights.end());
+        const double total = std::accumulate(profile.hourlyWeights.begin(), profile.hourlyWeights.end(), 0.0);
+        hourPick = total > 0
+            ? std::discrete_distribution<int>(profile.hourlyWeights.begin(), profile.hourlyWeights.end())
+            : std::discrete_distribution<int>(24, 0.0, 24.0, [](double) { return 1.0; });
+    }
+
+    // Drivers start where demand is, with ratings mostly between 4.3 and 5
+    std::vector<GeneratedDriver> drivers(std::size_t count, int firstID = 1) {
+        std::vector<GeneratedDriver> result;
+        result.reserve(count);
+        std::normal_distribution<double> rating(4.7, 0.2);
+        for (std::size_t i = 0; i < count; ++i) {
+            int hotspot;
+            const GeoPoint position = samplePoint(hotspot);
+            result.push_back(GeneratedDriver{ firstID + static_cast<int>(i),
+                                              std::clamp(rating(rng), 3.5, 5.0), position });
+        }
+        return result;
+    }
+
+    /**
+     * @brief count requests over the day starting at dayStart (Unix seconds, local midnight)
+     * Hours follow hourlyWeights; pickups and dropoffs are drawn independently from the hotspot mix
+     */
+    std::vector<GeneratedRequest> requests(std::size_t count, std::size_t riderCount, std::int64_t dayStart) {
+        if (riderCount == 0) {
+            throw std::invalid_argument("Rider count must be greater than 0");
+        }
+        std::vector<GeneratedRequest> result;
+        result.reserve(count);
+        std::uniform_int_distribution<int> rider(1, static_cast<int>(riderCount));
+        for (std::size_t i = 0; i < count; ++i) {
+            GeneratedRequest generated{};
+            generated.timestamp = dayStart + hourPick(rng) * 3600 + static_cast<std::int64_t>(unit(rng) * 3600);
+            RideRequest& request = generated.request;
+            int pickupSpot;
+            int dropoffSpot;
+            request.pickupPosition = samplePoint(pickupSpot);
+            const GeoPoint dropoff = samplePoint(dropoffSpot);
+            generated.dropoffPosition = dropoff;
+            request.riderID = rider(rng);
+            request.pickupLocation = pickupSpot < 0 ? backgroundID : hotspotIDs[pickupSpot];
+            request.dropoffLocation = dropoffSpot < 0 ? backgroundID : hotspotIDs[dropoffSpot];
+            request.type = sampleType();
+            request.distance = std::max(profile.minTripMiles,
+                                        distanceKm(request.pickupPosition, dropoff) * profile.roadFactor / 1.609344);
+            result.push_back(generated);
+        }
+        std::sort(result.begin(), result.end(),
+                  [](const GeneratedRequest& a, const GeneratedRequest& b) { return a.timestamp < b.timestamp; });
+        for (std::size_t i = 0; i < result.size(); ++i) {
+            result[i].request.requestID = i + 1;
+        }
+        return result;
+    }
+
+    TrafficTrace trace(std::size_t riderCount, std::size_t driverCount, std::size_t requestCount,
+                       std::int64_t dayStart) {
+        TrafficTrace result;
+        result.riderCount = riderCount;
+        result.drivers = drivers(driverCount);
+        result.requests = requests(requestCount, riderCount, dayStart);
+        return result;
+    }
+
+    const TrafficProfile& getProfile() const { return profile; }
+};
+
+/**
+ * @brief Binary traffic traces for replay
+ * Little-endian, using the ride_binary byte helpers: "RTRC", uint16 version,
+ * uint16 zero, uint64 rider count, then a location section (uint32 count,
+ * uint32 length + name each), uint64 driver count + 28-byte driver records,
+ * uint64 request count + 72-byte request records. Location IDs in records
+ * index the trace's own location section.
+ */
+namespace traffic_trace {
+
+constexpr std::uint32_t magic = 0x43525452;   // "RTRC" on disk
+constexpr std::uint16_t version = 1;
+constexpr std::size_t driverRecordSize = 28;
+constexpr std::size_t requestRecordSize = 72;
+
+namespace detail {
+
+using ride_binary::detail::storeLE;
+using ride_binary::detail::loadLE;
+
+inline void writeBytes(std::ostream& out, const unsigned char* bytes, std::size_t size) {
+    out.write(reinterpret_cast<const char*>(bytes), static_cast<std::streamsize>(size));
+}
+
+inline void readBytes(std::istream& in, unsigned char* bytes, std::size_t size) {
+    in.read(reinterpret_cast<char*>(bytes), static_cast<std::streamsize>(size));
+    if (static_cast<std::size_t>(in.gcount()) != size) {
+        throw std::runtime_error("Truncated traffic trace");
+    }
+}
+
+template <typename T>
+void writeValue(std::ostream& out, T value) {
+    unsigned char bytes[sizeof(T)];
+    storeLE<T>(bytes, value);
+    writeBytes(out, bytes, sizeof(T));
+}
+
+template <typename T>
+T readValue(std::istream& in) {
+    unsigned char bytes[sizeof(T)];
+    readBytes(in, bytes, sizeof(T));
+    return loadLE<T>(bytes);
+}
+
+} // namespace detail
+
+inline void write(std::ostream& out, const TrafficTrace& trace, const LocationTable& locations = LocationTable::global()) {
+    // Only the locations the requests use, renumbered densely
+    std::vector<LocationID> used;
+    for (const GeneratedRequest& generated : trace.requests) {
+        used.push_back(generated.request.pickupLocation);
+        used.push_back(generated.request.dropoffLocation);
+    }
+    std::sort(used.begin(), used.end());
+    used.erase(std::unique(used.begin(), used.end()), used.end());
+    const auto fileID = [&used](LocationID id) {
+        return static_cast<std::uint32_t>(std::lower_bound(used.begin(), used.end(), id) - used.begin());
+    };
+
+    detail::writeValue<std::uint32_t>(out, magic);
+    detail::writeValue<std::uint16_t>(out, version);
+    detail::writeValue<std::uint16_t>(out, 0);
+    detail::writeValue<std::uint64_t>(out, trace.riderCount);
+    detail::writeValue<std::uint32_t>(out, static_cast<std::uint32_t>(used.size()));
+    for (LocationID id : used) {
+        const std::string& name = locations.name(id);
+        detail::writeValue<std::uint32_t>(out, static_cast<std::uint32_t>(name.size()));
+        detail::writeBytes(out, reinterpret_cast<const unsigned char*>(name.data()), name.size());
+    }
+
+    std::vector<unsigned char> buffer;
+    detail::writeValue<std::uint64_t>(out, trace.drivers.size());
+    buffer.resize(trace.drivers.size() * driverRecordSize);
+    for (std::size_t i = 0; i < trace.drivers.size(); ++i) {
+        unsigned char* at = buffer.data() + i * driverRecordSize;
+        const GeneratedDriver& driver = trace.drivers[i];
+        detail::storeLE<std::int32_t>(at, driver.driverID);
+        detail::storeLE<double>(at + 4, driver.rating);
+        detail::storeLE<double>(at + 12, driver.position.lat);
+        detail::storeLE<double>(at + 20, driver.position.lon);
+    }
+    detail::writeBytes(out, buffer.data(), buffer.size());
+
+    detail::writeValue<std::uint64_t>(out, trace.requests.size());
+    buffer.resize(trace.requests.size() * requestRecordSize);
+    for (std::size_t i = 0; i < trace.requests.size(); ++i) {
+        unsigned char* at = buffer.data() + i * requestRecordSize;
+        const RideRequest& request = trace.requests[i].request;
+        detail::storeLE<std::int64_t>(at, trace.requests[i].timestamp);
+        detail::storeLE<std::uint64_t>(at + 8, request.requestID);
+        detail::storeLE<std::int32_t>(at + 16, request.riderID);
+        detail::storeLE<std::uint32_t>(at + 20, fileID(request.pickupLocation));
+        detail::storeLE<std::uint32_t>(at + 24, fileID(request.dropoffLocation));
+        at[28] = static_cast<unsigned char>(request.type);
+        at[29] = at[30] = at[31] = 0;
+        detail::storeLE<double>(at + 32, request.pickupPosition.lat);
+        detail::storeLE<double>(at + 40, request.pickupPosition.lon);
+        detail::storeLE<double>(at + 48, request.distance);
+        detail::storeLE<double>(at + 56, trace.requests[i].dropoffPosition.lat);
+        detail::storeLE<double>(at + 64, trace.requests[i].dropoffPosition.lon);
+    }
+    detail::writeBytes(out, buffer.data(), buffer.size());
+    if (!out) {
+        throw std::runtime_error("Failed to write traffic trace");
+    }
+}
+
+// Location names are interned into locations, so request IDs refer to this process's table
+// Counts and name lengths are checked against the bytes left in the stream before
+// they size anything; a stream that cannot seek is decoded a chunk at a time
+inline TrafficTrace read(std::istream& in, LocationTable& locations = LocationTable::global()) {
+    if (detail::readValue<std::uint32_t>(in) != magic) {
+        throw std::runtime_error("Not a traffic trace");
+    }
+    if (detail::readValue<std::uint16_t>(in) != version) {
+        throw std::runtime_error("Unsupported traffic trace version");
+    }
+    detail::readValue<std::uint16_t>(in);
+    TrafficTrace trace;
+    trace.riderCount = static_cast<std::size_t>(detail::readValue<std::uint64_t>(in));
+
+    using ride_binary::unknownLength;
+    std::uint64_t left = ride_binary::detail::streamBytesLeft(in);
+    const auto require = [&left](std::uint64_t count, std::size_t size) {
+        if (!ride_binary::detail::fits(count, size, left)) {
+            throw std::runtime_error("Truncated traffic trace");
+        }
+        if (left != unknownLength) {
+            left -= count * size;
+        }
+    };
+    // Records worth reserving up front: all of them when the stream length is known, else one chunk
+    const auto reservable = [&left](std::uint64_t count, std::size_t size) {
+        if (!ride_binary::detail::fits(count, size, left)) {
+            throw std::runtime_error("Truncated traffic trace");
+        }
+        return static_cast<std::size_t>(
+            left == unknownLength ? std::min<std::uint64_t>(count, ride_binary::ioChunkSize / size) : count);
+    };
+
+    require(1, 4);
+    const std::uint32_t locationCount = detail::readValue<std::uint32_t>(in);
+    std::vector<LocationID> locationMap;
+    locationMap.reserve(reservable(locationCount, 4));
+    std::string name;
+    for (std::uint32_t i = 0; i < locationCount; ++i) {
+        require(1, 4);
+        const std::uint32_t length = detail::readValue<std::uint32_t>(in);
+        if (length > ride_binary::maxNameLength) {
+            throw std::runtime_error("Location name too long in traffic trace");
+        }
+        require(length, 1);
+        name.resize(length);
+        if (!name.empty()) {
+            detail::readBytes(in, reinterpret_cast<unsigned char*>(&name[0]), name.size());
+        }
+        locationMap.push_back(locations.intern(name));
+    }
+    const auto liveID = [&locationMap](std::uint32_t fileID) {
+        if (fileID >= locationMap.size()) {
+            throw std::runtime_error("Trace request refers to an unknown location");
+        }
+        return locationMap[fileID];
+    };
+
+    // Reads count records of recordSize bytes, at most one I/O chunk per read
+    std::vector<unsigned char> buffer;
+    const auto readRecords = [&](std::uint64_t count, std::size_t recordSize, auto&& decode) {
+        require(count, recordSize);
+        const std::size_t perChunk = ride_binary::ioChunkSize / recordSize;
+        while (count > 0) {
+            const std::size_t n = static_cast<std::size_t>(std::min<std::uint64_t>(count, perChunk));
+            buffer.resize(n * recordSize);
+            detail::readBytes(in, buffer.data(), buffer.size());
+            for (std::size_t i = 0; i < n; ++i) {
+                decode(buffer.data() + i * recordSize);
+            }
+            count -= n;
+        }
+    };
+
+    require(1, 8);
+    const std::uint64_t driverCount = detail::readValue<std::uint64_t>(in);
+    trace.drivers.reserve(reservable(driverCount, driverRecordSize));
+    readRecords(driverCount, driverRecordSize, [&trace](const unsigned char* at) {
+        trace.drivers.push_back(GeneratedDriver{ detail::loadLE<std::int32_t>(at), detail::loadLE<double>(at + 4),
+                                                 GeoPoint{ detail::loadLE<double>(at + 12), detail::loadLE<double>(at + 20) } });
+    });
+
+    require(1, 8);
+    const std::uint64_t requestCount = detail::readValue<std::uint64_t>(in);
+    trace.requests.reserve(reservable(requestCount, requestRecordSize));
+    readRecords(requestCount, requestRecordSize, [&trace, &liveID](const unsigned char* at) {
+        GeneratedRequest generated{};
+        generated.timestamp = detail::loadLE<std::int64_t>(at);
+        RideRequest& request = generated.request;
+        request.requestID = detail::loadLE<std::uint64_t>(at + 8);
+        request.riderID = detail::loadLE<std::int32_t>(at + 16);
+        request.pickupLocation = liveID(detail::loadLE<std::uint32_t>(at + 20));
+        request.dropoffLocation = liveID(detail::loadLE<std::uint32_t>(at + 24));
+        request.type = static_cast<RideType>(at[28]);
+        if (!isValidRideType(request.type)) {
+            throw std::runtime_error("Unknown ride type in traffic trace");
+        }
+        request.pickupPosition = GeoPoint{ detail::loadLE<double>(at + 32), detail::loadLE<double>(at + 40) };
+        request.distance = detail::loadLE<double>(at + 48);
+        generated.dropoffPosition = GeoPoint{ detail::loadLE<double>(at + 56), detail::loadLE<double>(at + 64) };
+        trace.requests.push_back(generated);
+    });
+    return trace;
+}
+
+} // namespace traffic_trace
+
+#endif // RIDE_SHARING_LOAD_GENERATOR_H
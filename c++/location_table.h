@@ -0,0 +1,107 @@
+#ifndef RIDE_SHARING_LOCATION_TABLE_H
+#define RIDE_SHARING_LOCATION_TABLE_H
+
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <memory>
+#include <atomic>
+#include <mutex>
+#include <shared_mutex>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+
+// Compact ID of an interned location name
+using LocationID = std::uint32_t;
+
+/**
+ * @brief LocationTable class - interns location names to 32-bit IDs
+ * Each distinct name is stored once; rides keep only the IDs. Names live in
+ * fixed-size chunks that never move, so name() is lock-free and the references
+ * it returns stay valid for the lifetime of the table.
+ */
+class LocationTable {
+public:
+    static constexpr std::size_t chunkSize = 4096;
+    static constexpr std::size_t maxChunks = 1024;
+
+private:
+    std::unique_ptr<std::string[]> chunks[maxChunks];
+    std::atomic<std::uint32_t> count;
+    std::unordered_map<std::string_view, LocationID> ids;
+    mutable std::shared_mutex mutex;
+
+    const std::string& slot(LocationID id) const {
+        return chunks[id / chunkSize][id % chunkSize];
+    }
+
+public:
+    LocationTable() : count(0) {}
+
+    LocationTable(const LocationTable&) = delete;
+    LocationTable& operator=(const LocationTable&) = delete;
+
+    // Table used by Ride for all pickup/dropoff names
+    static LocationTable& global() {
+        static LocationTable table;
+        return table;
+    }
+
+    // Returns the ID of name, adding it on first sight
+    LocationID intern(std::string_view name) {
+        {
+            std::shared_lock<std::shared_mutex> lock(mutex);
+            auto it = ids.find(name);
+            if (it != ids.end()) {
+                return it->second;
+            }
+        }
+
+        std::unique_lock<std::shared_mutex> lock(mutex);
+        auto it = ids.find(name);
+        if (it != ids.end()) {
+            return it->second;
+        }
+
+        const std::uint32_t id = count.load(std::memory_order_relaxed);
+        if (id >= chunkSize * maxChunks) {
+            throw std::length_error("Location table is full");
+        }
+        auto& chunk = chunks[id / chunkSize];
+        if (!chunk) {
+            chunk.reset(new std::string[chunkSize]);
+        }
+        std::string& stored = chunk[id % chunkSize];
+        stored.assign(name.data(), name.size());
+        ids.emplace(std::string_view(stored), id);
+        count.store(id + 1, std::memory_order_release);
+        return id;
+    }
+
+    // Looks up an existing name without inserting it
+    bool find(std::string_view name, LocationID& id) const {
+        std::shared_lock<std::shared_mutex> lock(mutex);
+        auto it = ids.find(name);
+        if (it == ids.end()) {
+            return false;
+        }
+        id = it->second;
+        return true;
+    }
+
+    bool contains(LocationID id) const {
+        return id < count.load(std::memory_order_acquire);
+    }
+
+    const std::string& name(LocationID id) const {
+        if (!contains(id)) {
+            throw std::out_of_range("Unknown location ID");
+        }
+        return slot(id);
+    }
+
+    std::size_t size() const { return count.load(std::memory_order_acquire); }
+};
+
+#endif // RIDE_SHARING_LOCATION_TABLE_H
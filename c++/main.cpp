@@ -1,181 +1,60 @@
 #include <iostream>
 #include <vector>
 #include <string>
+#include <string_view>
 #include <memory>
 #include <iomanip>
 #include <stdexcept>
 #include <algorithm>
-
-/**
- * @brief Base Ride class that holds core ride details
- * Demonstrates encapsulation by keeping ride details private
- */
-class Ride {
-protected:
-    int rideID;
-    std::string pickupLocation;
-    std::string dropoffLocation;
-    double distance;
-    double fare;
-
-public:
-    Ride(int id, const std::string& pickup, const std::string& dropoff, double dist)
-        : rideID(id), pickupLocation(pickup), dropoffLocation(dropoff), distance(dist), fare(0.0) {
-        if (dist <= 0) {
-            throw std::invalid_argument("Distance must be greater than 0");
-        }
-    }
-
-    virtual ~Ride() = default;
-
-    // Pure virtual function to be implemented by derived classes
-    virtual void calculateFare() = 0;
-
-    // Virtual function that can be overridden by derived classes
-    virtual void rideDetails() const {
-        std::cout << "Ride ID: " << rideID
-                  << "\nPickup: " << pickupLocation
-                  << "\nDropoff: " << dropoffLocation
-                  << "\nDistance: " << distance << " miles"
-                  << "\nFare: $" << std::fixed << std::setprecision(2) << fare;
-    }
-
-    double getFare() const { return fare; }
-    int getRideID() const { return rideID; }
-    const std::string& getPickupLocation() const { return pickupLocation; }
-    const std::string& getDropoffLocation() const { return dropoffLocation; }
-    double getDistance() const { return distance; }
-};
-
-/**
- * @brief StandardRide class - demonstrates inheritance from Ride
- * Implements basic fare calculation
- */
-class StandardRide : public Ride {
-public:
-    StandardRide(int id, const std::string& pickup, const std::string& dropoff, double dist)
-        : Ride(id, pickup, dropoff, dist) {}
-
-    // Override the calculateFare method - demonstrates polymorphism
-    void calculateFare() override {
-        fare = distance * 1.50; // $1.50 per mile
-    }
-
-    // Override the rideDetails method - demonstrates polymorphism
-    void rideDetails() const override {
-        Ride::rideDetails();
-        std::cout << " (Standard Ride)" << std::endl;
-    }
-};
-
-/**
- * @brief PremiumRide class - demonstrates inheritance from Ride
- * Implements premium fare calculation
- */
-class PremiumRide : public Ride {
-public:
-    PremiumRide(int id, const std::string& pickup, const std::string& dropoff, double dist)
-        : Ride(id, pickup, dropoff, dist) {}
-
-    // Override the calculateFare method - demonstrates polymorphism
-    void calculateFare() override {
-        fare = distance * 3.00; // $3.00 per mile
-    }
-
-    // Override the rideDetails method - demonstrates polymorphism
-    void rideDetails() const override {
-        Ride::rideDetails();
-        std::cout << " (Premium Ride)" << std::endl;
-    }
-};
-
-/**
- * @brief Driver class - demonstrates encapsulation
- * Keeps driver details private and provides public methods for access
- */
-class Driver {
-private:
-    int driverID;
-    std::string name;
-    double rating;
-    std::vector<std::shared_ptr<Ride> > assignedRides;
-
-public:
-    Driver(int id, const std::string& name, double rating)
-        : driverID(id), name(name), rating(rating) {
-        if (rating < 0 || rating > 5) {
-            throw std::invalid_argument("Rating must be between 0 and 5");
-        }
-    }
-
-    void addRide(const std::shared_ptr<Ride>& ride) {
-        if (!ride) {
-            throw std::invalid_argument("Invalid ride pointer");
-        }
-        assignedRides.push_back(ride);
-    }
-
-    void getDriverInfo() const {
-        std::cout << "Driver ID: " << driverID
-                  << "\nName: " << name
-                  << "\nRating: " << std::fixed << std::setprecision(2) << rating
-                  << "\nCompleted Rides: " << assignedRides.size() << std::endl;
-    }
-
-    int getDriverID() const { return driverID; }
-    const std::string& getName() const { return name; }
-    double getRating() const { return rating; }
-};
-
-/**
- * @brief Rider class - demonstrates encapsulation
- * Keeps rider details private and provides public methods for access
- */
-class Rider {
-private:
-    int riderID;
-    std::string name;
-    std::vector<std::shared_ptr<Ride> > requestedRides;
-
-public:
-    Rider(int id, const std::string& name)
-        : riderID(id), name(name) {}
-
-    void requestRide(const std::shared_ptr<Ride>& ride) {
-        if (!ride) {
-            throw std::invalid_argument("Invalid ride pointer");
-        }
-        requestedRides.push_back(ride);
-    }
-
-    void viewRides() const {
-        std::cout << "Rider ID: " << riderID
-                  << "\nName: " << name
-                  << "\nRequested Rides History:" << std::endl;
-        
-        if (requestedRides.empty()) {
-            std::cout << "No rides requested yet." << std::endl;
-            return;
-        }
-
-        for (const auto& ride : requestedRides) {
-            ride->rideDetails();
-        }
-    }
-
-    int getRiderID() const { return riderID; }
-    const std::string& getName() const { return name; }
-};
+#include <thread>
+#include <mutex>
+#include <chrono>
+#include <sstream>
+#include <cstdio>
+#include <filesystem>
+
+#include "ride.h"
+#include "driver.h"
+#include "rider.h"
+#include "ride_pool.h"
+#include "ride_registry.h"
+#include "ride_batch.h"
+#include "fare_kernel.h"
+#include "ride_value.h"
+#include "location_table.h"
+#include "driver_index.h"
+#include "request_queue.h"
+#include "dispatcher.h"
+#include "ride_writer.h"
+#include "ride_binary.h"
+#include "ride_history_store.h"
+#include "durable_registry.h"
+#include "surge_pricing.h"
+#include "quote_cache.h"
+#include "distance_provider.h"
+#include "ride_ingest.h"
+#include "metrics.h"
+#include "participant_registry.h"
+#include "ride_analytics.h"
+#include "batch_matcher.h"
+#include "pool_route.h"
+#include "driver_locations.h"
+#include "request_pipeline.h"
+#include "shard_node.h"
+#include "load_generator.h"
 
 int main() {
     try {
         std::cout << "=== Testing Common Scenarios ===\n" << std::endl;
 
+        RidePool pool;
+        RideRegistry registry;
+
         // Test Scenario 1: Basic ride creation and fare calculation
         std::cout << "Test 1: Basic Ride Creation" << std::endl;
         std::cout << "------------------------" << std::endl;
-        auto standardRide = std::make_shared<StandardRide>(1, "Home", "Work", 5.0);
-        auto premiumRide = std::make_shared<PremiumRide>(2, "Home", "Airport", 15.0);
+        RideHandle standardRide = pool.create<StandardRide>(1, "Home", "Work", 5.0);
+        RideHandle premiumRide = pool.create<PremiumRide>(2, "Home", "Airport", 15.0);
         
         standardRide->calculateFare();
         premiumRide->calculateFare();
@@ -189,13 +68,13 @@ int main() {
         // Test Scenario 2: Driver with multiple rides
         std::cout << "Test 2: Driver with Multiple Rides" << std::endl;
         std::cout << "------------------------" << std::endl;
-        Driver driver(101, "John Doe", 4.8);
+        Driver driver(101, "John Doe", 4.8, registry);
         
-        auto ride1 = std::make_shared<StandardRide>(3, "Downtown", "Mall", 3.0);
-        auto ride2 = std::make_shared<PremiumRide>(4, "Mall", "Airport", 12.0);
+        RideIndex ride1 = registry.create<StandardRide>(3, "Downtown", "Mall", 3.0);
+        RideIndex ride2 = registry.create<PremiumRide>(4, "Mall", "Airport", 12.0);
         
-        ride1->calculateFare();
-        ride2->calculateFare();
+        registry[ride1].calculateFare();
+        registry[ride2].calculateFare();
         
         driver.addRide(ride1);
         driver.addRide(ride2);
@@ -206,13 +85,13 @@ int main() {
         // Test Scenario 3: Rider with ride history
         std::cout << "Test 3: Rider with Ride History" << std::endl;
         std::cout << "------------------------" << std::endl;
-        Rider rider(201, "Alice");
+        Rider rider(201, "Alice", registry);
         
-        auto ride3 = std::make_shared<StandardRide>(5, "Home", "Gym", 2.0);
-        auto ride4 = std::make_shared<PremiumRide>(6, "Gym", "Restaurant", 4.0);
+        RideIndex ride3 = registry.create<StandardRide>(5, "Home", "Gym", 2.0);
+        RideIndex ride4 = registry.create<PremiumRide>(6, "Gym", "Restaurant", 4.0);
         
-        ride3->calculateFare();
-        ride4->calculateFare();
+        registry[ride3].calculateFare();
+        registry[ride4].calculateFare();
         
         rider.requestRide(ride3);
         rider.requestRide(ride4);
@@ -223,9 +102,9 @@ int main() {
         // Test Scenario 4: Polymorphism demonstration
         std::cout << "Test 4: Polymorphism Demonstration" << std::endl;
         std::cout << "------------------------" << std::endl;
-        std::vector<std::shared_ptr<Ride> > mixedRides;
-        mixedRides.push_back(std::make_shared<StandardRide>(7, "Point A", "Point B", 8.0));
-        mixedRides.push_back(std::make_shared<PremiumRide>(8, "Point C", "Point D", 8.0));
+        std::vector<RideHandle> mixedRides;
+        mixedRides.push_back(pool.create<StandardRide>(7, "Point A", "Point B", 8.0));
+        mixedRides.push_back(pool.create<PremiumRide>(8, "Point C", "Point D", 8.0));
         
         std::cout << "Same distance (8 miles), different ride types:" << std::endl;
         for (const auto& ride : mixedRides) {
@@ -244,12 +123,727 @@ int main() {
         }
 
         try {
-            auto invalidRide = std::make_shared<StandardRide>(9, "Start", "End", -5.0); // Should throw exception
+            pool.create<StandardRide>(9, "Start", "End", -5.0); // Should throw exception
         } catch (const std::exception& e) {
             std::cout << "Caught expected error: " << e.what() << std::endl;
         }
         std::cout << std::endl;
 
+        // Test Scenario 6: Batch fare calculation over a columnar store
+        std::cout << "Test 6: Batch Fare Calculation" << std::endl;
+        std::cout << "------------------------" << std::endl;
+        RideBatch batch;
+        for (const auto& ride : mixedRides) {
+            batch.addRide(ride->getRideID(), ride->getDistance(), ride->getRideType());
+        }
+        batch.addRide(10, 5.0, RideType::Standard);
+        batch.addRide(11, 15.0, RideType::Premium);
+        calculateFares(batch);
+
+        std::cout << "Batch priced " << batch.size() << " rides:" << std::endl;
+        for (std::size_t i = 0; i < batch.size(); ++i) {
+            std::cout << "Ride ID: " << batch.getRideID(i)
+                      << " Fare: $" << std::fixed << std::setprecision(2) << batch.getFare(i) << std::endl;
+        }
+        bool batchMatches = batch.getFare(0) == mixedRides[0]->getFare()
+                         && batch.getFare(1) == mixedRides[1]->getFare();
+        std::cout << "Batch fares match virtual fares: " << (batchMatches ? "yes" : "no") << std::endl;
+
+        RideBatch vectorBatch = batch;
+        calculateFaresVectorized(vectorBatch);
+        bool kernelMatches = true;
+        for (std::size_t i = 0; i < batch.size(); ++i) {
+            kernelMatches = kernelMatches && vectorBatch.getFare(i) == batch.getFare(i);
+        }
+        std::cout << "Vectorized kernel (" << fareKernelName(detectFareKernel()) << ") matches: "
+                  << (kernelMatches ? "yes" : "no") << std::endl;
+        std::cout << std::endl;
+
+        // Test Scenario 7: Releasing a dispatch epoch from the ride pool
+        std::cout << "Test 7: Ride Pool Epochs" << std::endl;
+        std::cout << "------------------------" << std::endl;
+        RidePool::EpochID rushHour = pool.beginEpoch();
+        pool.reserve<StandardRide>(1000);
+        for (int i = 0; i < 1000; ++i) {
+            RideHandle ride = pool.create<StandardRide>(1000 + i, "Station", "Office", 2.0);
+            ride->calculateFare();
+        }
+        std::cout << "Live rides before release: " << pool.liveRideCount() << std::endl;
+        pool.releaseEpoch(rushHour);
+        std::cout << "Live rides after release: " << pool.liveRideCount()
+                  << " (" << pool.freeChunkCount() << " chunks recycled)" << std::endl;
+        std::cout << std::endl;
+
+        // Test Scenario 8: Value rides priced without virtual dispatch
+        std::cout << "Test 8: Value Ride Types" << std::endl;
+        std::cout << "------------------------" << std::endl;
+        std::vector<RideValue> valueRides;
+        for (const auto& ride : mixedRides) {
+            valueRides.push_back(toRideValue(*ride));
+        }
+        valueRides.push_back(StandardRideValue(12, "Home", "Park", 1.0));
+        calculateFares(valueRides);
+        for (const auto& ride : valueRides) {
+            rideDetails(ride);
+        }
+        bool valuesMatch = getFare(valueRides[0]) == mixedRides[0]->getFare()
+                        && getFare(valueRides[1]) == mixedRides[1]->getFare()
+                        && toRide(valueRides[1])->getFare() == mixedRides[1]->getFare();
+        std::cout << "Value fares match virtual fares: " << (valuesMatch ? "yes" : "no") << std::endl;
+        std::cout << std::endl;
+
+        // Test Scenario 9: Interned pickup/dropoff locations
+        std::cout << "Test 9: Interned Locations" << std::endl;
+        std::cout << "------------------------" << std::endl;
+        LocationID home = LocationTable::global().intern("Home");
+        int homePickups = 0;
+        for (const RideHandle& ride : { standardRide, premiumRide }) {
+            homePickups += ride->getPickupLocationID() == home ? 1 : 0;
+        }
+        std::cout << "Distinct locations: " << LocationTable::global().size() << std::endl;
+        std::cout << "Location ID " << home << " (" << LocationTable::global().name(home) << ") used by "
+                  << homePickups << " pickups in Test 1" << std::endl;
+        std::cout << std::endl;
+
+        // Test Scenario 10: Nearest available driver matching
+        std::cout << "Test 10: Nearest Driver Matching" << std::endl;
+        std::cout << "------------------------" << std::endl;
+        DriverIndex driverIndex;
+        Driver nearbyDriver(104, "Carol White", 3.0);
+        Driver topDriver(105, "Dave Brown", 5.0);
+        Driver busyDriver(106, "Eve Black", 4.9);
+        driverIndex.updatePosition(driver, GeoPoint{ 40.7580, -73.9855 });
+        driverIndex.updatePosition(nearbyDriver, GeoPoint{ 40.7484, -73.9857 });
+        driverIndex.updatePosition(topDriver, GeoPoint{ 40.7527, -73.9772 });
+        driverIndex.updatePosition(busyDriver, GeoPoint{ 40.7490, -73.9860 });
+        driverIndex.setAvailable(busyDriver.getDriverID(), false);
+
+        const GeoPoint pickup{ 40.7484, -73.9840 };
+        for (const DriverMatch& match : driverIndex.nearestAvailable(pickup, 2)) {
+            std::cout << "Driver ID: " << match.driverID
+                      << " Distance: " << std::setprecision(2) << match.distanceKm << " km"
+                      << " Score: " << match.score << std::endl;
+        }
+        std::cout << std::endl;
+
+        // Test Scenario 11: Concurrent request ingestion
+        std::cout << "Test 11: Request Ingestion Queue" << std::endl;
+        std::cout << "------------------------" << std::endl;
+        RequestQueue requestQueue(2, 64);
+        std::vector<std::thread> producers;
+        for (int p = 0; p < 2; ++p) {
+            producers.emplace_back([&requestQueue, p]() {
+                for (int i = 0; i < 50; ++i) {
+                    RideRequest request{};
+                    request.requestID = static_cast<std::uint64_t>(p * 50 + i);
+                    request.riderID = 201;
+                    request.type = RideType::Standard;
+                    request.distance = 1.0;
+                    requestQueue.tryPush(request);
+                }
+            });
+        }
+        for (auto& producer : producers) {
+            producer.join();
+        }
+        std::vector<RideRequest> drained;
+        while (requestQueue.drainBatch(drained, 32) > 0) {
+        }
+        RequestQueueStats queueStats = requestQueue.stats();
+        std::cout << "Drained " << drained.size() << " of " << queueStats.pushed << " requests"
+                  << " (rejected: " << queueStats.rejected << ")" << std::endl;
+        std::cout << std::endl;
+
+        // Test Scenario 12: Parallel dispatch of queued requests
+        std::cout << "Test 12: Parallel Dispatch" << std::endl;
+        std::cout << "------------------------" << std::endl;
+        Driver uptownDriver(107, "Frank Green", 4.7, registry);
+        Driver downtownDriver(108, "Grace Hall", 4.9, registry);
+        ParallelDispatcher dispatcher(2);
+        dispatcher.updateDriver(uptownDriver, GeoPoint{ 40.7812, -73.9665 });
+        dispatcher.updateDriver(downtownDriver, GeoPoint{ 40.7075, -74.0113 });
+
+        RideRequest uptownRequest{ 1, rider.getRiderID(), LocationTable::global().intern("Museum"),
+                                   LocationTable::global().intern("Park"), RideType::Standard,
+                                   GeoPoint{ 40.7794, -73.9632 }, 2.5 };
+        RideRequest downtownRequest{ 2, rider.getRiderID(), LocationTable::global().intern("Wall Street"),
+                                     LocationTable::global().intern("Ferry"), RideType::Premium,
+                                     GeoPoint{ 40.7060, -74.0088 }, 1.5 };
+        // Rides are created and priced up front, so the worker that wins a driver records it
+        const RideIndex uptownRide = registry.create<StandardRide>(101, uptownRequest.pickupLocation,
+                                                                   uptownRequest.dropoffLocation, uptownRequest.distance);
+        const RideIndex downtownRide = registry.create<PremiumRide>(102, downtownRequest.pickupLocation,
+                                                                    downtownRequest.dropoffLocation,
+                                                                    downtownRequest.distance);
+        registry[uptownRide].calculateFare();
+        registry[downtownRide].calculateFare();
+        dispatcher.submit(uptownRequest, uptownRide);
+        dispatcher.submit(downtownRequest, downtownRide);
+        DispatchResult dispatched = dispatcher.dispatch();
+
+        for (const Assignment& assignment : dispatched.assignments) {
+            const Driver& assigned = assignment.driverID == uptownDriver.getDriverID() ? uptownDriver : downtownDriver;
+            std::cout << "Request " << assignment.requestID << " -> Driver " << assignment.driverID
+                      << " (" << assigned.getName() << ", " << assignment.distanceKm << " km away, "
+                      << assigned.getAssignedRides().size() << " ride recorded by its worker)" << std::endl;
+        }
+        std::cout << "Unassigned requests: " << dispatched.unassigned.size() << std::endl;
+        std::cout << std::endl;
+
+        // Test Scenario 13: Buffered output without per-line flushes
+        std::cout << "Test 13: Buffered Ride Output" << std::endl;
+        std::cout << "------------------------" << std::endl;
+        std::string exported;
+        rider.viewRides(exported);
+        uptownDriver.getDriverInfo(exported);
+        writeRides(registry, uptownDriver.getAssignedRides(), exported);
+        std::cout.write(exported.data(), static_cast<std::streamsize>(exported.size()));
+        std::cout << std::endl;
+
+        // Test Scenario 14: Binary round trip of rides, drivers and riders
+        std::cout << "Test 14: Binary Serialization" << std::endl;
+        std::cout << "------------------------" << std::endl;
+        std::stringstream stored;
+        {
+            ride_binary::Writer writer(stored);
+            writer.writeLocations(LocationTable::global());
+            writer.writeRides(registry);
+            writer.beginDrivers(2);
+            writer.writeDriver(driver);
+            writer.writeDriver(uptownDriver);
+            writer.beginRiders(1);
+            writer.writeRider(rider);
+        }
+        std::cout << "Encoded " << registry.size() << " rides in " << stored.str().size() << " bytes" << std::endl;
+
+        RideRegistry restoredRides;
+        std::vector<Driver> restoredDrivers;
+        std::vector<Rider> restoredRiders;
+        ride_binary::Reader reader(stored);
+        ride_binary::SectionHeader section;
+        while (reader.nextSection(section)) {
+            switch (section.kind) {
+                case ride_binary::SectionKind::Locations: reader.readLocations(LocationTable::global()); break;
+                case ride_binary::SectionKind::Rides: reader.readRides(restoredRides); break;
+                case ride_binary::SectionKind::Drivers: reader.readDrivers(restoredRides, restoredDrivers); break;
+                case ride_binary::SectionKind::Riders: reader.readRiders(restoredRides, restoredRiders); break;
+            }
+        }
+        bool roundTrip = restoredRides.size() == registry.size();
+        for (RideIndex i = 0; roundTrip && i < registry.size(); ++i) {
+            roundTrip = restoredRides[i].getFare() == registry[i].getFare()
+                     && restoredRides[i].getPickupLocation() == registry[i].getPickupLocation()
+                     && restoredRides[i].getCompletedAt() == registry[i].getCompletedAt();
+        }
+        std::cout << "Restored " << restoredDrivers.size() << " drivers and " << restoredRiders.size()
+                  << " riders; rides identical: " << (roundTrip ? "yes" : "no") << std::endl;
+        restoredRiders.front().viewRides();
+        std::cout << std::endl;
+
+        // Test Scenario 15: Memory-mapped ride history
+        std::cout << "Test 15: Memory-Mapped Ride History" << std::endl;
+        std::cout << "------------------------" << std::endl;
+        const std::string historyPath = "ride_history_demo.bin";
+        std::remove(historyPath.c_str());
+        std::remove((historyPath + ".loc").c_str());
+        {
+            RideHistoryStore history(historyPath);
+            for (RideIndex ride : rider.getRequestedRides()) {
+                history.appendRiderRide(rider.getRiderID(), registry[ride]);
+            }
+            for (RideIndex ride : driver.getAssignedRides()) {
+                history.appendDriverRide(driver.getDriverID(), registry[ride]);
+            }
+        }
+        {
+            RideHistoryStore reopened(historyPath);
+            std::cout << "Reopened store with " << reopened.size() << " records" << std::endl;
+            rider.viewRides(reopened);
+            std::cout << "Driver " << driver.getDriverID() << " history: "
+                      << reopened.driverHistory(driver.getDriverID()).size() << " rides" << std::endl;
+        }
+        std::remove(historyPath.c_str());
+        std::remove((historyPath + ".loc").c_str());
+        std::cout << std::endl;
+
+        // Test Scenario 16: Write-ahead log and snapshot recovery
+        std::cout << "Test 16: WAL and Snapshot Recovery" << std::endl;
+        std::cout << "------------------------" << std::endl;
+        const std::string durableDir = "durable_demo";
+        std::filesystem::remove_all(durableDir);
+        {
+            DurableRegistry durable(durableDir);
+            durable.addDriver(201, "Grace", 4.7);
+            durable.addRider(301, "Hopper");
+            RideIndex first = durable.createRide(RideType::Standard, 21, "Airport", "Harbor", 12.0);
+            const std::int64_t twoDaysAgo = currentTimestamp() - 2 * 86400;
+            durable.assignRide(201, first, twoDaysAgo);
+            durable.requestRide(301, first, twoDaysAgo);
+            durable.commit();
+            durable.snapshot();
+            RideIndex second = durable.createRide(RideType::Premium, 22, "Harbor", "Stadium", 4.5);
+            durable.assignRide(201, second);
+            durable.requestRide(301, second);
+            durable.commit();
+        }
+        {
+            DurableRegistry recovered(durableDir);
+            const DurableRegistry::RecoveryStats& stats = recovered.getRecoveryStats();
+            std::cout << "Recovered generation " << stats.generation << ": " << stats.snapshotRides
+                      << " rides from snapshot, " << stats.replayedEntries << " log entries replayed" << std::endl;
+            recovered.getRider(301).viewRides();
+            const RideStats& recoveredStats = recovered.getDriver(201).getStats();
+            std::cout << "Driver 201: " << recoveredStats.lastDay().count << " of " << recoveredStats.getRideCount()
+                      << " rides in the last day" << std::endl;
+        }
+        std::filesystem::remove_all(durableDir);
+        std::cout << std::endl;
+
+        // Test Scenario 17: Incremental earnings and rolling windows
+        std::cout << "Test 17: Driver Earnings Aggregates" << std::endl;
+        std::cout << "------------------------" << std::endl;
+        Driver earner(109, "Edsger", 4.9, registry);
+        const std::int64_t now = currentTimestamp();
+        const std::int64_t offsets[] = { 26 * 3600, 5 * 3600, 20 * 60, 0 };
+        for (int i = 0; i < 4; ++i) {
+            RideIndex ride = i % 2 == 0
+                ? registry.create<StandardRide>(40 + i, "Depot", "Market", 2.0 + i)
+                : registry.create<PremiumRide>(40 + i, "Market", "Depot", 2.0 + i);
+            registry[ride].calculateFare();
+            earner.addRide(ride, now - offsets[i]);
+        }
+        const RideStats& earnings = earner.getStats();
+        std::cout << std::fixed << std::setprecision(2)
+                  << "Lifetime: " << earnings.getRideCount() << " rides, $" << earnings.getTotalFare()
+                  << ", avg " << earnings.getAverageDistance() << " miles ("
+                  << earnings.getRideCount(RideType::Standard) << " standard, "
+                  << earnings.getRideCount(RideType::Premium) << " premium)" << std::endl;
+        std::cout << "Last hour: " << earnings.lastHour(now).count << " rides, $" << earnings.lastHour(now).fare
+                  << "; last day: " << earnings.lastDay(now).count << " rides, $" << earnings.lastDay(now).fare
+                  << std::endl;
+        earner.getDriverInfo();
+        std::cout << std::endl;
+
+        // Test Scenario 18: Surge pricing
+        std::cout << "Test 18: Surge Pricing" << std::endl;
+        std::cout << "------------------------" << std::endl;
+        SurgePricing surge(LocationTable::global().size() + 16);
+        const LocationID stadium = LocationTable::global().intern("Stadium");
+        surge.update(stadium, 30, 10, now);
+        RideIndex surged = registry.create<StandardRide>(50, "Stadium", "Downtown", 4.0);
+        RideIndex calm = registry.create<StandardRide>(51, "Downtown", "Stadium", 4.0);
+        const double surgedMultiplier = surge.priceRide(registry[surged], now);
+        const double calmMultiplier = surge.priceRide(registry[calm], now);
+        std::cout << "Stadium pickup x" << surgedMultiplier << ": $" << registry[surged].getFare()
+                  << "; Downtown pickup x" << calmMultiplier << ": $" << registry[calm].getFare() << std::endl;
+        std::cout << "After TTL: x" << surge.quote(stadium, now + surge.getPolicy().ttlSeconds).multiplier
+                  << std::endl;
+        std::cout << std::endl;
+
+        // Test Scenario 19: Quote cache
+        std::cout << "Test 19: Quote Cache" << std::endl;
+        std::cout << "------------------------" << std::endl;
+        QuoteCache quotes(1024);
+        int distanceLookups = 0;
+        FareQuoter quoter(surge, quotes, [&](LocationID, LocationID) {
+            ++distanceLookups;
+            return 4.0;
+        });
+        for (int i = 0; i < 3; ++i) {
+            quoter.quote("Stadium", "Downtown", RideType::Standard, now);
+            quoter.quote("Downtown", "Stadium", RideType::Premium, now);
+        }
+        surge.update(stadium, 50, 10, now);
+        const FareQuote repriced = quoter.quote("Stadium", "Downtown", RideType::Standard, now);
+        const QuoteCacheStats cacheStats = quotes.stats();
+        std::cout << "Repriced quote after surge change: x" << repriced.multiplier << " $" << repriced.fare
+                  << std::endl;
+        std::cout << cacheStats.hits << " hits, " << cacheStats.misses << " misses ("
+                  << distanceLookups << " distance lookups), hit rate "
+                  << cacheStats.hitRate() * 100 << "%" << std::endl;
+        std::cout << std::endl;
+
+        // Test Scenario 20: Distance provider
+        std::cout << "Test 20: Road Distances" << std::endl;
+        std::cout << "------------------------" << std::endl;
+        RoadGraph roads;
+        roads.addRoad("Home", "Bridge", 1.5);
+        roads.addRoad("Bridge", "Downtown", 2.0);
+        roads.addRoad("Home", "Ring Road", 2.5);
+        roads.addRoad("Ring Road", "Downtown", 2.5);
+        roads.addRoad("Downtown", "Airport", 9.0);
+        roads.addRoad("Ring Road", "Airport", 8.0);
+        roads.contract();
+        LocationTable& places = LocationTable::global();
+        const std::vector<LocationID> hot = { places.intern("Home"), places.intern("Downtown") };
+        DistanceMatrix hotPairs(hot, roads);
+        TieredDistanceProvider distances(hotPairs, roads);
+        RideIndex routed = createRide<StandardRide>(registry, distances, 60, "Home", "Airport");
+        registry[routed].calculateFare();
+        registry[routed].rideDetails();
+        std::cout << std::endl;
+        std::vector<double> table;
+        distances.distances(hot, { places.intern("Airport"), places.intern("Bridge") }, table);
+        std::cout << "Home->Downtown " << distances.distance(hot[0], hot[1]) << " miles; to Airport/Bridge: "
+                  << table[0] << "/" << table[1] << " and " << table[2] << "/" << table[3] << std::endl;
+        std::cout << std::endl;
+
+        // Test Scenario 21: Validation without exceptions
+        std::cout << "Test 21: Non-Throwing Validation" << std::endl;
+        std::cout << "------------------------" << std::endl;
+        Result<Driver> rejectedDriver = Driver::tryCreate(110, "Invalid", 6.0, registry);
+        Result<RideIndex> rejectedRide = registry.tryCreate<StandardRide>(61, "Start", "End", -5.0);
+        std::cout << "Driver rejected: " << rejectedDriver.message() << std::endl;
+        std::cout << "Ride rejected: " << rejectedRide.message() << std::endl;
+        const LocationID depot = places.intern("Depot");
+        const std::vector<RawRideRecord> feed = {
+            { 62, depot, hot[0], RideType::Standard, 3.0 },
+            { 63, depot, hot[1], RideType::Premium, -1.0 },
+            { 64, depot, 0xFFFFFFFFu, RideType::Standard, 2.0 },
+            { 65, hot[1], depot, RideType::Premium, 6.0 }
+        };
+        const IngestReport ingested = ingestRides(registry, feed);
+        std::cout << "Ingested " << ingested.accepted << " of " << feed.size() << " rows" << std::endl;
+        for (const auto& [row, error] : ingested.rejected) {
+            std::cout << "Row " << row << " rejected: " << validationMessage(error) << std::endl;
+        }
+        std::cout << std::endl;
+
+        // Test Scenario 22: In-place construction from a wire buffer
+        std::cout << "Test 22: Emplacing Rides" << std::endl;
+        std::cout << "------------------------" << std::endl;
+        const std::string wire = "Central Station|Harbor";
+        const std::string_view pickupName = std::string_view(wire).substr(0, wire.find('|'));
+        const std::string_view dropoffName = std::string_view(wire).substr(wire.find('|') + 1);
+        Driver courier(111, std::string("Barbara"), 4.6, registry);
+        courier.emplaceRide<PremiumRide>(registry, 70, pickupName, dropoffName, 3.5);
+        courier.getDriverInfo();
+        std::cout << std::endl;
+
+        // Test Scenario 23: Hot-path metrics
+        std::cout << "Test 23: Ride Lifecycle Metrics" << std::endl;
+        std::cout << "-------------------------------" << std::endl;
+#if RIDE_SHARING_METRICS
+        const metrics::MetricsSnapshot scraped = metrics::Registry::global().scrape();
+        std::cout << "Rides created: " << scraped.counter(metrics::Counter::RidesCreated)
+                  << "\nFares calculated: " << scraped.counter(metrics::Counter::FaresCalculated)
+                  << "\nDriver matches: " << scraped.counter(metrics::Counter::DriverMatches)
+                  << "\nFare calculation p99: " << std::setprecision(0)
+                  << scraped.histogram(metrics::Histogram::FareCalculation).quantileSeconds(0.99) * 1e9
+                  << " ns" << std::endl;
+        const std::string exposition = metrics::Registry::global().prometheus();
+        std::cout << exposition.substr(0, exposition.find('\n', exposition.find('\n') + 1) + 1);
+#else
+        std::cout << "Metrics are compiled out; configure with -DRIDE_SHARING_ENABLE_METRICS=ON" << std::endl;
+#endif
+        std::cout << std::endl;
+
+        // Test Scenario 24: Looking drivers and riders up by ID
+        std::cout << "Test 24: Driver and Rider Registries" << std::endl;
+        std::cout << "------------------------------------" << std::endl;
+        DriverRegistry fleet(registry);
+        RiderRegistry customers(registry);
+        fleet.add(201, "Hannah", 4.9, GeoPoint{ 40.7580, -73.9855 });
+        fleet.add(202, "Ivan", 4.4, GeoPoint{ 40.7484, -73.9857 }, false);
+        customers.add(301, "Julia");
+        const RideIndex lookedUp = registry.create<StandardRide>(80, "Times Square", "Empire State", 1.2);
+        registry[lookedUp].calculateFare();
+        fleet.get(201).addRide(lookedUp);
+        customers.get(301).requestRide(lookedUp);
+        fleet.setAvailable(201, false);
+        fleet.setAvailable(202, true);
+        for (int id : { 201, 202, 203 }) {
+            const DriverStatus* status = fleet.status(id);
+            if (status == nullptr) {
+                std::cout << "Driver " << id << ": not registered" << std::endl;
+                continue;
+            }
+            std::cout << "Driver " << id << " (" << fleet.get(id).getName() << "): "
+                      << (status->available ? "available" : "busy") << ", "
+                      << fleet.get(id).getAssignedRides().size() << " ride(s)" << std::endl;
+        }
+        std::cout << "Rider 301 requested " << customers.get(301).getRequestedRides().size() << " ride(s)" << std::endl;
+        std::cout << std::endl;
+
+        // Test Scenario 25: Time-range queries over a driver's history
+        std::cout << "Test 25: Ride Timeline" << std::endl;
+        std::cout << "----------------------" << std::endl;
+        Driver veteran(121, std::string("Kofi"), 4.8, registry);
+        const std::int64_t today = now - now % RideTimeline::daySeconds;
+        for (int day = 0; day < 90; ++day) {
+            const RideIndex past = registry.create<StandardRide>(900 + day, "Airport", "Downtown", 10.0);
+            registry[past].calculateFare();
+            registry[past].markCompleted(today - day * RideTimeline::daySeconds + 3600);
+            veteran.addRide(past, registry[past].getCompletedAt());
+        }
+        const RideTotals lastMonth = veteran.getTimeline().totalsBetween(today - 29 * RideTimeline::daySeconds,
+                                                                         today + RideTimeline::daySeconds);
+        std::cout << "Last 30 days: " << lastMonth.count << " rides, $" << std::setprecision(2) << lastMonth.fare << std::endl;
+        const std::size_t released = veteran.compactTimelineBefore(today - 59 * RideTimeline::daySeconds);
+        const RideTotals quarter = veteran.getTimeline().totalsBetween(today - 89 * RideTimeline::daySeconds,
+                                                                       today + RideTimeline::daySeconds);
+        std::cout << "Compacted " << released << " old entries; last 90 days still totals "
+                  << quarter.count << " rides, $" << quarter.fare << std::endl;
+        std::cout << std::endl;
+
+        // Test Scenario 26: End-of-day analytics
+        std::cout << "Test 26: Ride Analytics" << std::endl;
+        std::cout << "-----------------------" << std::endl;
+        const RideReport report = RideReport::build(registry, 2);
+        std::cout << "Standard revenue: $" << report.revenueByType(RideType::Standard).fare
+                  << "\nPremium revenue: $" << report.revenueByType(RideType::Premium).fare
+                  << "\nMedian distance: " << report.distancePercentile(0.5) << " miles"
+                  << "\n95th percentile distance: " << report.distancePercentile(0.95) << " miles" << std::endl;
+        for (const RouteTotals& route : report.topRoutes(3)) {
+            std::cout << route.getPickupLocation() << " -> " << route.getDropoffLocation() << ": "
+                      << route.totals.count << " rides" << std::endl;
+        }
+        for (const DriverUtilization& usage : driverUtilization(fleet, now - 3600, now + 3600, 20.0, 2)) {
+            std::cout << "Driver " << usage.driverID << " busy " << usage.busyFraction * 100.0 << "% of the window" << std::endl;
+        }
+        std::cout << std::endl;
+
+        // Test Scenario 27: Batched matching round
+        std::cout << "Test 27: Batched Matching" << std::endl;
+        std::cout << "-------------------------" << std::endl;
+        // Greedy in arrival order gives rider 501 driver 401, leaving rider 502 the far driver
+        DriverIndex roundDrivers;
+        roundDrivers.updatePosition(401, 4.9, GeoPoint{ 40.7500, -73.9900 });
+        roundDrivers.updatePosition(402, 4.7, GeoPoint{ 40.7600, -73.9700 });
+        BatchMatcher matcher;
+        RideRequest first{};
+        first.requestID = 1;
+        first.riderID = 501;
+        first.pickupPosition = GeoPoint{ 40.7520, -73.9870 };
+        RideRequest second = first;
+        second.requestID = 2;
+        second.riderID = 502;
+        second.pickupPosition = GeoPoint{ 40.7490, -73.9920 };
+        matcher.submit(first);
+        matcher.submit(second);
+        std::cout << "Window ready: " << (matcher.ready() ? "yes" : "no") << std::endl;
+        const DispatchResult round = matcher.match(roundDrivers);
+        for (const Assignment& assignment : round.assignments) {
+            std::cout << "Rider " << assignment.riderID << " -> Driver " << assignment.driverID << " ("
+                      << std::setprecision(2) << assignment.distanceKm << " km)" << std::endl;
+        }
+        std::cout << "Unassigned: " << round.unassigned.size() << std::endl;
+        std::cout << std::endl;
+
+        // Test Scenario 28: Shared rides on one driver's route
+        std::cout << "Test 28: Pooled Rides" << std::endl;
+        std::cout << "---------------------" << std::endl;
+        Driver poolDriver(131, std::string("Lena"), 4.9, registry);
+        PoolRoute route(GeoPoint{ 40.7505, -73.9934 });
+        struct PoolRequest { int rideID; const char* pickup; const char* dropoff; GeoPoint from; GeoPoint to; };
+        const PoolRequest poolRequests[] = {
+            { 140, "Penn Station", "Union Square", GeoPoint{ 40.7506, -73.9935 }, GeoPoint{ 40.7359, -73.9911 } },
+            { 141, "Herald Square", "Washington Square", GeoPoint{ 40.7497, -73.9877 }, GeoPoint{ 40.7308, -73.9973 } },
+            { 142, "Penn Station", "JFK Airport", GeoPoint{ 40.7506, -73.9935 }, GeoPoint{ 40.6413, -73.7781 } }
+        };
+        std::vector<RideIndex> pooled;
+        for (const PoolRequest& request : poolRequests) {
+            const double miles = distanceKm(request.from, request.to) / 1.609344;
+            const RideIndex ride = registry.create<PooledRide>(request.rideID, request.pickup, request.dropoff, miles);
+            registry[ride].calculateFare();
+            if (route.tryAdd(ride, request.from, request.to)) {
+                pooled.push_back(ride);
+                std::cout << "Ride " << request.rideID << " joins the route (" << route.stopCount() << " stops, "
+                          << std::setprecision(2) << route.remainingKm() << " km)" << std::endl;
+            } else {
+                std::cout << "Ride " << request.rideID << " would break a detour limit" << std::endl;
+            }
+        }
+        while (route.stopCount() > 0) {
+            route.completeNextStop();
+        }
+        route.settleFares(registry, route.getOdometerKm() / 1.609344 * 2.00);
+        for (RideIndex ride : pooled) {
+            poolDriver.addRide(ride);
+            std::cout << "Ride " << registry[ride].getRideID() << " pays $" << registry[ride].getFare() << std::endl;
+        }
+        poolDriver.getDriverInfo();
+        std::cout << std::endl;
+
+        // Test Scenario 29: Streaming driver locations
+        std::cout << "Test 29: Driver Location Stream" << std::endl;
+        std::cout << "-------------------------------" << std::endl;
+        DriverLocationTable locations(8);
+        locations.registerDriver(601, 4.8, GeoPoint{ 40.7580, -73.9855 });
+        locations.registerDriver(602, 4.6, GeoPoint{ 40.7484, -73.9857 });
+        std::thread gps([&locations]() {
+            // Three pings from the same driver between flushes move it in the index once
+            locations.update(601, GeoPoint{ 40.7570, -73.9860 }, true, 1000);
+            locations.update(601, GeoPoint{ 40.7560, -73.9865 }, true, 1003);
+            locations.update(601, GeoPoint{ 40.7550, -73.9870 }, true, 1006);
+            locations.update(602, GeoPoint{ 40.7480, -73.9860 }, true, 1001);
+        });
+        gps.join();
+        // A ping delivered late is older than what the table already holds
+        const bool lateAccepted = locations.update(601, GeoPoint{ 40.7000, -74.0000 }, true, 1002);
+        std::cout << "Late ping accepted: " << (lateAccepted ? "yes" : "no") << std::endl;
+        DriverIndex liveDrivers;
+        const std::size_t flushed = locations.flushTo(liveDrivers);
+        std::cout << locations.pingCount() << " pings, " << flushed << " index updates" << std::endl;
+        const DriverLocation latest = locations.read(601);
+        std::cout << "Driver 601 at " << std::setprecision(4) << latest.position.lat << ", " << latest.position.lon
+                  << " (t=" << latest.timestamp << ")" << std::endl;
+        locations.setAvailable(602, false, 1010);
+        locations.flushTo(liveDrivers);
+        for (const DriverMatch& match : liveDrivers.nearestAvailable(GeoPoint{ 40.7505, -73.9860 }, 2)) {
+            std::cout << "Nearest available: Driver " << match.driverID << " (" << std::setprecision(2)
+                      << match.distanceKm << " km)" << std::endl;
+        }
+        // Matched to a rider: 601's app still reports itself free until it hears of the trip
+        locations.claim(601);
+        locations.update(601, GeoPoint{ 40.7545, -73.9872 }, true, 1012);
+        locations.flushTo(liveDrivers);
+        std::cout << "Available after Driver 601 is matched: "
+                  << liveDrivers.nearestAvailable(GeoPoint{ 40.7505, -73.9860 }, 2).size() << std::endl;
+        locations.release(601);
+        std::cout << std::endl;
+
+        // Test Scenario 30: Coroutine request pipeline
+        std::cout << "Test 30: Request Pipeline" << std::endl;
+        std::cout << "-------------------------" << std::endl;
+        RideRegistry pipelineRides;
+        DriverIndex pipelineIndex;
+        DriverRegistry pipelineDrivers(pipelineRides);
+        RiderRegistry pipelineRiders(pipelineRides);
+        const GeoPoint midtown{ 40.7549, -73.9840 };
+        pipelineDrivers.add(701, "Omar", 4.9, midtown);
+        pipelineDrivers.add(702, "Priya", 4.7, GeoPoint{ 40.7614, -73.9776 });
+        pipelineIndex.updatePosition(701, 4.9, midtown);
+        pipelineDrivers.add(703, "Ines", 4.8, GeoPoint{ 40.7075, -74.0113 });
+        pipelineIndex.updatePosition(702, 4.7, GeoPoint{ 40.7614, -73.9776 });
+        pipelineIndex.updatePosition(703, 4.8, GeoPoint{ 40.7075, -74.0113 });
+        pipelineRiders.add(801, "Noah");
+        pipelineRiders.add(802, "Ava");
+        {
+            EventLoop loop(2);
+            PipelineServices services;
+            services.lookupDistance = [&loop](const RideRequest& request, Completion<double> done) {
+                const double miles = request.distance;
+                loop.after(std::chrono::milliseconds(5), [done, miles]() { done.complete(miles); });
+            };
+            // Omar is busy and never answers; the offer times out and goes to Priya
+            services.offerRide = [&loop](const RideRequest&, int driverID, Completion<bool> done) {
+                if (driverID != 701) {
+                    loop.after(std::chrono::milliseconds(10), [done]() { done.complete(true); });
+                }
+            };
+            PipelineOptions pipelineOptions;
+            pipelineOptions.offerTimeout = std::chrono::milliseconds(50);
+            RequestPipeline pipeline(loop, pipelineRides, pipelineIndex, pipelineDrivers, pipelineRiders,
+                                     services, pipelineOptions);
+            LocationTable& places = LocationTable::global();
+            RideRequest pipelineRequest{};
+            pipelineRequest.requestID = 150;
+            pipelineRequest.riderID = 801;
+            pipelineRequest.pickupLocation = places.intern("Times Square");
+            pipelineRequest.dropoffLocation = places.intern("Central Park");
+            pipelineRequest.type = RideType::Premium;
+            pipelineRequest.pickupPosition = midtown;
+            pipelineRequest.distance = 2.5;
+            std::mutex printLock;
+            const auto report = [&printLock](const PipelineOutcome& outcome) {
+                std::lock_guard<std::mutex> lock(printLock);
+                std::cout << "Request " << outcome.requestID << ": ";
+                if (outcome.status == PipelineStatus::Confirmed) {
+                    std::cout << "Driver " << outcome.driverID << " after " << outcome.offers << " offer(s), $"
+                              << std::setprecision(2) << outcome.fare << std::endl;
+                } else {
+                    std::cout << "no driver after " << outcome.offers << " offer(s)" << std::endl;
+                }
+            };
+            pipeline.submit(pipelineRequest, report);
+            RideRequest secondRequest = pipelineRequest;
+            secondRequest.requestID = 151;
+            secondRequest.riderID = 802;
+            secondRequest.type = RideType::Standard;
+            secondRequest.pickupLocation = places.intern("Wall Street");
+            secondRequest.pickupPosition = GeoPoint{ 40.7060, -74.0090 };
+            pipeline.submit(secondRequest, report);
+            loop.waitIdle();
+            const PipelineStats pipelineStats = pipeline.stats();
+            std::cout << pipelineStats.confirmed << " confirmed, " << pipelineStats.noDriver << " unmatched, peak "
+                      << pipelineStats.peakInFlight << " in flight" << std::endl;
+        }
+        pipelineDrivers.get(702).getDriverInfo();
+        std::cout << std::endl;
+
+        // Test Scenario 31: Two nodes splitting the city by region
+        std::cout << "Test 31: Sharded Regions" << std::endl;
+        std::cout << "------------------------" << std::endl;
+        ShardRing ring;
+        ring.addNode(0);
+        ring.addNode(1);
+        LoopbackTransport loopback;
+        ShardNode nodeA(0, ring, loopback);
+        ShardNode nodeB(1, ring, loopback);
+        loopback.attach(nodeA);
+        loopback.attach(nodeB);
+        const GeoPoint homePoint = midtown;
+        const NodeID homeNode = ring.nodeFor(homePoint);
+        // Walk east until the next region belongs to the other node
+        GeoPoint across = homePoint;
+        while (ring.nodeFor(across) == homeNode) {
+            across.lon += ring.getRegionDegrees();
+        }
+        ShardNode& homeShard = homeNode == 0 ? nodeA : nodeB;
+        ShardNode& otherShard = homeNode == 0 ? nodeB : nodeA;
+        homeShard.addDriver(901, "Mateo", 4.8, homePoint);
+        otherShard.addDriver(902, "Sana", 4.9, across);
+        RideRequest shardRequest{};
+        shardRequest.requestID = 160;
+        shardRequest.riderID = 811;
+        shardRequest.pickupLocation = LocationTable::global().intern("Bryant Park");
+        shardRequest.dropoffLocation = LocationTable::global().intern("Grand Central");
+        shardRequest.type = RideType::Standard;
+        shardRequest.pickupPosition = across;
+        shardRequest.distance = 1.2;
+        // Enters at the home node, is matched by the node that owns the pickup
+        homeShard.route(shardRequest, "Mia", [](const shard_wire::RouteReplyMessage& reply) {
+            std::cout << "Request " << reply.requestID << " served by node " << reply.servedBy << ": Driver "
+                      << reply.driverID << ", $" << std::setprecision(2) << reply.fare << std::endl;
+        });
+        loopback.pump();
+        // Sana drives the rider into the home node's region mid-trip
+        otherShard.updateDriverPosition(902, homePoint);
+        loopback.pump();
+        std::cout << "Driver 902 now on node " << (homeShard.hasDriver(902) ? homeNode : otherShard.getNodeID())
+                  << ", ride in progress: " << (homeShard.hasRideInProgress(902) ? "yes" : "no") << std::endl;
+        // The ride stays on the node that matched it, which hears about the completion
+        homeShard.completeRide(902);
+        loopback.pump();
+        std::cout << "Ride 160 completed on node " << otherShard.getNodeID() << ": "
+                  << (otherShard.getRideRegistry()[0].getCompletedAt() != 0 ? "yes" : "no") << std::endl;
+        std::cout << loopback.bytesSent() << " bytes between nodes" << std::endl;
+        std::cout << std::endl;
+
+        // Test Scenario 32: Synthetic city traffic and trace replay
+        std::cout << "Test 32: Traffic Generator" << std::endl;
+        std::cout << "--------------------------" << std::endl;
+        TrafficGenerator traffic(TrafficProfile::metro(), 42);
+        const TrafficTrace day = traffic.trace(500, 50, 2000, 1772496000);
+        std::size_t peakRequests = 0;
+        std::size_t premiumRequests = 0;
+        for (const GeneratedRequest& generated : day.requests) {
+            const std::int64_t hour = (generated.timestamp - 1772496000) / 3600;
+            peakRequests += (hour >= 7 && hour < 10) || (hour >= 16 && hour < 20);
+            premiumRequests += generated.request.type == RideType::Premium;
+        }
+        std::cout << day.requests.size() << " requests, " << peakRequests << " in rush hours, "
+                  << premiumRequests << " Premium" << std::endl;
+        std::stringstream recorded;
+        traffic_trace::write(recorded, day);
+        const TrafficTrace replayed = traffic_trace::read(recorded);
+        const GeneratedRequest& firstTrip = replayed.requests.front();
+        std::cout << "Replayed " << replayed.drivers.size() << " drivers and " << replayed.requests.size()
+                  << " requests; first from " << LocationTable::global().name(firstTrip.request.pickupLocation)
+                  << ", " << std::setprecision(2) << firstTrip.request.distance << " miles" << std::endl;
+        std::cout << std::endl;
+
     } catch (const std::exception& e) {
         std::cerr << "Unexpected error: " << e.what() << std::endl;
         return 1;
@@ -0,0 +1,407 @@
+#ifndef RIDE_SHARING_METRICS_H
+#define RIDE_SHARING_METRICS_H
+
+#include <atomic>
+#include <array>
+#include <chrono>
+#include <mutex>
+#include <vector>
+#include <string>
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+// Build with -DRIDE_SHARING_METRICS=1 to compile the instrumentation points in
+#ifndef RIDE_SHARING_METRICS
+#define RIDE_SHARING_METRICS 0
+#endif
+
+namespace metrics {
+
+enum class Counter : std::uint8_t {
+    RidesCreated,
+    FaresCalculated,
+    RidesAssigned,
+    RidesRequested,
+    DispatchAssignments,
+    DispatchUnassigned,
+    DriverMatches
+};
+
+enum class Histogram : std::uint8_t {
+    RideConstruction,
+    FareCalculation,
+    AddRide,
+    RequestRide,
+    DriverMatch,
+    DispatchRound
+};
+
+constexpr std::size_t counterCount = 7;
+constexpr std::size_t histogramCount = 6;
+
+inline const char* counterName(Counter counter) {
+    static const char* const names[counterCount] = {
+        "rides_created_total", "fares_calculated_total", "rides_assigned_total",
+        "rides_requested_total", "dispatch_assignments_total", "dispatch_unassigned_total",
+        "driver_matches_total"
+    };
+    return names[static_cast<std::size_t>(counter)];
+}
+
+inline const char* histogramName(Histogram histogram) {
+    static const char* const names[histogramCount] = {
+        "ride_construction_seconds", "fare_calculation_seconds", "driver_add_ride_seconds",
+        "rider_request_ride_seconds", "driver_match_seconds", "dispatch_round_seconds"
+    };
+    return names[static_cast<std::size_t>(histogram)];
+}
+
+/**
+ * @brief One event in sampleEvery(h) is timed; it is recorded with that weight
+ * A clock read costs about 20ns on a virtualized TSC, so timing every call of
+ * a sub-100ns hot path would blow the 20ns-per-event budget on its own. The
+ * per-ride stages are sampled; matching and dispatch rounds are always timed.
+ * Histogram counts therefore lag by at most sampleEvery(h) - 1 events per thread.
+ */
+constexpr std::uint32_t sampleEvery(Histogram histogram) {
+    switch (histogram) {
+        case Histogram::DriverMatch:
+        case Histogram::DispatchRound:
+            return 1;
+        default:
+            return 16;
+    }
+}
+
+// Raw timestamp: TSC ticks on x86, steady-clock nanoseconds elsewhere; scaled to seconds on scrape
+inline std::uint64_t ticks() {
+#if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#else
+    return static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+#endif
+}
+
+/**
+ * @brief HDR-style bucket layout: 16 linear sub-buckets per power of two
+ * Values below 16 get exact buckets; above that, relative error is under 1/16.
+ * Covers up to 2^44 ticks (well over an hour at 4 GHz); larger values clamp to the top.
+ */
+struct BucketLayout {
+    static constexpr unsigned subBits = 4;
+    static constexpr std::uint64_t subCount = 1u << subBits;
+    static constexpr unsigned maxExponent = 43;
+    static constexpr std::size_t bucketCount = (maxExponent - subBits + 2) * subCount;
+
+    static std::size_t index(std::uint64_t value) {
+        if (value < subCount) {
+            return static_cast<std::size_t>(value);
+        }
+        const unsigned exponent = 63u - static_cast<unsigned>(__builtin_clzll(value));
+        if (exponent > maxExponent) {
+            return bucketCount - 1;
+        }
+        const std::uint64_t sub = (value >> (exponent - subBits)) & (subCount - 1);
+        return static_cast<std::size_t>((exponent - subBits + 1) * subCount + sub);
+    }
+
+    // Exclusive upper bound of a bucket, in the recorded unit
+    static double upperBound(std::size_t index) {
+        if (index < subCount) {
+            return static_cast<double>(index + 1);
+        }
+        const unsigned exponent = static_cast<unsigned>(index / subCount) + subBits - 1;
+        const std::uint64_t sub = index % subCount;
+        return static_cast<double>((subCount + sub + 1) << (exponent - subBits));
+    }
+};
+
+/**
+ * @brief ThreadSlab struct - one thread's counters and histograms
+ * Only the owning thread writes (plain load + store, no read-modify-write), and
+ * a scrape reads the same atomics relaxed, so recording never contends.
+ * untilSample is private to the owning thread and never scraped.
+ */
+struct ThreadSlab {
+    struct Cells {
+        std::atomic<std::uint64_t> count{0};
+        std::atomic<std::uint64_t> sum{0};
+        std::array<std::atomic<std::uint64_t>, BucketLayout::bucketCount> buckets{};
+    };
+
+    std::array<std::atomic<std::uint64_t>, counterCount> counters{};
+    std::array<Cells, histogramCount> histograms;
+    std::array<std::uint32_t, histogramCount> untilSample;
+
+    ThreadSlab() {
+        for (std::size_t h = 0; h < histogramCount; ++h) {
+            untilSample[h] = sampleEvery(static_cast<Histogram>(h));
+        }
+    }
+
+    static void bump(std::atomic<std::uint64_t>& cell, std::uint64_t by) {
+        cell.store(cell.load(std::memory_order_relaxed) + by, std::memory_order_relaxed);
+    }
+
+    void add(Counter counter, std::uint64_t by) { bump(counters[static_cast<std::size_t>(counter)], by); }
+
+    // True for the event that closes the current sampling stride
+    bool sampleNext(Histogram histogram) {
+        std::uint32_t& left = untilSample[static_cast<std::size_t>(histogram)];
+        if (--left != 0) {
+            return false;
+        }
+        left = sampleEvery(histogram);
+        return true;
+    }
+
+    // value counts as weight events of that duration
+    void record(Histogram histogram, std::uint64_t value, std::uint64_t weight = 1) {
+        Cells& cells = histograms[static_cast<std::size_t>(histogram)];
+        bump(cells.count, weight);
+        bump(cells.sum, value * weight);
+        bump(cells.buckets[BucketLayout::index(value)], weight);
+    }
+};
+
+struct HistogramSnapshot {
+    std::uint64_t count = 0;
+    double sumSeconds = 0.0;
+    std::vector<std::uint64_t> buckets = std::vector<std::uint64_t>(BucketLayout::bucketCount, 0);
+    double secondsPerTick = 1e-9;
+
+    // Upper bound of the bucket holding quantile q (0..1), in seconds
+    double quantileSeconds(double q) const {
+        if (count == 0) {
+            return 0.0;
+        }
+        const std::uint64_t rank = std::max<std::uint64_t>(1, static_cast<std::uint64_t>(q * static_cast<double>(count) + 0.5));
+        std::uint64_t seen = 0;
+        for (std::size_t i = 0; i < buckets.size(); ++i) {
+            seen += buckets[i];
+            if (seen >= rank) {
+                return BucketLayout::upperBound(i) * secondsPerTick;
+            }
+        }
+        return BucketLayout::upperBound(buckets.size() - 1) * secondsPerTick;
+    }
+};
+
+struct MetricsSnapshot {
+    std::array<std::uint64_t, counterCount> counters{};
+    std::array<HistogramSnapshot, histogramCount> histograms;
+
+    std::uint64_t counter(Counter which) const { return counters[static_cast<std::size_t>(which)]; }
+    const HistogramSnapshot& histogram(Histogram which) const { return histograms[static_cast<std::size_t>(which)]; }
+};
+
+/**
+ * @brief Registry class - owns every thread's slab and merges them on scrape
+ * A thread gets its slab on first use; when the thread exits its totals are
+ * folded into a retired slab so short-lived workers are not lost.
+ */
+class Registry {
+private:
+    std::mutex mutex;
+    std::vector<ThreadSlab*> live;
+    ThreadSlab retired;
+    std::uint64_t startTicks;
+    std::chrono::steady_clock::time_point startTime;
+
+    struct Handle {
+        Registry* owner;
+        ThreadSlab* slab;
+
+        explicit Handle(Registry& registry) : owner(&registry), slab(registry.attach()) {}
+        ~Handle() { owner->detach(slab); }
+    };
+
+    static void merge(MetricsSnapshot& into, const ThreadSlab& slab) {
+        for (std::size_t c = 0; c < counterCount; ++c) {
+            into.counters[c] += slab.counters[c].load(std::memory_order_relaxed);
+        }
+        for (std::size_t h = 0; h < histogramCount; ++h) {
+            const ThreadSlab::Cells& cells = slab.histograms[h];
+            HistogramSnapshot& target = into.histograms[h];
+            target.count += cells.count.load(std::memory_order_relaxed);
+            target.sumSeconds += static_cast<double>(cells.sum.load(std::memory_order_relaxed));
+            for (std::size_t b = 0; b < BucketLayout::bucketCount; ++b) {
+                target.buckets[b] += cells.buckets[b].load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    static void fold(ThreadSlab& into, const ThreadSlab& slab) {
+        for (std::size_t c = 0; c < counterCount; ++c) {
+            ThreadSlab::bump(into.counters[c], slab.counters[c].load(std::memory_order_relaxed));
+        }
+        for (std::size_t h = 0; h < histogramCount; ++h) {
+            ThreadSlab::bump(into.histograms[h].count, slab.histograms[h].count.load(std::memory_order_relaxed));
+            ThreadSlab::bump(into.histograms[h].sum, slab.histograms[h].sum.load(std::memory_order_relaxed));
+            for (std::size_t b = 0; b < BucketLayout::bucketCount; ++b) {
+                ThreadSlab::bump(into.histograms[h].buckets[b],
+                                 slab.histograms[h].buckets[b].load(std::memory_order_relaxed));
+            }
+        }
+    }
+
+    ThreadSlab* attach() {
+        ThreadSlab* slab = new ThreadSlab();
+        std::lock_guard<std::mutex> lock(mutex);
+        try {
+            live.push_back(slab);
+        } catch (...) {
+            delete slab;
+            throw;
+        }
+        return slab;
+    }
+
+    void detach(ThreadSlab* slab) {
+        std::lock_guard<std::mutex> lock(mutex);
+        fold(retired, *slab);
+        live.erase(std::find(live.begin(), live.end(), slab));
+        delete slab;
+    }
+
+    // Seconds per tick, measured over the registry's lifetime
+    double secondsPerTick() const {
+#if defined(__x86_64__) || defined(__i386__)
+        const std::uint64_t elapsedTicks = ticks() - startTicks;
+        const double elapsedSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+        if (elapsedTicks == 0 || elapsedSeconds <= 0.0) {
+            return 1e-9;
+        }
+        return elapsedSeconds / static_cast<double>(elapsedTicks);
+#else
+        return 1e-9;
+#endif
+    }
+
+public:
+    Registry()
+        : startTicks(ticks()), startTime(std::chrono::steady_clock::now()) {}
+
+    Registry(const Registry&) = delete;
+    Registry& operator=(const Registry&) = delete;
+
+    static Registry& global() {
+        static Registry registry;
+        return registry;
+    }
+
+    // Calling thread's slab in the global registry
+    static ThreadSlab& local() {
+        thread_local Handle handle(global());
+        return *handle.slab;
+    }
+
+    MetricsSnapshot scrape() {
+        MetricsSnapshot snapshot;
+        const double scale = secondsPerTick();
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            merge(snapshot, retired);
+            for (const ThreadSlab* slab : live) {
+                merge(snapshot, *slab);
+            }
+        }
+        for (HistogramSnapshot& histogram : snapshot.histograms) {
+            histogram.sumSeconds *= scale;
+            histogram.secondsPerTick = scale;
+        }
+        return snapshot;
+    }
+
+    /**
+     * @brief Prometheus text exposition of a fresh scrape
+     * Histogram buckets are re-binned onto fixed le bounds from 50ns to 10s
+     */
+    std::string prometheus(const std::string& prefix = "ride_sharing_") {
+        static const double bounds[] = {
+            50e-9, 100e-9, 250e-9, 500e-9, 1e-6, 2.5e-6, 5e-6, 10e-6, 25e-6, 50e-6, 100e-6, 250e-6,
+            500e-6, 1e-3, 2.5e-3, 5e-3, 10e-3, 25e-3, 50e-3, 100e-3, 250e-3, 500e-3, 1.0, 2.5, 5.0, 10.0
+        };
+        const MetricsSnapshot snapshot = scrape();
+        std::string out;
+        char line[256];
+        for (std::size_t c = 0; c < counterCount; ++c) {
+            const std::string name = prefix + counterName(static_cast<Counter>(c));
+            std::snprintf(line, sizeof(line), "# TYPE %s counter\n%s %llu\n", name.c_str(), name.c_str(),
+                          static_cast<unsigned long long>(snapshot.counters[c]));
+            out += line;
+        }
+        for (std::size_t h = 0; h < histogramCount; ++h) {
+            const HistogramSnapshot& histogram = snapshot.histograms[h];
+            const std::string name = prefix + histogramName(static_cast<Histogram>(h));
+            out += "# TYPE " + name + " histogram\n";
+            std::size_t bucket = 0;
+            std::uint64_t cumulative = 0;
+            for (double bound : bounds) {
+                while (bucket < histogram.buckets.size()
+                       && BucketLayout::upperBound(bucket) * histogram.secondsPerTick <= bound) {
+                    cumulative += histogram.buckets[bucket++];
+                }
+                std::snprintf(line, sizeof(line), "%s_bucket{le=\"%g\"} %llu\n", name.c_str(), bound,
+                              static_cast<unsigned long long>(cumulative));
+                out += line;
+            }
+            std::snprintf(line, sizeof(line), "%s_bucket{le=\"+Inf\"} %llu\n%s_sum %.9g\n%s_count %llu\n",
+                          name.c_str(), static_cast<unsigned long long>(histogram.count), name.c_str(),
+                          histogram.sumSeconds, name.c_str(), static_cast<unsigned long long>(histogram.count));
+            out += line;
+        }
+        return out;
+    }
+};
+
+inline void count(Counter counter, std::uint64_t by = 1) { Registry::local().add(counter, by); }
+
+// Records the time between construction and destruction into a histogram, sampled per sampleEvery()
+class ScopedTimer {
+private:
+    ThreadSlab* slab;   // null when this event is not sampled
+    Histogram histogram;
+    std::uint64_t start;
+
+public:
+    explicit ScopedTimer(Histogram histogram) : slab(&Registry::local()), histogram(histogram), start(0) {
+        if (slab->sampleNext(histogram)) {
+            start = ticks();
+        } else {
+            slab = nullptr;
+        }
+    }
+
+    ~ScopedTimer() {
+        if (slab != nullptr) {
+            slab->record(histogram, ticks() - start, sampleEvery(histogram));
+        }
+    }
+
+    ScopedTimer(const ScopedTimer&) = delete;
+    ScopedTimer& operator=(const ScopedTimer&) = delete;
+};
+
+} // namespace metrics
+
+#define RIDE_METRICS_CONCAT_INNER(a, b) a##b
+#define RIDE_METRICS_CONCAT(a, b) RIDE_METRICS_CONCAT_INNER(a, b)
+
+#if RIDE_SHARING_METRICS
+#define RIDE_METRICS_COUNT(counter, by) ::metrics::count(::metrics::Counter::counter, (by))
+#define RIDE_METRICS_TIME(histogram) \
+    ::metrics::ScopedTimer RIDE_METRICS_CONCAT(rideMetricsTimer, __LINE__)(::metrics::Histogram::histogram)
+#else
+#define RIDE_METRICS_COUNT(counter, by) ((void)0)
+#define RIDE_METRICS_TIME(histogram) ((void)0)
+#endif
+
+#endif // RIDE_SHARING_METRICS_H
@@ -0,0 +1,113 @@
+#ifndef RIDE_SHARING_MPMC_QUEUE_H
+#define RIDE_SHARING_MPMC_QUEUE_H
+
+#include <atomic>
+#include <memory>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include <stdexcept>
+
+#include "cache_line.h"
+
+/**
+ * @brief MpmcQueue class - bounded lock-free multi-producer/multi-consumer ring
+ * Each cell carries a sequence number that tells producers and consumers whose
+ * turn it is (Vyukov's design), so a push or pop is one CAS on the shared cursor
+ * plus uncontended cell traffic. Capacity is rounded up to a power of two.
+ */
+template <typename T>
+class MpmcQueue {
+    static_assert(std::is_trivially_copyable<T>::value, "MpmcQueue holds trivially copyable values");
+
+private:
+    struct Cell {
+        std::atomic<std::size_t> sequence;
+        T value;
+    };
+
+    std::size_t mask;
+    std::unique_ptr<Cell[]> cells;
+    alignas(cacheLineSize) std::atomic<std::size_t> enqueuePos;
+    alignas(cacheLineSize) std::atomic<std::size_t> dequeuePos;
+
+    static std::size_t roundUpPowerOfTwo(std::size_t n) {
+        std::size_t size = 2;
+        while (size < n) {
+            size <<= 1;
+        }
+        return size;
+    }
+
+public:
+    explicit MpmcQueue(std::size_t capacity)
+        : mask(roundUpPowerOfTwo(capacity) - 1),
+          cells(new Cell[mask + 1]),
+          enqueuePos(0),
+          dequeuePos(0) {
+        if (capacity == 0) {
+            throw std::invalid_argument("Queue capacity must be greater than 0");
+        }
+        for (std::size_t i = 0; i <= mask; ++i) {
+            cells[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    MpmcQueue(const MpmcQueue&) = delete;
+    MpmcQueue& operator=(const MpmcQueue&) = delete;
+
+    // Returns false instead of blocking when the ring is full
+    bool tryPush(const T& value) {
+        std::size_t pos = enqueuePos.load(std::memory_order_relaxed);
+        for (;;) {
+            Cell& cell = cells[pos & mask];
+            const std::size_t sequence = cell.sequence.load(std::memory_order_acquire);
+            const std::intptr_t diff = static_cast<std::intptr_t>(sequence) - static_cast<std::intptr_t>(pos);
+            if (diff == 0) {
+                if (enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    cell.value = value;
+                    cell.sequence.store(pos + 1, std::memory_order_release);
+                    return true;
+                }
+            } else if (diff < 0) {
+                return false;
+            } else {
+                pos = enqueuePos.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    bool tryPop(T& value) {
+        std::size_t pos = dequeuePos.load(std::memory_order_relaxed);
+        for (;;) {
+            Cell& cell = cells[pos & mask];
+            const std::size_t sequence = cell.sequence.load(std::memory_order_acquire);
+            const std::intptr_t diff = static_cast<std::intptr_t>(sequence) - static_cast<std::intptr_t>(pos + 1);
+            if (diff == 0) {
+                if (dequeuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    value = cell.value;
+                    cell.sequence.store(pos + mask + 1, std::memory_order_release);
+                    return true;
+                }
+            } else if (diff < 0) {
+                return false;
+            } else {
+                pos = dequeuePos.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    std::size_t capacity() const { return mask + 1; }
+
+    // Total successful pushes and pops; their difference is the approximate depth
+    std::size_t pushedCount() const { return enqueuePos.load(std::memory_order_relaxed); }
+    std::size_t poppedCount() const { return dequeuePos.load(std::memory_order_relaxed); }
+
+    std::size_t approximateSize() const {
+        const std::size_t popped = poppedCount();
+        const std::size_t pushed = pushedCount();
+        return pushed > popped ? pushed - popped : 0;
+    }
+};
+
+#endif // RIDE_SHARING_MPMC_QUEUE_H
@@ -0,0 +1,172 @@
+#ifndef RIDE_SHARING_PARTICIPANT_REGISTRY_H
+#define RIDE_SHARING_PARTICIPANT_REGISTRY_H
+
+#include <deque>
+#include <string>
+#include <utility>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+
+#include "geo.h"
+#include "driver.h"
+#include "rider.h"
+#include "ride_registry.h"
+#include "flat_id_table.h"
+
+/**
+ * @brief Per-event driver fields, stored inline in the ID table
+ * Two fit in a cache line; rating is a float copy of Driver::getRating()
+ */
+struct alignas(32) DriverStatus {
+    int id;
+    std::uint32_t slot;   // index of the Driver in the registry's cold storage
+    float rating;
+    bool available;
+    GeoPoint position;
+};
+
+static_assert(sizeof(DriverStatus) == 32, "DriverStatus must stay half a cache line");
+
+struct RiderStatus {
+    int id;
+    std::uint32_t slot;
+};
+
+/**
+ * @brief DriverRegistry class - drivers looked up by getDriverID()
+ * Hot fields (ID, rating, availability, position) sit in a flat hash table;
+ * Driver objects (name, ride history, stats) are kept apart in a deque, so
+ * references returned by add() stay valid as the registry grows
+ */
+class DriverRegistry {
+private:
+    FlatIdTable<DriverStatus> table;
+    std::deque<Driver> drivers;
+    const RideRegistry* rideTable;
+
+    DriverStatus& statusOf(int driverID) {
+        DriverStatus* status = table.find(driverID);
+        if (status == nullptr) {
+            throw std::invalid_argument("Unknown driver ID");
+        }
+        return *status;
+    }
+
+public:
+    explicit DriverRegistry(const RideRegistry& rides = RideRegistry::global(), std::size_t expected = 0)
+        : table(expected), rideTable(&rides) {}
+
+    DriverRegistry(const DriverRegistry&) = delete;
+    DriverRegistry& operator=(const DriverRegistry&) = delete;
+
+    void reserve(std::size_t expected) { table.reserve(expected); }
+
+    Driver& add(int driverID, std::string name, double rating,
+                const GeoPoint& position = GeoPoint{ 0.0, 0.0 }, bool available = true) {
+        if (table.find(driverID) != nullptr) {
+            throw std::invalid_argument("Driver ID is already registered");
+        }
+        if (drivers.size() >= FlatIdTable<DriverStatus>::emptySlot) {
+            throw std::length_error("Driver registry is full");
+        }
+        drivers.emplace_back(driverID, std::move(name), rating, *rideTable);
+        DriverStatus status{};
+        status.id = driverID;
+        status.slot = static_cast<std::uint32_t>(drivers.size() - 1);
+        status.rating = static_cast<float>(rating);
+        status.available = available;
+        status.position = position;
+        table.insert(status);
+        return drivers.back();
+    }
+
+    // Hot fields only; nullptr for an unknown ID
+    const DriverStatus* status(int driverID) const { return table.find(driverID); }
+
+    Driver* find(int driverID) {
+        const DriverStatus* status = table.find(driverID);
+        return status == nullptr ? nullptr : &drivers[status->slot];
+    }
+
+    const Driver* find(int driverID) const { return const_cast<DriverRegistry*>(this)->find(driverID); }
+
+    Driver& get(int driverID) { return drivers[statusOf(driverID).slot]; }
+    const Driver& get(int driverID) const { return const_cast<DriverRegistry*>(this)->get(driverID); }
+
+    void setAvailable(int driverID, bool available) { statusOf(driverID).available = available; }
+    void updatePosition(int driverID, const GeoPoint& position) { statusOf(driverID).position = position; }
+
+    // Issue before a batch of lookups so their buckets load in parallel
+    void prefetch(int driverID) const { table.prefetch(driverID); }
+
+    std::size_t size() const { return drivers.size(); }
+    const RideRegistry& getRideRegistry() const { return *rideTable; }
+
+    // Iteration over the cold Driver objects, in registration order
+    std::deque<Driver>::iterator begin() { return drivers.begin(); }
+    std::deque<Driver>::iterator end() { return drivers.end(); }
+    std::deque<Driver>::const_iterator begin() const { return drivers.begin(); }
+    std::deque<Driver>::const_iterator end() const { return drivers.end(); }
+};
+
+/**
+ * @brief RiderRegistry class - riders looked up by getRiderID()
+ * Riders have no per-event fields, so the table holds just the ID-to-slot pair
+ */
+class RiderRegistry {
+private:
+    FlatIdTable<RiderStatus> table;
+    std::deque<Rider> riders;
+    const RideRegistry* rideTable;
+
+public:
+    explicit RiderRegistry(const RideRegistry& rides = RideRegistry::global(), std::size_t expected = 0)
+        : table(expected), rideTable(&rides) {}
+
+    RiderRegistry(const RiderRegistry&) = delete;
+    RiderRegistry& operator=(const RiderRegistry&) = delete;
+
+    void reserve(std::size_t expected) { table.reserve(expected); }
+
+    Rider& add(int riderID, std::string name) {
+        if (table.find(riderID) != nullptr) {
+            throw std::invalid_argument("Rider ID is already registered");
+        }
+        if (riders.size() >= FlatIdTable<RiderStatus>::emptySlot) {
+            throw std::length_error("Rider registry is full");
+        }
+        riders.emplace_back(riderID, std::move(name), *rideTable);
+        table.insert(RiderStatus{ riderID, static_cast<std::uint32_t>(riders.size() - 1) });
+        return riders.back();
+    }
+
+    Rider* find(int riderID) {
+        const RiderStatus* status = table.find(riderID);
+        return status == nullptr ? nullptr : &riders[status->slot];
+    }
+
+    const Rider* find(int riderID) const { return const_cast<RiderRegistry*>(this)->find(riderID); }
+
+    Rider& get(int riderID) {
+        Rider* rider = find(riderID);
+        if (rider == nullptr) {
+            throw std::invalid_argument("Unknown rider ID");
+        }
+        return *rider;
+    }
+
+    const Rider& get(int riderID) const { return const_cast<RiderRegistry*>(this)->get(riderID); }
+
+    void prefetch(int riderID) const { table.prefetch(riderID); }
+
+    std::size_t size() const { return riders.size(); }
+    const RideRegistry& getRideRegistry() const { return *rideTable; }
+
+    std::deque<Rider>::iterator begin() { return riders.begin(); }
+    std::deque<Rider>::iterator end() { return riders.end(); }
+    std::deque<Rider>::const_iterator begin() const { return riders.begin(); }
+    std::deque<Rider>::const_iterator end() const { return riders.end(); }
+};
+
+#endif // RIDE_SHARING_PARTICIPANT_REGISTRY_H
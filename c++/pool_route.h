@@ -0,0 +1,285 @@
+#ifndef RIDE_SHARING_POOL_ROUTE_H
+#define RIDE_SHARING_POOL_ROUTE_H
+
+#include <vector>
+#include <limits>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+
+#include "geo.h"
+#include "ride.h"
+#include "ride_registry.h"
+
+/**
+ * @brief Service limits for one shared vehicle
+ * A rider's time in the vehicle may be at most maxDetourRatio above their direct
+ * trip plus detourAllowanceKm, and their pickup must be reached within maxPickupKm
+ * of vehicle travel from the moment they join the route
+ */
+struct PoolLimits {
+    std::size_t seats = 4;
+    double maxDetourRatio = 0.5;
+    double detourAllowanceKm = 1.0;
+    double maxPickupKm = 5.0;
+};
+
+/**
+ * @brief Cheapest feasible place for a new rider's stops
+ * The pickup goes before current stop pickupBefore and the dropoff before
+ * current stop dropoffBefore (== stopCount() appends); addedKm is the detour
+ */
+struct PoolInsertion {
+    bool feasible = false;
+    std::size_t pickupBefore = 0;
+    std::size_t dropoffBefore = 0;
+    double addedKm = std::numeric_limits<double>::infinity();
+};
+
+/**
+ * @brief PoolRoute class - the ordered stops of one driver's shared trip
+ * Distances are vehicle kilometres along the route from its current position.
+ * findInsertion() tries every pickup/dropoff position pair against the current
+ * route in O(stops^2 * riders) with cached arrival offsets, so no full
+ * re-planning is done; routes are a handful of stops, so a check is sub-microsecond.
+ */
+class PoolRoute {
+public:
+    struct Stop {
+        GeoPoint position;
+        std::uint32_t passenger;   // index into passengers()
+        bool pickup;
+    };
+
+    struct Passenger {
+        RideIndex ride;
+        double directKm;
+        double maxRideKm;
+        double pickupDeadlineKm;   // on the route odometer
+        double pickedUpAtKm;       // odometer at pickup; negative while waiting
+        bool droppedOff;
+    };
+
+private:
+    PoolLimits limits;
+    GeoPoint position;
+    double odometerKm;
+    std::vector<Stop> stops;
+    std::vector<Passenger> riders;
+    std::vector<double> arrival;        // km from position to each stop
+    std::vector<std::uint32_t> loadAfter;   // riders aboard after serving each stop
+    std::uint32_t aboard;
+    // Current stop index of each passenger's pickup/dropoff, refreshed on every change
+    std::vector<std::uint32_t> pickupStop;
+    std::vector<std::uint32_t> dropoffStop;
+
+    void refresh() {
+        arrival.resize(stops.size());
+        loadAfter.resize(stops.size());
+        pickupStop.assign(riders.size(), 0);
+        dropoffStop.assign(riders.size(), 0);
+        double km = 0.0;
+        std::uint32_t load = aboard;
+        GeoPoint previous = position;
+        for (std::size_t k = 0; k < stops.size(); ++k) {
+            km += distanceKm(previous, stops[k].position);
+            arrival[k] = km;
+            previous = stops[k].position;
+            if (stops[k].pickup) {
+                ++load;
+                pickupStop[stops[k].passenger] = static_cast<std::uint32_t>(k);
+            } else {
+                --load;
+                dropoffStop[stops[k].passenger] = static_cast<std::uint32_t>(k);
+            }
+            loadAfter[k] = load;
+        }
+    }
+
+    const GeoPoint& before(std::size_t k) const { return k == 0 ? position : stops[k - 1].position; }
+    double arrivalBefore(std::size_t k) const { return k == 0 ? 0.0 : arrival[k - 1]; }
+
+    // Extra km a stop at p adds when placed before current stop k
+    double insertionCost(std::size_t k, const GeoPoint& p) const {
+        if (k == stops.size()) {
+            return distanceKm(before(k), p);
+        }
+        return distanceKm(before(k), p) + distanceKm(p, stops[k].position) - (arrival[k] - arrivalBefore(k));
+    }
+
+    // Existing riders still meet their limits when stops at or after i shift by d1, and at or after j by d2 more
+    bool othersFeasible(std::size_t i, double d1, std::size_t j, double d2) const {
+        for (std::size_t r = 0; r < riders.size(); ++r) {
+            const Passenger& rider = riders[r];
+            if (rider.droppedOff) {
+                continue;
+            }
+            const std::size_t drop = dropoffStop[r];
+            const double dropAt = arrival[drop] + (drop >= i ? d1 : 0.0) + (drop >= j ? d2 : 0.0);
+            double pickAt;
+            if (rider.pickedUpAtKm >= 0.0) {
+                pickAt = rider.pickedUpAtKm - odometerKm;
+            } else {
+                const std::size_t pick = pickupStop[r];
+                pickAt = arrival[pick] + (pick >= i ? d1 : 0.0) + (pick >= j ? d2 : 0.0);
+                if (odometerKm + pickAt > rider.pickupDeadlineKm) {
+                    return false;
+                }
+            }
+            if (dropAt - pickAt > rider.maxRideKm) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+public:
+    explicit PoolRoute(const GeoPoint& start, const PoolLimits& limits = PoolLimits{})
+        : limits(limits), position(start), odometerKm(0.0), aboard(0) {
+        if (limits.seats == 0) {
+            throw std::invalid_argument("A pooled vehicle needs at least one seat");
+        }
+        if (limits.maxDetourRatio < 0 || limits.detourAllowanceKm < 0 || limits.maxPickupKm < 0) {
+            throw std::invalid_argument("Pool limits must not be negative");
+        }
+    }
+
+    /**
+     * @brief Cheapest way to add a rider going from pickup to dropoff
+     * Returns feasible == false when every placement breaks a seat, pickup or detour limit
+     */
+    PoolInsertion findInsertion(const GeoPoint& pickup, const GeoPoint& dropoff) const {
+        PoolInsertion best;
+        const std::size_t m = stops.size();
+        const double directKm = distanceKm(pickup, dropoff);
+        const double maxRideKm = directKm * (1.0 + limits.maxDetourRatio) + limits.detourAllowanceKm;
+
+        // Dropoff costs depend only on the gap, so compute them once
+        std::vector<double> dropCost(m + 1);
+        for (std::size_t j = 0; j <= m; ++j) {
+            dropCost[j] = insertionCost(j, dropoff);
+        }
+
+        for (std::size_t i = 0; i <= m; ++i) {
+            // The new rider rides from leg i to leg j; peakLoad is the most aboard on those legs
+            std::uint32_t peakLoad = i == 0 ? aboard : loadAfter[i - 1];
+            if (peakLoad >= limits.seats) {
+                continue;
+            }
+            const double pickupAt = arrivalBefore(i) + distanceKm(before(i), pickup);
+            if (pickupAt > limits.maxPickupKm) {
+                continue;
+            }
+
+            // Pickup and dropoff back to back before stop i
+            const double adjacentKm = pickupAt + directKm - arrivalBefore(i)
+                + (i < m ? distanceKm(dropoff, stops[i].position) - (arrival[i] - arrivalBefore(i)) : 0.0);
+            if (adjacentKm < best.addedKm && othersFeasible(i, adjacentKm, m + 1, 0.0)) {
+                best = PoolInsertion{ true, i, i, adjacentKm };
+            }
+
+            const double d1 = insertionCost(i, pickup);
+            if (d1 >= best.addedKm || !othersFeasible(i, d1, m + 1, 0.0)) {
+                continue;
+            }
+            for (std::size_t j = i + 1; j <= m; ++j) {
+                peakLoad = std::max(peakLoad, loadAfter[j - 1]);
+                if (peakLoad >= limits.seats) {
+                    break;
+                }
+                const double added = d1 + dropCost[j];
+                if (added >= best.addedKm) {
+                    continue;
+                }
+                const double dropAt = arrival[j - 1] + d1 + distanceKm(stops[j - 1].position, dropoff);
+                if (dropAt - pickupAt > maxRideKm) {
+                    continue;
+                }
+                if (othersFeasible(i, d1, j, dropCost[j])) {
+                    best = PoolInsertion{ true, i, j, added };
+                }
+            }
+        }
+        return best;
+    }
+
+    // Adds the rider's stops where plan says; plan must come from findInsertion on this route
+    void insert(RideIndex ride, const GeoPoint& pickup, const GeoPoint& dropoff, const PoolInsertion& plan) {
+        if (!plan.feasible || plan.pickupBefore > plan.dropoffBefore || plan.dropoffBefore > stops.size()) {
+            throw std::invalid_argument("Insertion plan does not fit this route");
+        }
+        const double directKm = distanceKm(pickup, dropoff);
+        const std::uint32_t passenger = static_cast<std::uint32_t>(riders.size());
+        riders.push_back(Passenger{ ride, directKm,
+                                    directKm * (1.0 + limits.maxDetourRatio) + limits.detourAllowanceKm,
+                                    odometerKm + limits.maxPickupKm, -1.0, false });
+        stops.insert(stops.begin() + static_cast<std::ptrdiff_t>(plan.dropoffBefore), Stop{ dropoff, passenger, false });
+        stops.insert(stops.begin() + static_cast<std::ptrdiff_t>(plan.pickupBefore), Stop{ pickup, passenger, true });
+        refresh();
+    }
+
+    // findInsertion + insert; false leaves the route unchanged
+    bool tryAdd(RideIndex ride, const GeoPoint& pickup, const GeoPoint& dropoff) {
+        const PoolInsertion plan = findInsertion(pickup, dropoff);
+        if (!plan.feasible) {
+            return false;
+        }
+        insert(ride, pickup, dropoff, plan);
+        return true;
+    }
+
+    // Drives to the next stop and serves it
+    Stop completeNextStop() {
+        if (stops.empty()) {
+            throw std::logic_error("Pool route has no stops left");
+        }
+        const Stop stop = stops.front();
+        odometerKm += arrival.front();
+        position = stop.position;
+        stops.erase(stops.begin());
+        Passenger& rider = riders[stop.passenger];
+        if (stop.pickup) {
+            rider.pickedUpAtKm = odometerKm;
+            ++aboard;
+        } else {
+            rider.droppedOff = true;
+            --aboard;
+        }
+        refresh();
+        return stop;
+    }
+
+    /**
+     * @brief Splits tripFare across the route's rides in proportion to their quotes
+     * Each PooledRide's quote is its direct distance at the pool rate, so a rider's
+     * share never depends on how far the route detoured for someone else
+     */
+    void settleFares(RideRegistry& rides, double tripFare) const {
+        double quoted = 0.0;
+        for (const Passenger& rider : riders) {
+            quoted += rides[rider.ride].getDistance();
+        }
+        if (quoted <= 0.0) {
+            return;
+        }
+        for (const Passenger& rider : riders) {
+            PooledRide* ride = dynamic_cast<PooledRide*>(&rides[rider.ride]);
+            if (ride == nullptr) {
+                throw std::invalid_argument("Pool route holds a ride that is not a PooledRide");
+            }
+            ride->settleFare(tripFare * ride->getDistance() / quoted);
+        }
+    }
+
+    // Remaining vehicle km to serve every stop
+    double remainingKm() const { return arrival.empty() ? 0.0 : arrival.back(); }
+    double getOdometerKm() const { return odometerKm; }
+    const GeoPoint& getPosition() const { return position; }
+    std::size_t stopCount() const { return stops.size(); }
+    const std::vector<Stop>& getStops() const { return stops; }
+    const std::vector<Passenger>& passengers() const { return riders; }
+    std::size_t ridersAboard() const { return aboard; }
+    const PoolLimits& getLimits() const { return limits; }
+};
+
+#endif // RIDE_SHARING_POOL_ROUTE_H
@@ -0,0 +1,258 @@
+#ifndef RIDE_SHARING_QUOTE_CACHE_H
+#define RIDE_SHARING_QUOTE_CACHE_H
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include <functional>
+#include <unordered_map>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+
+#include "cache_line.h"
+#include "location_table.h"
+#include "ride.h"
+#include "ride_batch.h"
+#include "surge_pricing.h"
+
+/**
+ * @brief QuoteKey struct - what a fare estimate depends on
+ * surgeEpoch comes from SurgePricing, so a multiplier change is simply a new key
+ */
+struct QuoteKey {
+    LocationID pickup;
+    LocationID dropoff;
+    RideType type;
+    std::uint64_t surgeEpoch;
+
+    bool operator==(const QuoteKey& other) const {
+        return pickup == other.pickup && dropoff == other.dropoff
+            && type == other.type && surgeEpoch == other.surgeEpoch;
+    }
+};
+
+struct QuoteKeyHash {
+    std::size_t operator()(const QuoteKey& key) const {
+        // splitmix64 finalizer over the packed fields
+        std::uint64_t h = (static_cast<std::uint64_t>(key.pickup) << 32) ^ key.dropoff;
+        h ^= key.surgeEpoch * 0x9E3779B97F4A7C15ull + static_cast<std::uint64_t>(key.type);
+        h = (h ^ (h >> 30)) * 0xBF58476D1CE4E5B9ull;
+        h = (h ^ (h >> 27)) * 0x94D049BB133111EBull;
+        return static_cast<std::size_t>(h ^ (h >> 31));
+    }
+};
+
+struct FareQuote {
+    double distance;
+    double fare;
+    double multiplier;
+};
+
+struct QuoteCacheStats {
+    std::uint64_t hits = 0;
+    std::uint64_t misses = 0;
+    std::uint64_t evictions = 0;
+    std::size_t size = 0;
+    std::size_t capacity = 0;
+
+    double hitRate() const {
+        const std::uint64_t lookups = hits + misses;
+        return lookups == 0 ? 0.0 : static_cast<double>(hits) / static_cast<double>(lookups);
+    }
+};
+
+/**
+ * @brief QuoteCache class - sharded CLOCK cache of fare quotes
+ * Keys hash onto independently locked shards. Each shard is a fixed ring of
+ * entries with a reference bit: a hit only sets the bit, and an insert into a
+ * full shard sweeps the hand, clearing bits until it finds an unreferenced
+ * victim. That approximates LRU without relinking a list on every hit.
+ */
+class QuoteCache {
+private:
+    struct Entry {
+        QuoteKey key;
+        FareQuote quote;
+        bool referenced;
+    };
+
+    struct alignas(cacheLineSize) Shard {
+        std::mutex mutex;
+        std::vector<Entry> entries;
+        std::unordered_map<QuoteKey, std::uint32_t, QuoteKeyHash> slots;
+        std::size_t hand = 0;
+        std::uint64_t hits = 0;
+        std::uint64_t misses = 0;
+        std::uint64_t evictions = 0;
+    };
+
+    std::unique_ptr<Shard[]> shards;
+    std::size_t shardCount;
+    std::size_t shardCapacity;
+
+    // Top 16 bits of the hash, so a 32-bit size_t is never shifted past its width;
+    // the shard's own map buckets on the low bits
+    static constexpr unsigned shardShift = sizeof(std::size_t) * 8 - 16;
+
+    Shard& shardFor(std::size_t hash) const {
+        return shards[(hash >> shardShift) % shardCount];
+    }
+
+    void insertLocked(Shard& shard, const QuoteKey& key, const FareQuote& quote) {
+        auto found = shard.slots.find(key);
+        if (found != shard.slots.end()) {
+            Entry& entry = shard.entries[found->second];
+            entry.quote = quote;
+            entry.referenced = true;
+            return;
+        }
+        if (shard.entries.size() < shardCapacity) {
+            shard.slots.emplace(key, static_cast<std::uint32_t>(shard.entries.size()));
+            shard.entries.push_back(Entry{ key, quote, false });
+            return;
+        }
+        for (;;) {
+            Entry& candidate = shard.entries[shard.hand];
+            if (!candidate.referenced) {
+                break;
+            }
+            candidate.referenced = false;
+            shard.hand = (shard.hand + 1) % shardCapacity;
+        }
+        Entry& victim = shard.entries[shard.hand];
+        shard.slots.erase(victim.key);
+        shard.slots.emplace(key, static_cast<std::uint32_t>(shard.hand));
+        victim = Entry{ key, quote, false };
+        shard.hand = (shard.hand + 1) % shardCapacity;
+        ++shard.evictions;
+    }
+
+public:
+    explicit QuoteCache(std::size_t capacity, std::size_t shardCount = 16)
+        : shards(nullptr), shardCount(shardCount), shardCapacity(0) {
+        if (capacity == 0 || shardCount == 0) {
+            throw std::invalid_argument("Quote cache capacity and shard count must be greater than 0");
+        }
+        shardCapacity = (capacity + shardCount - 1) / shardCount;
+        shards.reset(new Shard[shardCount]);
+        for (std::size_t i = 0; i < shardCount; ++i) {
+            shards[i].entries.reserve(shardCapacity);
+            shards[i].slots.reserve(shardCapacity);
+        }
+    }
+
+    QuoteCache(const QuoteCache&) = delete;
+    QuoteCache& operator=(const QuoteCache&) = delete;
+
+    bool lookup(const QuoteKey& key, FareQuote& out) {
+        Shard& shard = shardFor(QuoteKeyHash()(key));
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        auto found = shard.slots.find(key);
+        if (found == shard.slots.end()) {
+            ++shard.misses;
+            return false;
+        }
+        Entry& entry = shard.entries[found->second];
+        entry.referenced = true;
+        out = entry.quote;
+        ++shard.hits;
+        return true;
+    }
+
+    void insert(const QuoteKey& key, const FareQuote& quote) {
+        Shard& shard = shardFor(QuoteKeyHash()(key));
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        insertLocked(shard, key, quote);
+    }
+
+    /**
+     * @brief Cached quote, or compute() on a miss
+     * compute runs without the shard lock, so two threads missing on the same key
+     * may both compute; the second insert just refreshes the entry
+     */
+    template <typename Compute>
+    FareQuote getOrCompute(const QuoteKey& key, Compute&& compute) {
+        FareQuote quote;
+        if (lookup(key, quote)) {
+            return quote;
+        }
+        quote = compute();
+        insert(key, quote);
+        return quote;
+    }
+
+    void clear() {
+        for (std::size_t i = 0; i < shardCount; ++i) {
+            std::lock_guard<std::mutex> lock(shards[i].mutex);
+            shards[i].entries.clear();
+            shards[i].slots.clear();
+            shards[i].hand = 0;
+        }
+    }
+
+    QuoteCacheStats stats() const {
+        QuoteCacheStats result;
+        result.capacity = shardCapacity * shardCount;
+        for (std::size_t i = 0; i < shardCount; ++i) {
+            std::lock_guard<std::mutex> lock(shards[i].mutex);
+            result.hits += shards[i].hits;
+            result.misses += shards[i].misses;
+            result.evictions += shards[i].evictions;
+            result.size += shards[i].entries.size();
+        }
+        return result;
+    }
+
+    std::size_t capacity() const { return shardCapacity * shardCount; }
+};
+
+/**
+ * @brief FareQuoter class - fare estimates through the surge engine and a QuoteCache
+ * The cache sits in front of both the distance lookup and the fare calculation;
+ * prices match Ride::calculateSurgeFare for the same distance and multiplier.
+ */
+class FareQuoter {
+public:
+    using DistanceFunction = std::function<double(LocationID, LocationID)>;
+
+private:
+    const SurgePricing& surge;
+    QuoteCache& cache;
+    DistanceFunction distanceBetween;
+
+public:
+    FareQuoter(const SurgePricing& surge, QuoteCache& cache, DistanceFunction distanceBetween)
+        : surge(surge), cache(cache), distanceBetween(std::move(distanceBetween)) {}
+
+    FareQuote quote(LocationID pickup, LocationID dropoff, RideType type,
+                    std::int64_t now = currentTimestamp()) {
+        if (!isValidRideType(type)) {
+            throw std::invalid_argument("Invalid ride type");
+        }
+        const SurgeQuote level = surge.quote(pickup, now);
+        const QuoteKey key{ pickup, dropoff, type, level.epoch };
+        return cache.getOrCompute(key, [&] {
+            const double distance = distanceBetween(pickup, dropoff);
+            // NaN and DistanceProvider::unreachable must not be priced and cached for the epoch
+            if (!(distance > 0)) {
+                throw std::invalid_argument("Distance must be greater than 0");
+            }
+            if (!std::isfinite(distance)) {
+                throw std::invalid_argument("No route between pickup and dropoff");
+            }
+            return FareQuote{ distance, distance * ratePerMile(type) * level.multiplier, level.multiplier };
+        });
+    }
+
+    FareQuote quote(const std::string& pickup, const std::string& dropoff, RideType type,
+                    std::int64_t now = currentTimestamp()) {
+        LocationTable& table = LocationTable::global();
+        const LocationID pickupID = table.intern(pickup);
+        return quote(pickupID, table.intern(dropoff), type, now);
+    }
+};
+
+#endif // RIDE_SHARING_QUOTE_CACHE_H
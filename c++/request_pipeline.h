@@ -0,0 +1,706 @@
+#ifndef RIDE_SHARING_REQUEST_PIPELINE_H
+#define RIDE_SHARING_REQUEST_PIPELINE_H
+
+#if !defined(__cpp_impl_coroutine) || __cpp_impl_coroutine < 201902L
+#error "request_pipeline.h needs C++20 coroutines; build this target with CXX_STANDARD 20"
+#endif
+
+#include <coroutine>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <deque>
+#include <queue>
+#include <vector>
+#include <thread>
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <exception>
+#include <algorithm>
+#include <utility>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+
+#include "ride.h"
+#include "ride_request.h"
+#include "ride_registry.h"
+#include "driver_index.h"
+#include "participant_registry.h"
+
+template <typename T = void>
+class Task;
+
+namespace detail {
+
+struct TaskPromiseBase {
+    std::coroutine_handle<> continuation = std::noop_coroutine();
+    std::exception_ptr error;
+
+    // Hands control straight back to whoever awaited the task
+    struct FinalAwaiter {
+        bool await_ready() const noexcept { return false; }
+
+        template <typename Promise>
+        std::coroutine_handle<> await_suspend(std::coroutine_handle<Promise> done) const noexcept {
+            return done.promise().continuation;
+        }
+
+        void await_resume() const noexcept {}
+    };
+
+    std::suspend_always initial_suspend() const noexcept { return {}; }
+    FinalAwaiter final_suspend() const noexcept { return {}; }
+    void unhandled_exception() { error = std::current_exception(); }
+};
+
+template <typename T>
+struct TaskPromise : TaskPromiseBase {
+    std::optional<T> value;
+
+    Task<T> get_return_object();
+
+    template <typename U>
+    void return_value(U&& result) { value.emplace(std::forward<U>(result)); }
+
+    T result() {
+        if (error) {
+            std::rethrow_exception(error);
+        }
+        return std::move(*value);
+    }
+};
+
+template <>
+struct TaskPromise<void> : TaskPromiseBase {
+    Task<void> get_return_object();
+
+    void return_void() const noexcept {}
+
+    void result() const {
+        if (error) {
+            std::rethrow_exception(error);
+        }
+    }
+};
+
+// Fire-and-forget frame used by EventLoop::spawn; frees itself when it finishes
+struct DetachedTask {
+    struct promise_type {
+        DetachedTask get_return_object() const noexcept { return {}; }
+        std::suspend_never initial_suspend() const noexcept { return {}; }
+        std::suspend_never final_suspend() const noexcept { return {}; }
+        void return_void() const noexcept {}
+        void unhandled_exception() const noexcept { std::terminate(); }
+    };
+};
+
+} // namespace detail
+
+/**
+ * @brief Task class - lazily started coroutine returning T
+ * Runs when first awaited and resumes its awaiter on completion; exceptions
+ * thrown inside surface from the co_await
+ */
+template <typename T>
+class [[nodiscard]] Task {
+public:
+    using promise_type = detail::TaskPromise<T>;
+
+private:
+    std::coroutine_handle<promise_type> handle;
+
+public:
+    explicit Task(std::coroutine_handle<promise_type> handle) : handle(handle) {}
+    Task(Task&& other) noexcept : handle(std::exchange(other.handle, nullptr)) {}
+    Task(const Task&) = delete;
+    Task& operator=(const Task&) = delete;
+
+    Task& operator=(Task&& other) noexcept {
+        if (this != &other) {
+            if (handle) {
+                handle.destroy();
+            }
+            handle = std::exchange(other.handle, nullptr);
+        }
+        return *this;
+    }
+
+    ~Task() {
+        if (handle) {
+            handle.destroy();
+        }
+    }
+
+    bool await_ready() const noexcept { return false; }
+
+    std::coroutine_handle<> await_suspend(std::coroutine_handle<> awaiting) noexcept {
+        handle.promise().continuation = awaiting;
+        return handle;
+    }
+
+    T await_resume() { return handle.promise().result(); }
+};
+
+template <typename T>
+Task<T> detail::TaskPromise<T>::get_return_object() {
+    return Task<T>(std::coroutine_handle<TaskPromise<T>>::from_promise(*this));
+}
+
+inline Task<void> detail::TaskPromise<void>::get_return_object() {
+    return Task<void>(std::coroutine_handle<TaskPromise<void>>::from_promise(*this));
+}
+
+/**
+ * @brief EventLoop class - worker threads resuming ready coroutines and due timers
+ * A suspended coroutine holds no thread, so a few workers carry thousands of
+ * rides waiting on lookups or drivers. One mutex guards the ready queue and the
+ * timer heap; call waitIdle() before destroying the loop, since pending timers
+ * are dropped with it.
+ */
+class EventLoop {
+public:
+    using Clock = std::chrono::steady_clock;
+
+private:
+    struct Timer {
+        Clock::time_point due;
+        std::uint64_t order;
+        std::function<void()> fire;
+    };
+
+    struct Later {
+        bool operator()(const Timer& a, const Timer& b) const {
+            return a.due != b.due ? a.due > b.due : a.order > b.order;
+        }
+    };
+
+    std::mutex mutex;
+    std::condition_variable wake;
+    std::condition_variable idle;
+    std::deque<std::coroutine_handle<>> ready;
+    std::priority_queue<Timer, std::vector<Timer>, Later> timers;
+    std::uint64_t timerOrder;
+    std::size_t inFlight;
+    bool stopping;
+    std::exception_ptr failure;
+    std::vector<std::thread> workers;
+
+    void workerLoop() {
+        std::unique_lock<std::mutex> lock(mutex);
+        for (;;) {
+            if (!timers.empty() && timers.top().due <= Clock::now()) {
+                std::function<void()> fire = std::move(const_cast<Timer&>(timers.top()).fire);
+                timers.pop();
+                lock.unlock();
+                fire();
+                lock.lock();
+                continue;
+            }
+            if (!ready.empty()) {
+                const std::coroutine_handle<> next = ready.front();
+                ready.pop_front();
+                lock.unlock();
+                next.resume();
+                lock.lock();
+                continue;
+            }
+            if (stopping) {
+                return;
+            }
+            if (timers.empty()) {
+                wake.wait(lock);
+            } else {
+                // Copied: the heap may reallocate while this worker waits
+                const Clock::time_point due = timers.top().due;
+                wake.wait_until(lock, due);
+            }
+        }
+    }
+
+    void finish(std::exception_ptr error) {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (error && !failure) {
+            failure = error;
+        }
+        if (--inFlight == 0) {
+            idle.notify_all();
+        }
+    }
+
+public:
+    explicit EventLoop(std::size_t threads = std::max(1u, std::thread::hardware_concurrency()))
+        : timerOrder(0), inFlight(0), stopping(false) {
+        if (threads == 0) {
+            throw std::invalid_argument("Event loop needs at least one thread");
+        }
+        workers.reserve(threads);
+        for (std::size_t i = 0; i < threads; ++i) {
+            workers.emplace_back([this]() { workerLoop(); });
+        }
+    }
+
+    EventLoop(const EventLoop&) = delete;
+    EventLoop& operator=(const EventLoop&) = delete;
+
+    ~EventLoop() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+        }
+        wake.notify_all();
+        for (std::thread& worker : workers) {
+            worker.join();
+        }
+    }
+
+    // Queues a suspended coroutine to be resumed on a worker
+    void post(std::coroutine_handle<> handle) {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            ready.push_back(handle);
+        }
+        wake.notify_one();
+    }
+
+    // Runs fire on a worker once delay has passed
+    void after(Clock::duration delay, std::function<void()> fire) {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            timers.push(Timer{ Clock::now() + delay, timerOrder++, std::move(fire) });
+        }
+        wake.notify_one();
+    }
+
+    // co_await loop.schedule() moves the caller onto a worker thread
+    auto schedule() {
+        struct Awaiter {
+            EventLoop& loop;
+            bool await_ready() const noexcept { return false; }
+            void await_suspend(std::coroutine_handle<> handle) const { loop.post(handle); }
+            void await_resume() const noexcept {}
+        };
+        return Awaiter{ *this };
+    }
+
+    // co_await loop.sleepFor(d) suspends without holding a thread
+    auto sleepFor(Clock::duration delay) {
+        struct Awaiter {
+            EventLoop& loop;
+            Clock::duration delay;
+            bool await_ready() const noexcept { return delay <= Clock::duration::zero(); }
+            void await_suspend(std::coroutine_handle<> handle) const {
+                loop.after(delay, [handle]() { handle.resume(); });
+            }
+            void await_resume() const noexcept {}
+        };
+        return Awaiter{ *this, delay };
+    }
+
+    // Starts task on the loop and returns at once; waitIdle() waits for it
+    void spawn(Task<void> task) {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            ++inFlight;
+        }
+        runDetached(*this, std::move(task));
+    }
+
+    // Blocks until every spawned task has finished, rethrowing the first failure
+    void waitIdle() {
+        std::unique_lock<std::mutex> lock(mutex);
+        idle.wait(lock, [this]() { return inFlight == 0; });
+        if (failure) {
+            std::rethrow_exception(std::exchange(failure, nullptr));
+        }
+    }
+
+    std::size_t threadCount() const { return workers.size(); }
+
+private:
+    static detail::DetachedTask runDetached(EventLoop& loop, Task<void> task) {
+        co_await loop.schedule();
+        try {
+            co_await std::move(task);
+        } catch (...) {
+            loop.finish(std::current_exception());
+            co_return;
+        }
+        loop.finish(nullptr);
+    }
+};
+
+/**
+ * @brief Completion class - one-shot result handed to a callback-style service
+ * The first complete() wins and resumes the awaiting coroutine on the loop;
+ * later calls return false, so a reply and a timeout can race safely.
+ * A completion that is never completed leaves its coroutine suspended.
+ */
+template <typename T>
+class Completion {
+public:
+    struct State {
+        EventLoop* loop;
+        std::coroutine_handle<> waiter;
+        std::atomic<bool> done{false};
+        std::optional<T> value;
+    };
+
+private:
+    std::shared_ptr<State> state;
+
+public:
+    explicit Completion(std::shared_ptr<State> state) : state(std::move(state)) {}
+
+    bool complete(T value) const {
+        if (state->done.exchange(true, std::memory_order_acq_rel)) {
+            return false;
+        }
+        state->value.emplace(std::move(value));
+        state->loop->post(state->waiter);
+        return true;
+    }
+
+    bool completed() const { return state->done.load(std::memory_order_acquire); }
+};
+
+/**
+ * @brief co_await awaitCompletion<T>(loop, start) calls start(Completion<T>) and
+ * suspends until the completion is completed, from any thread
+ */
+template <typename T, typename Start>
+auto awaitCompletion(EventLoop& loop, Start start) {
+    struct Awaiter {
+        EventLoop& loop;
+        Start start;
+        std::shared_ptr<typename Completion<T>::State> state;
+
+        bool await_ready() const noexcept { return false; }
+
+        void await_suspend(std::coroutine_handle<> handle) {
+            state = std::make_shared<typename Completion<T>::State>();
+            state->loop = &loop;
+            state->waiter = handle;
+            // The coroutine may resume, and destroy this awaiter, before start returns
+            Start begin = std::move(start);
+            Completion<T> completion(state);
+            begin(std::move(completion));
+        }
+
+        T await_resume() { return std::move(*state->value); }
+    };
+    return Awaiter{ loop, std::move(start), nullptr };
+}
+
+/**
+ * @brief AsyncMutex class - mutual exclusion for coroutines
+ * co_await mutex.lock() suspends instead of blocking a worker; the returned
+ * guard unlocks and hands the mutex to the next waiter in FIFO order
+ */
+class AsyncMutex {
+private:
+    EventLoop& loop;
+    std::mutex guard;
+    bool locked;
+    std::deque<std::coroutine_handle<>> waiters;
+
+    void unlock() {
+        std::coroutine_handle<> next;
+        {
+            std::lock_guard<std::mutex> lock(guard);
+            if (waiters.empty()) {
+                locked = false;
+                return;
+            }
+            next = waiters.front();
+            waiters.pop_front();
+        }
+        loop.post(next);   // ownership passes to next without unlocking
+    }
+
+public:
+    class Lock {
+    private:
+        AsyncMutex* owner;
+
+    public:
+        explicit Lock(AsyncMutex* owner) : owner(owner) {}
+        Lock(Lock&& other) noexcept : owner(std::exchange(other.owner, nullptr)) {}
+        Lock(const Lock&) = delete;
+        Lock& operator=(const Lock&) = delete;
+        Lock& operator=(Lock&&) = delete;
+
+        ~Lock() {
+            if (owner != nullptr) {
+                owner->unlock();
+            }
+        }
+    };
+
+    explicit AsyncMutex(EventLoop& loop) : loop(loop), locked(false) {}
+
+    AsyncMutex(const AsyncMutex&) = delete;
+    AsyncMutex& operator=(const AsyncMutex&) = delete;
+
+    auto lock() {
+        struct Awaiter {
+            AsyncMutex& mutex;
+
+            bool await_ready() const noexcept { return false; }
+
+            bool await_suspend(std::coroutine_handle<> handle) {
+                std::lock_guard<std::mutex> lock(mutex.guard);
+                if (!mutex.locked) {
+                    mutex.locked = true;
+                    return false;
+                }
+                mutex.waiters.push_back(handle);
+                return true;
+            }
+
+            Lock await_resume() const noexcept { return Lock(&mutex); }
+        };
+        return Awaiter{ *this };
+    }
+};
+
+enum class PipelineStatus {
+    Confirmed,
+    NoRoute,      // distance lookup found no route
+    NoDriver,     // no available driver accepted within the offer limit
+    Failed        // e.g. unknown rider; see PipelineOutcome::error
+};
+
+struct PipelineOutcome {
+    std::uint64_t requestID;
+    PipelineStatus status;
+    int driverID;           // -1 unless confirmed
+    RideIndex ride;         // valid unless NoRoute or Failed
+    double fare;
+    std::size_t offers;     // drivers asked, including the one who accepted
+    std::exception_ptr error;
+};
+
+struct PipelineStats {
+    std::uint64_t submitted;
+    std::uint64_t confirmed;
+    std::uint64_t noRoute;
+    std::uint64_t noDriver;
+    std::uint64_t failed;
+    std::uint64_t peakInFlight;
+};
+
+/**
+ * @brief External lookups the pipeline awaits
+ * Each gets a Completion to finish whenever the answer arrives, from any thread.
+ * An empty lookupDistance uses RideRequest::distance; an empty offerRide
+ * accepts every offer at once.
+ */
+struct PipelineServices {
+    std::function<void(const RideRequest&, Completion<double>)> lookupDistance;   // miles; infinity = no route
+    std::function<void(const RideRequest&, int driverID, Completion<bool>)> offerRide;
+};
+
+struct PipelineOptions {
+    std::size_t maxOffers = 3;                  // drivers asked before giving up
+    double maxRadiusKm = 10.0;
+    EventLoop::Clock::duration offerTimeout = std::chrono::seconds(15);   // silence counts as a decline
+};
+
+/**
+ * @brief RequestPipeline class - request -> quote -> match -> confirm as coroutines
+ * Each request awaits its distance lookup, then prices a ride, offers it to the
+ * nearest available drivers one at a time and records it with Driver::addRide
+ * and Rider::requestRide. The shared registries, index and histories are only
+ * touched under one AsyncMutex, never across an await, so waiting requests
+ * hold neither a thread nor the lock. A driver is unavailable while an offer
+ * is out and stays unavailable once confirmed.
+ */
+class RequestPipeline {
+private:
+    EventLoop& loop;
+    RideRegistry& rides;
+    DriverIndex& index;
+    DriverRegistry& drivers;
+    RiderRegistry& riders;
+    PipelineServices services;
+    PipelineOptions options;
+    AsyncMutex state;
+
+    std::atomic<std::uint64_t> submitted{0};
+    std::atomic<std::uint64_t> confirmed{0};
+    std::atomic<std::uint64_t> noRoute{0};
+    std::atomic<std::uint64_t> noDriver{0};
+    std::atomic<std::uint64_t> failed{0};
+    std::atomic<std::uint64_t> inFlight{0};
+    std::atomic<std::uint64_t> peakInFlight{0};
+
+    RideIndex createRide(const RideRequest& request, double miles) {
+        const int rideID = static_cast<int>(request.requestID);
+        switch (request.type) {
+            case RideType::Premium:
+                return rides.create<PremiumRide>(rideID, request.pickupLocation, request.dropoffLocation, miles);
+            case RideType::Pooled:
+                return rides.create<PooledRide>(rideID, request.pickupLocation, request.dropoffLocation, miles);
+            default:
+                return rides.create<StandardRide>(rideID, request.pickupLocation, request.dropoffLocation, miles);
+        }
+    }
+
+    Task<double> quoteDistance(const RideRequest& request) {
+        if (!services.lookupDistance) {
+            co_return request.distance;
+        }
+        co_return co_await awaitCompletion<double>(loop, [this, &request](Completion<double> done) {
+            services.lookupDistance(request, std::move(done));
+        });
+    }
+
+    Task<bool> offer(const RideRequest& request, int driverID) {
+        if (!services.offerRide) {
+            co_return true;
+        }
+        co_return co_await awaitCompletion<bool>(loop, [this, &request, driverID](Completion<bool> done) {
+            loop.after(options.offerTimeout, [done]() { done.complete(false); });
+            services.offerRide(request, driverID, std::move(done));
+        });
+    }
+
+    void finished(const PipelineOutcome& outcome) {
+        inFlight.fetch_sub(1, std::memory_order_relaxed);
+        switch (outcome.status) {
+            case PipelineStatus::Confirmed: confirmed.fetch_add(1, std::memory_order_relaxed); break;
+            case PipelineStatus::NoRoute: noRoute.fetch_add(1, std::memory_order_relaxed); break;
+            case PipelineStatus::NoDriver: noDriver.fetch_add(1, std::memory_order_relaxed); break;
+            case PipelineStatus::Failed: failed.fetch_add(1, std::memory_order_relaxed); break;
+        }
+    }
+
+    Task<void> run(RideRequest request, std::function<void(const PipelineOutcome&)> done) {
+        PipelineOutcome outcome = co_await process(request);
+        if (done) {
+            done(outcome);
+        }
+    }
+
+public:
+    RequestPipeline(EventLoop& loop, RideRegistry& rides, DriverIndex& index, DriverRegistry& drivers,
+                    RiderRegistry& riders, PipelineServices services = {}, PipelineOptions options = {})
+        : loop(loop), rides(rides), index(index), drivers(drivers), riders(riders),
+          services(std::move(services)), options(options), state(loop) {
+        if (&drivers.getRideRegistry() != &rides || &riders.getRideRegistry() != &rides) {
+            throw std::invalid_argument("Driver and rider registries must share the pipeline's ride registry");
+        }
+        if (options.maxOffers == 0) {
+            throw std::invalid_argument("maxOffers must be greater than 0");
+        }
+    }
+
+    RequestPipeline(const RequestPipeline&) = delete;
+    RequestPipeline& operator=(const RequestPipeline&) = delete;
+
+    /**
+     * @brief Runs one request through every stage; never throws
+     * Errors from the registries or services come back as PipelineStatus::Failed
+     */
+    Task<PipelineOutcome> process(RideRequest request) {
+        submitted.fetch_add(1, std::memory_order_relaxed);
+        const std::uint64_t running = inFlight.fetch_add(1, std::memory_order_relaxed) + 1;
+        std::uint64_t peak = peakInFlight.load(std::memory_order_relaxed);
+        while (running > peak && !peakInFlight.compare_exchange_weak(peak, running, std::memory_order_relaxed)) {
+        }
+
+        PipelineOutcome outcome{ request.requestID, PipelineStatus::NoDriver, -1, 0, 0.0, 0, nullptr };
+        int reserved = -1;
+        try {
+            const double miles = co_await quoteDistance(request);
+            if (!(miles > 0.0) || !std::isfinite(miles)) {
+                outcome.status = PipelineStatus::NoRoute;
+                finished(outcome);
+                co_return outcome;
+            }
+
+            {
+                auto lock = co_await state.lock();
+                if (riders.find(request.riderID) == nullptr) {
+                    throw std::invalid_argument("Unknown rider ID");
+                }
+                outcome.ride = createRide(request, miles);
+                Ride& ride = rides[outcome.ride];
+                ride.calculateFare();
+                outcome.fare = ride.getFare();
+            }
+
+            std::vector<int> declined;
+            while (outcome.offers < options.maxOffers) {
+                {
+                    auto lock = co_await state.lock();
+                    const std::vector<DriverMatch> matches =
+                        index.nearestAvailable(request.pickupPosition, declined.size() + 1, options.maxRadiusKm);
+                    for (const DriverMatch& match : matches) {
+                        if (std::find(declined.begin(), declined.end(), match.driverID) == declined.end()) {
+                            reserved = match.driverID;
+                            break;
+                        }
+                    }
+                    if (reserved < 0) {
+                        break;
+                    }
+                    index.setAvailable(reserved, false);
+                    drivers.setAvailable(reserved, false);
+                }
+
+                ++outcome.offers;
+                const bool accepted = co_await offer(request, reserved);
+
+                auto lock = co_await state.lock();
+                if (accepted) {
+                    drivers.get(reserved).addRide(outcome.ride);
+                    riders.get(request.riderID).requestRide(outcome.ride);
+                    outcome.status = PipelineStatus::Confirmed;
+                    outcome.driverID = reserved;
+                    break;
+                }
+                index.setAvailable(reserved, true);
+                drivers.setAvailable(reserved, true);
+                declined.push_back(reserved);
+                reserved = -1;
+            }
+        } catch (...) {
+            outcome.status = PipelineStatus::Failed;
+            outcome.driverID = -1;
+            outcome.error = std::current_exception();
+        }
+        if (outcome.status == PipelineStatus::Failed && reserved >= 0) {
+            // Give back a driver held by an offer that never completed; lookups that
+            // cannot throw, since the driver may have left and finished() must still run
+            auto lock = co_await state.lock();
+            if (index.contains(reserved)) {
+                index.setAvailable(reserved, true);
+            }
+            if (drivers.find(reserved) != nullptr) {
+                drivers.setAvailable(reserved, true);
+            }
+        }
+        finished(outcome);
+        co_return outcome;
+    }
+
+    // Spawns the request on the loop; done, if set, receives the outcome on a worker thread
+    void submit(const RideRequest& request, std::function<void(const PipelineOutcome&)> done = {}) {
+        loop.spawn(run(request, std::move(done)));
+    }
+
+    PipelineStats stats() const {
+        return PipelineStats{ submitted.load(std::memory_order_relaxed), confirmed.load(std::memory_order_relaxed),
+                              noRoute.load(std::memory_order_relaxed), noDriver.load(std::memory_order_relaxed),
+                              failed.load(std::memory_order_relaxed), peakInFlight.load(std::memory_order_relaxed) };
+    }
+
+    std::uint64_t inFlightCount() const { return inFlight.load(std::memory_order_relaxed); }
+};
+
+#endif // RIDE_SHARING_REQUEST_PIPELINE_H
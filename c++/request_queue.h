@@ -0,0 +1,118 @@
+#ifndef RIDE_SHARING_REQUEST_QUEUE_H
+#define RIDE_SHARING_REQUEST_QUEUE_H
+
+#include <vector>
+#include <memory>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+
+#include "mpmc_queue.h"
+#include "ride_request.h"
+
+/**
+ * @brief Point-in-time backpressure metrics of a RequestQueue
+ */
+struct RequestQueueStats {
+    std::uint64_t pushed = 0;
+    std::uint64_t popped = 0;
+    std::uint64_t spilled = 0;    // accepted by a shard other than the producer's own
+    std::uint64_t rejected = 0;   // every shard was full
+    std::size_t depth = 0;
+    std::size_t maxShardDepth = 0;
+    std::size_t capacity = 0;
+};
+
+/**
+ * @brief RequestQueue class - sharded lock-free ingestion queue for ride requests
+ * Each producer thread has a home shard, so producers on different shards never
+ * touch the same cursor. When the home shard is full the request spills to the
+ * next shard; when all are full tryPush() fails so callers can shed load.
+ * Matchers drain batches starting at their own shard and move on to the others.
+ */
+class RequestQueue {
+private:
+    struct alignas(cacheLineSize) Shard {
+        MpmcQueue<RideRequest> queue;
+        alignas(cacheLineSize) std::atomic<std::uint64_t> spilled;
+        std::atomic<std::uint64_t> rejected;
+
+        explicit Shard(std::size_t capacity) : queue(capacity), spilled(0), rejected(0) {}
+    };
+
+    std::vector<std::unique_ptr<Shard> > shards;
+
+    // Small stable number per thread, used to spread producers over shards
+    static std::size_t threadSlot() {
+        static std::atomic<std::size_t> nextSlot(0);
+        thread_local const std::size_t slot = nextSlot.fetch_add(1, std::memory_order_relaxed);
+        return slot;
+    }
+
+public:
+    RequestQueue(std::size_t shardCount, std::size_t shardCapacity) {
+        if (shardCount == 0) {
+            throw std::invalid_argument("Shard count must be greater than 0");
+        }
+        shards.reserve(shardCount);
+        for (std::size_t i = 0; i < shardCount; ++i) {
+            shards.push_back(std::make_unique<Shard>(shardCapacity));
+        }
+    }
+
+    bool tryPush(const RideRequest& request) {
+        const std::size_t count = shards.size();
+        const std::size_t home = threadSlot() % count;
+        for (std::size_t i = 0; i < count; ++i) {
+            Shard& shard = *shards[(home + i) % count];
+            if (shard.queue.tryPush(request)) {
+                if (i != 0) {
+                    shards[home]->spilled.fetch_add(1, std::memory_order_relaxed);
+                }
+                return true;
+            }
+        }
+        shards[home]->rejected.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+
+    /**
+     * @brief Pops up to maxBatch requests into out, appending
+     * consumerID picks the first shard to drain so matchers spread out
+     */
+    std::size_t drainBatch(std::vector<RideRequest>& out, std::size_t maxBatch, std::size_t consumerID = 0) {
+        const std::size_t count = shards.size();
+        std::size_t drained = 0;
+        RideRequest request;
+        for (std::size_t i = 0; i < count && drained < maxBatch; ++i) {
+            MpmcQueue<RideRequest>& queue = shards[(consumerID + i) % count]->queue;
+            while (drained < maxBatch && queue.tryPop(request)) {
+                out.push_back(request);
+                ++drained;
+            }
+        }
+        return drained;
+    }
+
+    std::size_t shardCount() const { return shards.size(); }
+
+    RequestQueueStats stats() const {
+        RequestQueueStats stats;
+        for (const auto& shard : shards) {
+            const std::size_t depth = shard->queue.approximateSize();
+            stats.pushed += shard->queue.pushedCount();
+            stats.popped += shard->queue.poppedCount();
+            stats.spilled += shard->spilled.load(std::memory_order_relaxed);
+            stats.rejected += shard->rejected.load(std::memory_order_relaxed);
+            stats.depth += depth;
+            stats.capacity += shard->queue.capacity();
+            if (depth > stats.maxShardDepth) {
+                stats.maxShardDepth = depth;
+            }
+        }
+        return stats;
+    }
+};
+
+#endif // RIDE_SHARING_REQUEST_QUEUE_H
@@ -0,0 +1,268 @@
+#ifndef RIDE_SHARING_RIDE_H
+#define RIDE_SHARING_RIDE_H
+
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <iomanip>
+#include <cmath>
+#include <stdexcept>
+#include <cstdint>
+#include <cstddef>
+
+#include "location_table.h"
+#include "text_format.h"
+#include "validation.h"
+#include "metrics.h"
+
+/**
+ * @brief Closed set of ride types
+ * Used as a compact type tag wherever rides are stored without their vtable
+ */
+enum class RideType : std::uint8_t {
+    Standard = 0,
+    Premium = 1,
+    Pooled = 2
+};
+
+constexpr std::size_t rideTypeCount = 3;
+
+inline bool isValidRideType(RideType type) {
+    return static_cast<std::size_t>(type) < rideTypeCount;
+}
+
+inline const char* rideTypeLabel(RideType type) {
+    switch (type) {
+        case RideType::Premium:
+            return "Premium Ride";
+        case RideType::Pooled:
+            return "Pooled Ride";
+        default:
+            return "Standard Ride";
+    }
+}
+
+// Text layout shared by every buffered rideDetails(std::string&), without the type suffix
+inline void appendRideDetails(std::string& out, int id, const std::string& pickup,
+                              const std::string& dropoff, double distance, double fare) {
+    out += "Ride ID: ";
+    appendInt(out, id);
+    out += "\nPickup: ";
+    out += pickup;
+    out += "\nDropoff: ";
+    out += dropoff;
+    out += "\nDistance: ";
+    appendFixed2(out, distance);
+    out += " miles\nFare: $";
+    appendFixed2(out, fare);
+}
+
+/**
+ * @brief Base Ride class that holds core ride details
+ * Demonstrates encapsulation by keeping ride details private
+ */
+class Ride {
+protected:
+    int rideID;
+    LocationID pickupLocation;   // interned in LocationTable::global()
+    LocationID dropoffLocation;
+    double distance;
+    double fare;
+    std::int64_t requestedAt = 0;   // Unix seconds; 0 until marked
+    std::int64_t completedAt = 0;
+
+public:
+    // Constructor preconditions as error codes, for callers that must not throw
+    // NaN fails the > 0 test; +inf, e.g. DistanceProvider::unreachable, fails isfinite
+    static ValidationError validate(double dist) {
+        if (!(dist > 0)) {
+            return ValidationError::NonPositiveDistance;
+        }
+        return std::isfinite(dist) ? ValidationError::None : ValidationError::NonFiniteDistance;
+    }
+
+    static ValidationError validate(LocationID pickup, LocationID dropoff, double dist) {
+        const ValidationError error = validate(dist);
+        if (error != ValidationError::None) {
+            return error;
+        }
+        const LocationTable& table = LocationTable::global();
+        return table.contains(pickup) && table.contains(dropoff)
+            ? ValidationError::None : ValidationError::UnknownLocation;
+    }
+
+    // Names are interned straight from the view, so parsed buffers are never copied into a std::string
+    Ride(int id, std::string_view pickup, std::string_view dropoff, double dist)
+        : rideID(id), pickupLocation(LocationTable::global().intern(pickup)),
+          dropoffLocation(LocationTable::global().intern(dropoff)), distance(dist), fare(0.0) {
+        const ValidationError error = validate(dist);
+        if (error != ValidationError::None) {
+            throw std::invalid_argument(validationMessage(error));
+        }
+        RIDE_METRICS_COUNT(RidesCreated, 1);
+    }
+
+    // Constructs from already-interned locations, skipping the name lookups
+    Ride(int id, LocationID pickup, LocationID dropoff, double dist)
+        : rideID(id), pickupLocation(pickup), dropoffLocation(dropoff), distance(dist), fare(0.0) {
+        const ValidationError error = validate(pickup, dropoff, dist);
+        if (error != ValidationError::None) {
+            throw std::invalid_argument(validationMessage(error));
+        }
+        RIDE_METRICS_COUNT(RidesCreated, 1);
+    }
+
+    virtual ~Ride() = default;
+
+    // Pure virtual function to be implemented by derived classes
+    virtual void calculateFare() = 0;
+
+    // Prices the ride at its base rate, then scales by a surge multiplier (1.0 = no surge)
+    void calculateSurgeFare(double surgeMultiplier) {
+        calculateFare();
+        fare *= surgeMultiplier;
+    }
+
+    // Type tag of the concrete ride, used by the columnar batch paths
+    virtual RideType getRideType() const = 0;
+
+    // Virtual function that can be overridden by derived classes
+    virtual void rideDetails() const {
+        std::cout << "Ride ID: " << rideID
+                  << "\nPickup: " << getPickupLocation()
+                  << "\nDropoff: " << getDropoffLocation()
+                  << "\nDistance: " << distance << " miles"
+                  << "\nFare: $" << std::fixed << std::setprecision(2) << fare;
+    }
+
+    // Appends the same details to out, with distance always shown to two decimals
+    virtual void rideDetails(std::string& out) const {
+        appendRideDetails(out, rideID, getPickupLocation(), getDropoffLocation(), distance, fare);
+    }
+
+    double getFare() const { return fare; }
+
+    // Reinstates a previously calculated fare, e.g. when loading a stored ride
+    void restoreFare(double storedFare) { fare = storedFare; }
+
+    void markRequested(std::int64_t timestamp) { requestedAt = timestamp; }
+    void markCompleted(std::int64_t timestamp) { completedAt = timestamp; }
+    std::int64_t getRequestedAt() const { return requestedAt; }
+    std::int64_t getCompletedAt() const { return completedAt; }
+
+    int getRideID() const { return rideID; }
+    const std::string& getPickupLocation() const { return LocationTable::global().name(pickupLocation); }
+    const std::string& getDropoffLocation() const { return LocationTable::global().name(dropoffLocation); }
+    LocationID getPickupLocationID() const { return pickupLocation; }
+    LocationID getDropoffLocationID() const { return dropoffLocation; }
+    double getDistance() const { return distance; }
+};
+
+/**
+ * @brief StandardRide class - demonstrates inheritance from Ride
+ * Implements basic fare calculation
+ */
+class StandardRide : public Ride {
+public:
+    static constexpr double ratePerMile = 1.50; // $1.50 per mile
+
+    StandardRide(int id, std::string_view pickup, std::string_view dropoff, double dist)
+        : Ride(id, pickup, dropoff, dist) {}
+
+    StandardRide(int id, LocationID pickup, LocationID dropoff, double dist)
+        : Ride(id, pickup, dropoff, dist) {}
+
+    // Override the calculateFare method - demonstrates polymorphism
+    void calculateFare() override {
+        RIDE_METRICS_TIME(FareCalculation);
+        RIDE_METRICS_COUNT(FaresCalculated, 1);
+        fare = distance * ratePerMile;
+    }
+
+    RideType getRideType() const override { return RideType::Standard; }
+
+    // Override the rideDetails method - demonstrates polymorphism
+    void rideDetails() const override {
+        Ride::rideDetails();
+        std::cout << " (Standard Ride)" << std::endl;
+    }
+
+    void rideDetails(std::string& out) const override {
+        Ride::rideDetails(out);
+        out += " (Standard Ride)\n";
+    }
+};
+
+/**
+ * @brief PremiumRide class - demonstrates inheritance from Ride
+ * Implements premium fare calculation
+ */
+class PremiumRide : public Ride {
+public:
+    static constexpr double ratePerMile = 3.00; // $3.00 per mile
+
+    PremiumRide(int id, std::string_view pickup, std::string_view dropoff, double dist)
+        : Ride(id, pickup, dropoff, dist) {}
+
+    PremiumRide(int id, LocationID pickup, LocationID dropoff, double dist)
+        : Ride(id, pickup, dropoff, dist) {}
+
+    // Override the calculateFare method - demonstrates polymorphism
+    void calculateFare() override {
+        RIDE_METRICS_TIME(FareCalculation);
+        RIDE_METRICS_COUNT(FaresCalculated, 1);
+        fare = distance * ratePerMile;
+    }
+
+    RideType getRideType() const override { return RideType::Premium; }
+
+    // Override the rideDetails method - demonstrates polymorphism
+    void rideDetails() const override {
+        Ride::rideDetails();
+        std::cout << " (Premium Ride)" << std::endl;
+    }
+
+    void rideDetails(std::string& out) const override {
+        Ride::rideDetails(out);
+        out += " (Premium Ride)\n";
+    }
+};
+
+/**
+ * @brief PooledRide class - one rider's leg of a shared trip
+ * Quoted at the pool rate on the rider's own direct distance; the legs that share
+ * a vehicle are tied together by a PoolRoute, which settles the final split
+ */
+class PooledRide : public Ride {
+public:
+    static constexpr double ratePerMile = 1.00; // $1.00 per mile
+
+    PooledRide(int id, std::string_view pickup, std::string_view dropoff, double dist)
+        : Ride(id, pickup, dropoff, dist) {}
+
+    PooledRide(int id, LocationID pickup, LocationID dropoff, double dist)
+        : Ride(id, pickup, dropoff, dist) {}
+
+    void calculateFare() override {
+        RIDE_METRICS_TIME(FareCalculation);
+        RIDE_METRICS_COUNT(FaresCalculated, 1);
+        fare = distance * ratePerMile;
+    }
+
+    RideType getRideType() const override { return RideType::Pooled; }
+
+    // Sets the rider's share of a settled shared-trip fare, replacing the quote
+    void settleFare(double share) { fare = share; }
+
+    void rideDetails() const override {
+        Ride::rideDetails();
+        std::cout << " (Pooled Ride)" << std::endl;
+    }
+
+    void rideDetails(std::string& out) const override {
+        Ride::rideDetails(out);
+        out += " (Pooled Ride)\n";
+    }
+};
+
+#endif // RIDE_SHARING_RIDE_H
@@ -0,0 +1,355 @@
+#ifndef RIDE_SHARING_RIDE_ANALYTICS_H
+#define RIDE_SHARING_RIDE_ANALYTICS_H
+
+#include <array>
+#include <vector>
+#include <memory>
+#include <thread>
+#include <algorithm>
+#include <exception>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+
+#include "ride.h"
+#include "ride_registry.h"
+#include "ride_stats.h"
+#include "location_table.h"
+#include "participant_registry.h"
+
+inline std::size_t defaultAnalyticsWorkers() {
+    const unsigned hardware = std::thread::hardware_concurrency();
+    return hardware == 0 ? 1 : hardware;
+}
+
+/**
+ * @brief Splits [0, count) into one contiguous chunk per worker and runs fn(worker, begin, end)
+ * Chunk 0 runs on the calling thread; the first exception thrown by any chunk is rethrown
+ * after every worker has joined
+ */
+template <typename Fn>
+void parallelChunks(std::size_t count, std::size_t workers, Fn&& fn) {
+    workers = std::max<std::size_t>(1, std::min(workers, count));
+    const std::size_t chunk = (count + workers - 1) / std::max<std::size_t>(1, workers);
+    std::vector<std::exception_ptr> errors(workers);
+    std::vector<std::thread> threads;
+    threads.reserve(workers - 1);
+    auto run = [&](std::size_t w) {
+        try {
+            fn(w, std::min(count, w * chunk), std::min(count, (w + 1) * chunk));
+        } catch (...) {
+            errors[w] = std::current_exception();
+        }
+    };
+    for (std::size_t w = 1; w < workers; ++w) {
+        threads.emplace_back(run, w);
+    }
+    run(0);
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    for (const auto& error : errors) {
+        if (error) {
+            std::rethrow_exception(error);
+        }
+    }
+}
+
+/**
+ * @brief Sorts values using workers threads
+ * Each worker sorts one chunk, then neighbouring runs are merged pairwise in
+ * parallel until one run is left
+ */
+inline void parallelSort(std::vector<double>& values, std::size_t workers) {
+    workers = std::max<std::size_t>(1, std::min(workers, values.size() / 4096 + 1));
+    const std::size_t chunk = (values.size() + workers - 1) / workers;
+    parallelChunks(values.size(), workers, [&values](std::size_t, std::size_t begin, std::size_t end) {
+        std::sort(values.begin() + static_cast<std::ptrdiff_t>(begin), values.begin() + static_cast<std::ptrdiff_t>(end));
+    });
+    for (std::size_t width = chunk; width < values.size(); width *= 2) {
+        const std::size_t merges = (values.size() + 2 * width - 1) / (2 * width);
+        parallelChunks(merges, workers, [&values, width](std::size_t, std::size_t first, std::size_t last) {
+            for (std::size_t m = first; m < last; ++m) {
+                const std::size_t begin = m * 2 * width;
+                const std::size_t middle = std::min(values.size(), begin + width);
+                const std::size_t end = std::min(values.size(), begin + 2 * width);
+                std::inplace_merge(values.begin() + static_cast<std::ptrdiff_t>(begin),
+                                   values.begin() + static_cast<std::ptrdiff_t>(middle),
+                                   values.begin() + static_cast<std::ptrdiff_t>(end));
+            }
+        });
+    }
+}
+
+/**
+ * @brief Totals for one pickup -> dropoff pair
+ */
+struct RouteTotals {
+    LocationID pickup;
+    LocationID dropoff;
+    RideTotals totals;
+
+    const std::string& getPickupLocation() const { return LocationTable::global().name(pickup); }
+    const std::string& getDropoffLocation() const { return LocationTable::global().name(dropoff); }
+};
+
+/**
+ * @brief RouteTable class - open-addressing pickup/dropoff -> RideTotals aggregate
+ * An all-ones key can never be a real route (LocationIDs are dense), so it marks
+ * empty cells; linear probing at load <= 1/2 keeps an update to about one cache line
+ */
+class RouteTable {
+public:
+    static constexpr std::uint64_t emptyKey = ~0ull;
+
+    struct Cell {
+        std::uint64_t key;
+        RideTotals totals;
+    };
+
+private:
+    std::vector<Cell> cells;
+    std::uint64_t seed;
+    unsigned shift = 60;
+    std::size_t count = 0;
+
+    std::size_t home(std::uint64_t key) const {
+        return static_cast<std::size_t>(((key ^ seed) * 0x9E3779B97F4A7C15ull) >> shift);
+    }
+
+    void rehash(std::size_t capacity) {
+        std::vector<Cell> old(capacity, Cell{ emptyKey, RideTotals{} });
+        old.swap(cells);
+        shift = 64;
+        for (std::size_t c = capacity; c > 1; c >>= 1) {
+            --shift;
+        }
+        for (const Cell& cell : old) {
+            if (cell.key != emptyKey) {
+                std::size_t i = home(cell.key);
+                while (cells[i].key != emptyKey) {
+                    i = (i + 1) & (cells.size() - 1);
+                }
+                cells[i] = cell;
+            }
+        }
+    }
+
+public:
+    // Tables that are merged into one another need different seeds: walking a
+    // table in hash order and inserting into a same-hash table packs it into clusters
+    explicit RouteTable(std::uint64_t seed = 0) : cells(16, Cell{ emptyKey, RideTotals{} }), seed(seed) {}
+
+    void reserve(std::size_t expected) {
+        std::size_t capacity = cells.size();
+        while (capacity < expected * 2) {
+            capacity <<= 1;
+        }
+        if (capacity > cells.size()) {
+            rehash(capacity);
+        }
+    }
+
+    static std::uint64_t key(LocationID pickup, LocationID dropoff) {
+        return (static_cast<std::uint64_t>(pickup) << 32) | dropoff;
+    }
+
+    // Partition of a key among partitions, independent of the bits home() uses
+    static std::size_t partition(std::uint64_t key, std::size_t partitions) {
+        return static_cast<std::size_t>(((key * 0xC2B2AE3D27D4EB4Full) >> 32) % partitions);
+    }
+
+    RideTotals& operator[](std::uint64_t key) {
+        if ((count + 1) * 2 > cells.size()) {
+            rehash(cells.size() * 2);
+        }
+        std::size_t i = home(key);
+        for (; cells[i].key != emptyKey; i = (i + 1) & (cells.size() - 1)) {
+            if (cells[i].key == key) {
+                return cells[i].totals;
+            }
+        }
+        ++count;
+        cells[i].key = key;
+        return cells[i].totals;
+    }
+
+    template <typename Fn>
+    void forEach(Fn&& fn) const {
+        for (const Cell& cell : cells) {
+            if (cell.key != emptyKey) {
+                fn(cell.key, cell.totals);
+            }
+        }
+    }
+
+    std::size_t size() const { return count; }
+};
+
+/**
+ * @brief RideReport class - end-of-day aggregates from one parallel pass over the rides
+ * Each worker fills its own per-type totals and route table and writes distances
+ * into its own slice of a shared array. Route tables are then merged in parallel,
+ * one hash partition per worker, so no step runs over every route on one thread.
+ */
+class RideReport {
+private:
+    std::array<RideTotals, rideTypeCount> byType{};
+    std::vector<RouteTable> routes;   // one partition per merge worker
+    std::vector<double> sortedDistances;
+
+    static void merge(RideTotals& into, const RideTotals& from) {
+        into.count += from.count;
+        into.fare += from.fare;
+        into.distance += from.distance;
+    }
+
+    struct Partial {
+        std::array<RideTotals, rideTypeCount> byType{};
+        RouteTable routes;
+    };
+
+    template <typename RideAt>
+    RideReport(std::size_t count, std::size_t workers, RideAt rideAt) {
+        workers = std::max<std::size_t>(1, std::min(workers, count));
+        std::vector<Partial> partials(workers);
+        sortedDistances.resize(count);
+        parallelChunks(count, workers, [&](std::size_t w, std::size_t begin, std::size_t end) {
+            Partial& partial = partials[w];
+            for (std::size_t i = begin; i < end; ++i) {
+                const Ride& ride = rideAt(i);
+                const double fare = ride.getFare();
+                const double distance = ride.getDistance();
+                partial.byType[static_cast<std::size_t>(ride.getRideType())].add(fare, distance);
+                partial.routes[RouteTable::key(ride.getPickupLocationID(), ride.getDropoffLocationID())].add(fare, distance);
+                sortedDistances[i] = distance;
+            }
+        });
+        for (const Partial& partial : partials) {
+            for (std::size_t t = 0; t < rideTypeCount; ++t) {
+                merge(byType[t], partial.byType[t]);
+            }
+        }
+        if (workers == 1) {
+            routes.push_back(std::move(partials[0].routes));
+        } else {
+            std::size_t partialRoutes = 0;
+            for (const Partial& partial : partials) {
+                partialRoutes += partial.routes.size();
+            }
+            routes.assign(workers, RouteTable(0x5851F42D4C957F2Dull));
+            parallelChunks(workers, workers, [&](std::size_t p, std::size_t, std::size_t) {
+                RouteTable& target = routes[p];
+                target.reserve(partialRoutes / workers + partialRoutes / (workers * 8) + 16);
+                for (const Partial& partial : partials) {
+                    partial.routes.forEach([&](std::uint64_t key, const RideTotals& totals) {
+                        if (RouteTable::partition(key, workers) == p) {
+                            merge(target[key], totals);
+                        }
+                    });
+                }
+            });
+        }
+        parallelSort(sortedDistances, workers);
+    }
+
+public:
+    static RideReport build(const RideRegistry& rides, std::size_t workers = defaultAnalyticsWorkers()) {
+        return RideReport(rides.size(), workers, [&rides](std::size_t i) -> const Ride& {
+            return rides[static_cast<RideIndex>(i)];
+        });
+    }
+
+    static RideReport build(const std::vector<std::shared_ptr<Ride> >& rides,
+                            std::size_t workers = defaultAnalyticsWorkers()) {
+        return RideReport(rides.size(), workers, [&rides](std::size_t i) -> const Ride& { return *rides[i]; });
+    }
+
+    const RideTotals& revenueByType(RideType type) const { return byType[static_cast<std::size_t>(type)]; }
+
+    RideTotals overall() const {
+        RideTotals totals;
+        for (const RideTotals& type : byType) {
+            merge(totals, type);
+        }
+        return totals;
+    }
+
+    // The k most frequent routes, ties broken by revenue
+    std::vector<RouteTotals> topRoutes(std::size_t k) const {
+        std::vector<RouteTotals> ranked;
+        ranked.reserve(routeCount());
+        for (const RouteTable& partition : routes) {
+            partition.forEach([&ranked](std::uint64_t key, const RideTotals& totals) {
+                ranked.push_back(RouteTotals{ static_cast<LocationID>(key >> 32),
+                                              static_cast<LocationID>(key & 0xFFFFFFFFu), totals });
+            });
+        }
+        auto busier = [](const RouteTotals& a, const RouteTotals& b) {
+            return a.totals.count != b.totals.count ? a.totals.count > b.totals.count : a.totals.fare > b.totals.fare;
+        };
+        k = std::min(k, ranked.size());
+        std::partial_sort(ranked.begin(), ranked.begin() + static_cast<std::ptrdiff_t>(k), ranked.end(), busier);
+        ranked.resize(k);
+        return ranked;
+    }
+
+    // Nearest-rank distance percentile, q in [0, 1]
+    double distancePercentile(double q) const {
+        if (q < 0 || q > 1) {
+            throw std::invalid_argument("Percentile must be between 0 and 1");
+        }
+        if (sortedDistances.empty()) {
+            return 0.0;
+        }
+        const std::size_t rank = static_cast<std::size_t>(q * static_cast<double>(sortedDistances.size() - 1) + 0.5);
+        return sortedDistances[rank];
+    }
+
+    std::size_t routeCount() const {
+        std::size_t total = 0;
+        for (const RouteTable& partition : routes) {
+            total += partition.size();
+        }
+        return total;
+    }
+};
+
+/**
+ * @brief One driver's activity over a reporting window
+ * busyFraction estimates time on trips as distance / averageSpeedMph
+ */
+struct DriverUtilization {
+    int driverID;
+    RideTotals totals;
+    double busyFraction;
+};
+
+// Utilization of every registered driver over [from, to), read from their ride timelines
+inline std::vector<DriverUtilization> driverUtilization(const DriverRegistry& drivers, std::int64_t from,
+                                                        std::int64_t to, double averageSpeedMph = 20.0,
+                                                        std::size_t workers = defaultAnalyticsWorkers()) {
+    if (to <= from) {
+        throw std::invalid_argument("Reporting window must not be empty");
+    }
+    if (averageSpeedMph <= 0) {
+        throw std::invalid_argument("Average speed must be greater than 0");
+    }
+    std::vector<const Driver*> order;
+    order.reserve(drivers.size());
+    for (const Driver& driver : drivers) {
+        order.push_back(&driver);
+    }
+    const double windowHours = static_cast<double>(to - from) / 3600.0;
+    std::vector<DriverUtilization> result(order.size());
+    parallelChunks(order.size(), workers, [&](std::size_t, std::size_t begin, std::size_t end) {
+        for (std::size_t i = begin; i < end; ++i) {
+            const RideTotals totals = order[i]->getTimeline().totalsBetween(from, to);
+            const double busyHours = totals.distance / averageSpeedMph;
+            result[i] = DriverUtilization{ order[i]->getDriverID(), totals, std::min(1.0, busyHours / windowHours) };
+        }
+    });
+    return result;
+}
+
+#endif // RIDE_SHARING_RIDE_ANALYTICS_H
@@ -0,0 +1,119 @@
+#ifndef RIDE_SHARING_RIDE_BATCH_H
+#define RIDE_SHARING_RIDE_BATCH_H
+
+#include <vector>
+#include <cstddef>
+#include <stdexcept>
+
+#include "ride.h"
+#include "metrics.h"
+
+/**
+ * @brief Per-mile rate for each RideType, indexed by the type tag
+ * Built from the same constants the Ride subclasses use so batch fares match exactly
+ */
+inline constexpr double rideRatePerMile[] = {
+    StandardRide::ratePerMile,  // RideType::Standard
+    PremiumRide::ratePerMile,   // RideType::Premium
+    PooledRide::ratePerMile     // RideType::Pooled
+};
+
+static_assert(sizeof(rideRatePerMile) / sizeof(rideRatePerMile[0]) == rideTypeCount,
+              "rideRatePerMile needs one rate per RideType");
+
+inline double ratePerMile(RideType type) {
+    return rideRatePerMile[static_cast<std::size_t>(type)];
+}
+
+/**
+ * @brief RideBatch class - structure-of-arrays ride store
+ * Keeps ride IDs, distances, type tags and fares in contiguous columns
+ * so a whole batch can be priced without pointer chasing or virtual calls
+ */
+class RideBatch {
+private:
+    std::vector<int> rideIDs;
+    std::vector<double> distances;
+    std::vector<RideType> types;
+    std::vector<double> fares;
+
+public:
+    RideBatch() = default;
+
+    void reserve(std::size_t count) {
+        rideIDs.reserve(count);
+        distances.reserve(count);
+        types.reserve(count);
+        fares.reserve(count);
+    }
+
+    // Appends a ride; validates distance the same way the Ride constructor does
+    void addRide(int id, double dist, RideType type) {
+        const ValidationError error = Ride::validate(dist);
+        if (error != ValidationError::None) {
+            throw std::invalid_argument(validationMessage(error));
+        }
+        if (!isValidRideType(type)) {
+            throw std::invalid_argument("Unknown ride type");
+        }
+        rideIDs.push_back(id);
+        distances.push_back(dist);
+        types.push_back(type);
+        fares.push_back(0.0);
+    }
+
+    // Appends an already-priced ride, e.g. one loaded from storage
+    void addRide(int id, double dist, RideType type, double fare) {
+        addRide(id, dist, type);
+        fares.back() = fare;
+    }
+
+    // Copies the columnar fields of an existing ride object into the batch
+    void addRide(const Ride& ride) {
+        rideIDs.push_back(ride.getRideID());
+        distances.push_back(ride.getDistance());
+        types.push_back(ride.getRideType());
+        fares.push_back(ride.getFare());
+    }
+
+    void clear() {
+        rideIDs.clear();
+        distances.clear();
+        types.clear();
+        fares.clear();
+    }
+
+    std::size_t size() const { return rideIDs.size(); }
+    bool empty() const { return rideIDs.empty(); }
+
+    int getRideID(std::size_t i) const { return rideIDs[i]; }
+    double getDistance(std::size_t i) const { return distances[i]; }
+    RideType getRideType(std::size_t i) const { return types[i]; }
+    double getFare(std::size_t i) const { return fares[i]; }
+
+    // Raw column access for batch kernels
+    const int* rideIDData() const { return rideIDs.data(); }
+    const double* distanceData() const { return distances.data(); }
+    const RideType* typeData() const { return types.data(); }
+    double* fareData() { return fares.data(); }
+    const double* fareData() const { return fares.data(); }
+};
+
+/**
+ * @brief Prices every ride in the batch in one pass
+ * Each fare is distance * ratePerMile(type), the same single multiply the
+ * virtual calculateFare() overrides perform, so results are bit-identical
+ */
+inline void calculateFares(RideBatch& batch) {
+    const std::size_t count = batch.size();
+    const double* distances = batch.distanceData();
+    const RideType* types = batch.typeData();
+    double* fares = batch.fareData();
+
+    for (std::size_t i = 0; i < count; ++i) {
+        fares[i] = distances[i] * rideRatePerMile[static_cast<std::size_t>(types[i])];
+    }
+    RIDE_METRICS_COUNT(FaresCalculated, count);
+}
+
+#endif // RIDE_SHARING_RIDE_BATCH_H
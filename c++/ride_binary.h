@@ -0,0 +1,587 @@
+#ifndef RIDE_SHARING_RIDE_BINARY_H
+#define RIDE_SHARING_RIDE_BINARY_H
+
+#include <istream>
+#include <ostream>
+#include <string>
+#include <vector>
+#include <memory>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <algorithm>
+#include <stdexcept>
+
+#include "ride.h"
+#include "ride_registry.h"
+#include "ride_batch.h"
+#include "location_table.h"
+#include "driver.h"
+#include "rider.h"
+
+/**
+ * @brief Versioned little-endian binary format for rides, drivers and riders
+ *
+ * A stream is a FileHeader followed by sections. Each section starts with a
+ * SectionHeader and holds `count` records of one kind:
+ *   Locations - uint32 length + name bytes; record i is file location ID i
+ *   Rides     - fixed 48-byte record: the 32-byte ride encoding, then int64
+ *               requestedAt and completedAt; record i is file ride index i.
+ *               Streams written before timestamps have 32-byte records and
+ *               load with zero timestamps
+ *   Drivers   - fixed 24-byte head, then name bytes and rideCount uint32 ride indices
+ *   Riders    - fixed 16-byte head, then name bytes and rideCount uint32 ride indices
+ * Location IDs and ride indices inside a stream refer to its own sections, so
+ * readers remap them onto the live LocationTable and RideRegistry.
+ */
+namespace ride_binary {
+
+constexpr std::uint32_t magic = 0x45444952;   // "RIDE" on disk
+constexpr std::uint16_t version = 1;
+
+enum class SectionKind : std::uint32_t {
+    Locations = 1,
+    Rides = 2,
+    Drivers = 3,
+    Riders = 4
+};
+
+constexpr std::size_t fileHeaderSize = 8;
+constexpr std::size_t sectionHeaderSize = 16;
+constexpr std::size_t rideRecordSize = 32;        // encodeRide, shared with logs and shard messages
+constexpr std::size_t timedRideRecordSize = 48;   // rides section record
+constexpr std::size_t driverHeadSize = 24;
+constexpr std::size_t riderHeadSize = 16;
+constexpr std::size_t ioChunkSize = 1 << 20;
+constexpr std::uint32_t maxNameLength = 1 << 16;   // longest location, driver or rider name a reader accepts
+constexpr std::uint64_t unknownLength = UINT64_MAX;  // streamBytesLeft() of a stream that cannot seek
+
+struct SectionHeader {
+    SectionKind kind;
+    std::uint32_t recordSize;   // 0 for variable-size records
+    std::uint64_t count;
+};
+
+// Decoded ride record; on disk: id, pickup, dropoff, type + 3 pad bytes, distance, fare
+// The timestamps are stored only by the rides section; encodeRide leaves them out
+struct RideRecord {
+    std::int32_t rideID;
+    LocationID pickup;
+    LocationID dropoff;
+    RideType type;
+    double distance;
+    double fare;
+    std::int64_t requestedAt = 0;
+    std::int64_t completedAt = 0;
+};
+
+namespace detail {
+
+inline bool hostIsLittleEndian() {
+#if defined(__BYTE_ORDER__) && defined(__ORDER_LITTLE_ENDIAN__)
+    return __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__;
+#else
+    const std::uint16_t probe = 1;
+    unsigned char first;
+    std::memcpy(&first, &probe, 1);
+    return first == 1;
+#endif
+}
+
+// memcpy-based loads and stores compile to plain moves on little-endian hosts
+template <typename T>
+void storeLE(unsigned char* out, T value) {
+    static_assert(sizeof(T) == 2 || sizeof(T) == 4 || sizeof(T) == 8, "unsupported width");
+    unsigned char bytes[sizeof(T)];
+    std::memcpy(bytes, &value, sizeof(T));
+    if (hostIsLittleEndian()) {
+        std::memcpy(out, bytes, sizeof(T));
+    } else {
+        for (std::size_t i = 0; i < sizeof(T); ++i) {
+            out[i] = bytes[sizeof(T) - 1 - i];
+        }
+    }
+}
+
+template <typename T>
+T loadLE(const unsigned char* in) {
+    static_assert(sizeof(T) == 2 || sizeof(T) == 4 || sizeof(T) == 8, "unsupported width");
+    unsigned char bytes[sizeof(T)];
+    if (hostIsLittleEndian()) {
+        std::memcpy(bytes, in, sizeof(T));
+    } else {
+        for (std::size_t i = 0; i < sizeof(T); ++i) {
+            bytes[i] = in[sizeof(T) - 1 - i];
+        }
+    }
+    T value;
+    std::memcpy(&value, bytes, sizeof(T));
+    return value;
+}
+
+// Bytes from the read position to the end, restoring the position; unknownLength for a pipe
+inline std::uint64_t streamBytesLeft(std::istream& in) {
+    const std::istream::pos_type at = in.tellg();
+    if (at == std::istream::pos_type(-1)) {
+        in.clear();
+        return unknownLength;
+    }
+    in.seekg(0, std::ios::end);
+    const std::istream::pos_type end = in.tellg();
+    in.seekg(at);
+    if (end == std::istream::pos_type(-1) || !in) {
+        in.clear();
+        in.seekg(at);
+        return unknownLength;
+    }
+    return end > at ? static_cast<std::uint64_t>(end - at) : 0;
+}
+
+// False if count records of size bytes each cannot fit in left bytes; no count * size overflow
+inline bool fits(std::uint64_t count, std::size_t size, std::uint64_t left) {
+    return size == 0 || count <= left / size;
+}
+
+inline void encodeRide(unsigned char* out, const RideRecord& record) {
+    storeLE<std::int32_t>(out, record.rideID);
+    storeLE<std::uint32_t>(out + 4, record.pickup);
+    storeLE<std::uint32_t>(out + 8, record.dropoff);
+    out[12] = static_cast<unsigned char>(record.type);
+    out[13] = out[14] = out[15] = 0;
+    storeLE<double>(out + 16, record.distance);
+    storeLE<double>(out + 24, record.fare);
+}
+
+inline RideRecord decodeRide(const unsigned char* in) {
+    RideRecord record;
+    record.rideID = loadLE<std::int32_t>(in);
+    record.pickup = loadLE<std::uint32_t>(in + 4);
+    record.dropoff = loadLE<std::uint32_t>(in + 8);
+    record.type = static_cast<RideType>(in[12]);
+    record.distance = loadLE<double>(in + 16);
+    record.fare = loadLE<double>(in + 24);
+    return record;
+}
+
+} // namespace detail
+
+inline RideRecord toRecord(const Ride& ride) {
+    return RideRecord{ ride.getRideID(), ride.getPickupLocationID(), ride.getDropoffLocationID(),
+                       ride.getRideType(), ride.getDistance(), ride.getFare(),
+                       ride.getRequestedAt(), ride.getCompletedAt() };
+}
+
+/**
+ * @brief Writer class - buffered streaming encoder
+ * Sections are declared with their record count up front and must be filled exactly
+ */
+class Writer {
+private:
+    std::ostream& out;
+    std::unique_ptr<unsigned char[]> buffer;
+    std::size_t used;
+    std::uint64_t remaining;
+    SectionKind currentKind;
+
+    // Callers never ask for more than a record head or a short name at once
+    unsigned char* reserveBytes(std::size_t size) {
+        if (used + size > ioChunkSize) {
+            flush();
+        }
+        unsigned char* at = buffer.get() + used;
+        used += size;
+        return at;
+    }
+
+    void appendBytes(const void* data, std::size_t size) {
+        const unsigned char* bytes = static_cast<const unsigned char*>(data);
+        if (size >= ioChunkSize) {
+            flush();
+            out.write(reinterpret_cast<const char*>(bytes), static_cast<std::streamsize>(size));
+            return;
+        }
+        std::memcpy(reserveBytes(size), bytes, size);
+    }
+
+    void beginSection(SectionKind kind, std::uint32_t recordSize, std::uint64_t count) {
+        if (remaining != 0) {
+            throw std::logic_error("Previous section is not complete");
+        }
+        unsigned char* header = reserveBytes(sectionHeaderSize);
+        detail::storeLE<std::uint32_t>(header, static_cast<std::uint32_t>(kind));
+        detail::storeLE<std::uint32_t>(header + 4, recordSize);
+        detail::storeLE<std::uint64_t>(header + 8, count);
+        remaining = count;
+        currentKind = kind;
+    }
+
+    void takeRecord(SectionKind kind) {
+        if (remaining == 0 || currentKind != kind) {
+            throw std::logic_error("Record does not belong to the open section");
+        }
+        --remaining;
+    }
+
+    void writeName(const std::string& name) {
+        appendBytes(name.data(), name.size());
+    }
+
+    void writeRideIndices(const std::vector<RideIndex>& rides) {
+        for (RideIndex ride : rides) {
+            detail::storeLE<std::uint32_t>(reserveBytes(4), ride);
+        }
+    }
+
+public:
+    explicit Writer(std::ostream& out)
+        : out(out), buffer(new unsigned char[ioChunkSize]), used(0), remaining(0),
+          currentKind(SectionKind::Locations) {
+        unsigned char* header = reserveBytes(fileHeaderSize);
+        detail::storeLE<std::uint32_t>(header, magic);
+        detail::storeLE<std::uint16_t>(header + 4, version);
+        detail::storeLE<std::uint16_t>(header + 6, 0);
+    }
+
+    ~Writer() {
+        try {
+            flush();
+        } catch (...) {
+        }
+    }
+
+    Writer(const Writer&) = delete;
+    Writer& operator=(const Writer&) = delete;
+
+    // Writes every name in the table; ride records then use the table's own IDs
+    void writeLocations(const LocationTable& table) {
+        const std::size_t count = table.size();
+        beginSection(SectionKind::Locations, 0, count);
+        for (LocationID id = 0; id < count; ++id) {
+            takeRecord(SectionKind::Locations);
+            const std::string& name = table.name(id);
+            detail::storeLE<std::uint32_t>(reserveBytes(4), static_cast<std::uint32_t>(name.size()));
+            writeName(name);
+        }
+    }
+
+    void beginRides(std::uint64_t count) { beginSection(SectionKind::Rides, timedRideRecordSize, count); }
+
+    void writeRide(const RideRecord& record) {
+        takeRecord(SectionKind::Rides);
+        unsigned char* at = reserveBytes(timedRideRecordSize);
+        detail::encodeRide(at, record);
+        detail::storeLE<std::int64_t>(at + rideRecordSize, record.requestedAt);
+        detail::storeLE<std::int64_t>(at + rideRecordSize + 8, record.completedAt);
+    }
+
+    void writeRide(const Ride& ride) { writeRide(toRecord(ride)); }
+
+    // Whole registry in index order, so file ride index == RideIndex
+    void writeRides(const RideRegistry& registry) {
+        beginRides(registry.size());
+        for (RideIndex i = 0; i < registry.size(); ++i) {
+            writeRide(registry.get(i));
+        }
+    }
+
+    void beginDrivers(std::uint64_t count) { beginSection(SectionKind::Drivers, driverHeadSize, count); }
+
+    void writeDriver(const Driver& driver) {
+        takeRecord(SectionKind::Drivers);
+        const auto& rides = driver.getAssignedRides();
+        unsigned char* head = reserveBytes(driverHeadSize);
+        detail::storeLE<std::int32_t>(head, driver.getDriverID());
+        detail::storeLE<std::uint32_t>(head + 4, static_cast<std::uint32_t>(driver.getName().size()));
+        detail::storeLE<double>(head + 8, driver.getRating());
+        detail::storeLE<std::uint32_t>(head + 16, static_cast<std::uint32_t>(rides.size()));
+        detail::storeLE<std::uint32_t>(head + 20, 0);
+        writeName(driver.getName());
+        writeRideIndices(rides);
+    }
+
+    void beginRiders(std::uint64_t count) { beginSection(SectionKind::Riders, riderHeadSize, count); }
+
+    void writeRider(const Rider& rider) {
+        takeRecord(SectionKind::Riders);
+        const auto& rides = rider.getRequestedRides();
+        unsigned char* head = reserveBytes(riderHeadSize);
+        detail::storeLE<std::int32_t>(head, rider.getRiderID());
+        detail::storeLE<std::uint32_t>(head + 4, static_cast<std::uint32_t>(rider.getName().size()));
+        detail::storeLE<std::uint32_t>(head + 8, static_cast<std::uint32_t>(rides.size()));
+        detail::storeLE<std::uint32_t>(head + 12, 0);
+        writeName(rider.getName());
+        writeRideIndices(rides);
+    }
+
+    void flush() {
+        if (used != 0) {
+            out.write(reinterpret_cast<const char*>(buffer.get()), static_cast<std::streamsize>(used));
+            used = 0;
+        }
+        if (!out) {
+            throw std::runtime_error("Failed to write ride data");
+        }
+    }
+};
+
+/**
+ * @brief Reader class - streaming decoder
+ * Call nextSection() and then the matching read* method for each section.
+ * Location IDs are remapped onto the target table, and ride indices are offset
+ * by wherever the rides section landed in the target registry.
+ * Counts and lengths from the stream are checked against the bytes left in it
+ * before anything is sized by them; a stream that cannot seek is instead read
+ * a chunk at a time, so a corrupt count fails with "Truncated ride data"
+ * rather than a huge allocation.
+ */
+class Reader {
+private:
+    std::istream& in;
+    std::vector<unsigned char> chunk;
+    std::vector<LocationID> locationMap;
+    RideIndex rideBase;
+    SectionHeader section;
+    bool sectionOpen;
+    std::uint64_t left;   // bytes not yet read, or unknownLength
+
+    void readExact(void* data, std::size_t size) {
+        in.read(static_cast<char*>(data), static_cast<std::streamsize>(size));
+        if (static_cast<std::size_t>(in.gcount()) != size) {
+            throw std::runtime_error("Truncated ride data");
+        }
+        if (left != unknownLength) {
+            left -= size;
+        }
+    }
+
+    void requireBytes(std::uint64_t count, std::size_t size) const {
+        if (!detail::fits(count, size, left)) {
+            throw std::runtime_error("Truncated ride data");
+        }
+    }
+
+    // Records worth reserving up front: all of them when the stream length is known, else one chunk
+    std::size_t reservable(std::uint64_t count, std::size_t size) const {
+        requireBytes(count, size);
+        if (size == 0) {
+            return 0;   // unvalidated record size; the section reader rejects it
+        }
+        if (left == unknownLength) {
+            return static_cast<std::size_t>(std::min<std::uint64_t>(count, ioChunkSize / size));
+        }
+        return static_cast<std::size_t>(count);
+    }
+
+    std::uint32_t readU32() {
+        unsigned char bytes[4];
+        readExact(bytes, 4);
+        return detail::loadLE<std::uint32_t>(bytes);
+    }
+
+    void expectSection(SectionKind kind) {
+        if (!sectionOpen || section.kind != kind) {
+            throw std::logic_error("Current section is not of the requested kind");
+        }
+        sectionOpen = false;
+    }
+
+    LocationID mapLocation(LocationID fileID) const {
+        if (locationMap.empty()) {
+            return fileID;   // stream without a locations section shares the live table's IDs
+        }
+        if (fileID >= locationMap.size()) {
+            throw std::runtime_error("Ride refers to an unknown location");
+        }
+        return locationMap[fileID];
+    }
+
+    std::string readName(std::uint32_t length) {
+        if (length > maxNameLength) {
+            throw std::runtime_error("Name too long in ride data");
+        }
+        requireBytes(length, 1);
+        std::string name(length, '\0');
+        if (length != 0) {
+            readExact(&name[0], length);
+        }
+        return name;
+    }
+
+    // History entries go back into the rolling windows at the ride's own time, not at load time
+    static std::int64_t historyTimestamp(const RideRegistry& registry, RideIndex ride, bool completedFirst) {
+        if (!registry.contains(ride)) {
+            throw std::runtime_error("Ride data refers to an unknown ride");
+        }
+        const Ride& recorded = registry.get(ride);
+        const std::int64_t first = completedFirst ? recorded.getCompletedAt() : recorded.getRequestedAt();
+        const std::int64_t second = completedFirst ? recorded.getRequestedAt() : recorded.getCompletedAt();
+        return first != 0 ? first : second != 0 ? second : currentTimestamp();
+    }
+
+    std::vector<RideIndex> readRideIndices(std::uint32_t count) {
+        std::vector<RideIndex> rides;
+        rides.reserve(reservable(count, 4));
+        const std::size_t perChunk = ioChunkSize / 4;
+        std::uint32_t remaining = count;
+        while (remaining > 0) {
+            const std::size_t n = std::min<std::size_t>(remaining, perChunk);
+            chunk.resize(n * 4);
+            readExact(chunk.data(), chunk.size());
+            for (std::size_t i = 0; i < n; ++i) {
+                rides.push_back(rideBase + detail::loadLE<std::uint32_t>(chunk.data() + i * 4));
+            }
+            remaining -= static_cast<std::uint32_t>(n);
+        }
+        return rides;
+    }
+
+    // Decodes the rides section chunk by chunk and hands every record to sink
+    template <typename Sink>
+    void forEachRide(Sink&& sink) {
+        expectSection(SectionKind::Rides);
+        const std::size_t recordSize = section.recordSize;
+        if (recordSize != timedRideRecordSize && recordSize != rideRecordSize) {
+            throw std::runtime_error("Unexpected ride record size");
+        }
+        requireBytes(section.count, recordSize);
+        const std::size_t perChunk = ioChunkSize / recordSize;
+        std::uint64_t left = section.count;
+        chunk.resize(perChunk * recordSize);
+        while (left > 0) {
+            const std::size_t n = static_cast<std::size_t>(std::min<std::uint64_t>(left, perChunk));
+            readExact(chunk.data(), n * recordSize);
+            for (std::size_t i = 0; i < n; ++i) {
+                const unsigned char* at = chunk.data() + i * recordSize;
+                RideRecord record = detail::decodeRide(at);
+                if (recordSize == timedRideRecordSize) {
+                    record.requestedAt = detail::loadLE<std::int64_t>(at + rideRecordSize);
+                    record.completedAt = detail::loadLE<std::int64_t>(at + rideRecordSize + 8);
+                }
+                if (!isValidRideType(record.type)) {
+                    throw std::runtime_error("Unknown ride type in ride data");
+                }
+                sink(record);
+            }
+            left -= n;
+        }
+    }
+
+public:
+    explicit Reader(std::istream& in)
+        : in(in), rideBase(0), section{}, sectionOpen(false), left(detail::streamBytesLeft(in)) {
+        unsigned char header[fileHeaderSize];
+        readExact(header, fileHeaderSize);
+        if (detail::loadLE<std::uint32_t>(header) != magic) {
+            throw std::runtime_error("Not a ride data stream");
+        }
+        if (detail::loadLE<std::uint16_t>(header + 4) != version) {
+            throw std::runtime_error("Unsupported ride data version");
+        }
+    }
+
+    // Returns false at a clean end of stream
+    bool nextSection(SectionHeader& header) {
+        if (sectionOpen) {
+            throw std::logic_error("Previous section was not read");
+        }
+        unsigned char bytes[sectionHeaderSize];
+        in.read(reinterpret_cast<char*>(bytes), sectionHeaderSize);
+        if (in.gcount() == 0 && in.eof()) {
+            return false;
+        }
+        if (static_cast<std::size_t>(in.gcount()) != sectionHeaderSize) {
+            throw std::runtime_error("Truncated ride data");
+        }
+        if (left != unknownLength) {
+            left -= sectionHeaderSize;
+        }
+        section.kind = static_cast<SectionKind>(detail::loadLE<std::uint32_t>(bytes));
+        section.recordSize = detail::loadLE<std::uint32_t>(bytes + 4);
+        section.count = detail::loadLE<std::uint64_t>(bytes + 8);
+        sectionOpen = true;
+        header = section;
+        return true;
+    }
+
+    void readLocations(LocationTable& table) {
+        expectSection(SectionKind::Locations);
+        locationMap.clear();
+        locationMap.reserve(reservable(section.count, 4));
+        for (std::uint64_t i = 0; i < section.count; ++i) {
+            locationMap.push_back(table.intern(readName(readU32())));
+        }
+    }
+
+    // Rebuilds Ride objects at the end of the registry, keeping their stored fares
+    void readRides(RideRegistry& registry) {
+        rideBase = static_cast<RideIndex>(registry.size());
+        registry.reserve(registry.size() + reservable(section.count, section.recordSize));
+        forEachRide([&](const RideRecord& record) {
+            const LocationID pickup = mapLocation(record.pickup);
+            const LocationID dropoff = mapLocation(record.dropoff);
+            RideIndex ride;
+            switch (record.type) {
+                case RideType::Standard:
+                    ride = registry.create<StandardRide>(record.rideID, pickup, dropoff, record.distance);
+                    break;
+                case RideType::Premium:
+                    ride = registry.create<PremiumRide>(record.rideID, pickup, dropoff, record.distance);
+                    break;
+                case RideType::Pooled:
+                    ride = registry.create<PooledRide>(record.rideID, pickup, dropoff, record.distance);
+                    break;
+                default:
+                    throw std::runtime_error("Unknown ride type in ride data");
+            }
+            Ride& restored = registry[ride];
+            restored.restoreFare(record.fare);
+            restored.markRequested(record.requestedAt);
+            restored.markCompleted(record.completedAt);
+        });
+    }
+
+    // Loads only the columnar fields, the fast path for bulk fare jobs
+    void readRides(RideBatch& batch) {
+        batch.reserve(batch.size() + reservable(section.count, section.recordSize));
+        forEachRide([&](const RideRecord& record) {
+            batch.addRide(record.rideID, record.distance, record.type, record.fare);
+        });
+    }
+
+    void readDrivers(const RideRegistry& registry, std::vector<Driver>& drivers) {
+        expectSection(SectionKind::Drivers);
+        drivers.reserve(drivers.size() + reservable(section.count, driverHeadSize));
+        unsigned char head[driverHeadSize];
+        for (std::uint64_t i = 0; i < section.count; ++i) {
+            readExact(head, driverHeadSize);
+            const std::int32_t id = detail::loadLE<std::int32_t>(head);
+            const std::uint32_t nameLength = detail::loadLE<std::uint32_t>(head + 4);
+            const double rating = detail::loadLE<double>(head + 8);
+            const std::uint32_t rideCount = detail::loadLE<std::uint32_t>(head + 16);
+            drivers.emplace_back(id, readName(nameLength), rating, registry);
+            for (RideIndex ride : readRideIndices(rideCount)) {
+                drivers.back().addRide(ride, historyTimestamp(registry, ride, true));
+            }
+        }
+    }
+
+    void readRiders(const RideRegistry& registry, std::vector<Rider>& riders) {
+        expectSection(SectionKind::Riders);
+        riders.reserve(riders.size() + reservable(section.count, riderHeadSize));
+        unsigned char head[riderHeadSize];
+        for (std::uint64_t i = 0; i < section.count; ++i) {
+            readExact(head, riderHeadSize);
+            const std::int32_t id = detail::loadLE<std::int32_t>(head);
+            const std::uint32_t nameLength = detail::loadLE<std::uint32_t>(head + 4);
+            const std::uint32_t rideCount = detail::loadLE<std::uint32_t>(head + 8);
+            riders.emplace_back(id, readName(nameLength), registry);
+            for (RideIndex ride : readRideIndices(rideCount)) {
+                riders.back().requestRide(ride, historyTimestamp(registry, ride, false));
+            }
+        }
+    }
+};
+
+} // namespace ride_binary
+
+#endif // RIDE_SHARING_RIDE_BINARY_H
@@ -0,0 +1,528 @@
+#ifndef RIDE_SHARING_RIDE_HISTORY_STORE_H
+#define RIDE_SHARING_RIDE_HISTORY_STORE_H
+
+#if !defined(__unix__) && !defined(__APPLE__)
+#error "RideHistoryStore requires POSIX mmap"
+#endif
+
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <iterator>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <cerrno>
+#include <stdexcept>
+#include <system_error>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "ride.h"
+#include "ride_binary.h"
+#include "crc32.h"
+#include "location_table.h"
+#include "driver.h"
+#include "rider.h"
+
+class RideHistoryStore;
+
+/**
+ * @brief RideRecordView class - zero-copy view of one ride inside the mapped file
+ * Fields are decoded on access straight from the mapping
+ */
+class RideRecordView {
+private:
+    const RideHistoryStore* store;
+    const unsigned char* record;
+
+public:
+    RideRecordView(const RideHistoryStore* store, const unsigned char* record) : store(store), record(record) {}
+
+    int getRideID() const;
+    LocationID getPickupLocationID() const;
+    LocationID getDropoffLocationID() const;
+    const std::string& getPickupLocation() const { return LocationTable::global().name(getPickupLocationID()); }
+    const std::string& getDropoffLocation() const { return LocationTable::global().name(getDropoffLocationID()); }
+    RideType getRideType() const;
+    double getDistance() const;
+    double getFare() const;
+
+    // Same output as Ride::rideDetails() of the stored ride type
+    void rideDetails() const {
+        std::cout << "Ride ID: " << getRideID()
+                  << "\nPickup: " << getPickupLocation()
+                  << "\nDropoff: " << getDropoffLocation()
+                  << "\nDistance: " << getDistance() << " miles"
+                  << "\nFare: $" << std::fixed << std::setprecision(2) << getFare()
+                  << " (" << rideTypeLabel(getRideType()) << ")" << std::endl;
+    }
+
+    void rideDetails(std::string& out) const {
+        appendRideDetails(out, getRideID(), getPickupLocation(), getDropoffLocation(), getDistance(), getFare());
+        out += " (";
+        out += rideTypeLabel(getRideType());
+        out += ")\n";
+    }
+};
+
+/**
+ * @brief RideHistoryView class - one owner's history, oldest ride first
+ * Walks the per-owner chain inside the mapping; nothing is copied to the heap
+ */
+class RideHistoryView {
+private:
+    const RideHistoryStore* store;
+    std::uint64_t head;
+    std::uint32_t count;
+
+public:
+    class iterator {
+    private:
+        const RideHistoryStore* store;
+        std::uint64_t link;   // record number + 1, 0 at the end
+
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = RideRecordView;
+        using difference_type = std::ptrdiff_t;
+        using pointer = void;
+        using reference = RideRecordView;
+
+        iterator(const RideHistoryStore* store, std::uint64_t link) : store(store), link(link) {}
+
+        RideRecordView operator*() const;
+        iterator& operator++();
+        iterator operator++(int) {
+            iterator previous = *this;
+            ++*this;
+            return previous;
+        }
+        bool operator==(const iterator& other) const { return link == other.link; }
+        bool operator!=(const iterator& other) const { return link != other.link; }
+    };
+
+    RideHistoryView(const RideHistoryStore* store, std::uint64_t head, std::uint32_t count)
+        : store(store), head(head), count(count) {}
+
+    iterator begin() const { return iterator(store, head); }
+    iterator end() const { return iterator(store, 0); }
+    std::size_t size() const { return count; }
+    bool empty() const { return count == 0; }
+};
+
+/**
+ * @brief RideHistoryStore class - append-only, memory-mapped ride history file
+ *
+ * Every record is 48 bytes: a link to the owner's next record, the owner
+ * (rider or driver ID), owner kind, a 24-bit CRC-32 of everything but the link,
+ * and a ride_binary ride record. Records of one owner form
+ * a chain, so a history is served by walking the mapping and the page cache
+ * decides what stays resident. A large virtual window is mapped once and the
+ * file grows underneath it, so views stay valid while appending. Location names
+ * live in a companion "<path>.loc" file and are remapped onto the live table.
+ *
+ * Opening rescans the records to rebuild the in-memory owner index (three words
+ * per owner) and every link. Records straddle pages and dirty pages reach disk
+ * in any order, so after a crash any record written since the last sync() may
+ * be missing or torn: recovery keeps the records up to the first one that fails
+ * its checksum or names a location the .loc file lost, and later appends
+ * overwrite the rest. Only what sync() returned for is durable. Files written
+ * before records carried a checksum (header format 0) are recovered up to the
+ * first record with no owner kind. Not thread-safe.
+ */
+class RideHistoryStore {
+public:
+    enum class Owner : std::uint8_t {
+        Rider = 1,
+        Driver = 2
+    };
+
+    static constexpr std::size_t headerSize = 16;
+    static constexpr std::size_t recordSize = 48;
+    static constexpr std::size_t rideOffset = 16;
+    static constexpr std::uint16_t historyKind = 2;
+    static constexpr std::uint16_t checksummedFormat = 1;   // header bytes 8-9
+    static constexpr std::size_t defaultWindowBytes = std::size_t(1) << 32;
+    static constexpr std::size_t growthBytes = std::size_t(16) << 20;
+
+private:
+    struct Chain {
+        std::uint64_t head;
+        std::uint64_t tail;
+        std::uint32_t count;
+    };
+
+    std::string path;
+    int fd;
+    int locationFd;
+    unsigned char* base;
+    std::size_t windowBytes;
+    std::size_t fileBytes;
+    std::uint64_t records;
+    bool checksummed;
+    std::unordered_map<std::uint64_t, Chain> owners;
+    std::vector<LocationID> fileToLive;
+    std::unordered_map<LocationID, std::uint32_t> liveToFile;
+
+    friend class RideRecordView;
+    friend class RideHistoryView::iterator;
+
+    [[noreturn]] static void fail(const std::string& what) {
+        throw std::system_error(errno, std::generic_category(), what);
+    }
+
+    static std::uint64_t ownerKey(Owner owner, int id) {
+        return (static_cast<std::uint64_t>(owner) << 32) | static_cast<std::uint32_t>(id);
+    }
+
+    unsigned char* recordAt(std::uint64_t number) const {
+        return base + headerSize + number * recordSize;
+    }
+
+    const unsigned char* linkedRecord(std::uint64_t link) const { return recordAt(link - 1); }
+
+    // Low 24 bits of the CRC-32 of the owner ID, owner kind and ride; the link is rewritten in place
+    static std::uint32_t checksumOf(const unsigned char* record) {
+        return crc32(record + rideOffset, ride_binary::rideRecordSize, crc32(record + 8, 5)) & 0xFFFFFFu;
+    }
+
+    static std::uint32_t storedChecksum(const unsigned char* record) {
+        return record[13] | (static_cast<std::uint32_t>(record[14]) << 8) | (static_cast<std::uint32_t>(record[15]) << 16);
+    }
+
+    bool intact(const unsigned char* record) const {
+        const Owner owner = static_cast<Owner>(record[12]);
+        if (owner != Owner::Rider && owner != Owner::Driver) {
+            return false;
+        }
+        if (checksummed && storedChecksum(record) != checksumOf(record)) {
+            return false;
+        }
+        const unsigned char* ride = record + rideOffset;
+        return ride_binary::detail::loadLE<std::uint32_t>(ride + 4) < fileToLive.size()
+            && ride_binary::detail::loadLE<std::uint32_t>(ride + 8) < fileToLive.size()
+            && isValidRideType(static_cast<RideType>(ride[12]));
+    }
+
+    LocationID liveLocation(std::uint32_t fileID) const {
+        if (fileID >= fileToLive.size()) {
+            throw std::runtime_error("Ride history record refers to an unknown location");
+        }
+        return fileToLive[fileID];
+    }
+
+    void resizeFile(std::size_t bytes) {
+        if (bytes > windowBytes) {
+            throw std::length_error("Ride history store exceeds its mapping window");
+        }
+        if (::ftruncate(fd, static_cast<off_t>(bytes)) != 0) {
+            fail("Failed to grow ride history file");
+        }
+        fileBytes = bytes;
+    }
+
+    void loadLocations() {
+        struct stat info;
+        if (::fstat(locationFd, &info) != 0) {
+            fail("Failed to stat location file");
+        }
+        std::vector<unsigned char> bytes(static_cast<std::size_t>(info.st_size));
+        std::size_t done = 0;
+        while (done < bytes.size()) {
+            const ssize_t n = ::pread(locationFd, bytes.data() + done, bytes.size() - done, static_cast<off_t>(done));
+            if (n <= 0) {
+                fail("Failed to read location file");
+            }
+            done += static_cast<std::size_t>(n);
+        }
+        std::size_t at = 0;
+        while (at + 4 <= bytes.size()) {
+            const std::uint32_t length = ride_binary::detail::loadLE<std::uint32_t>(bytes.data() + at);
+            if (at + 4 + length > bytes.size()) {
+                break;   // torn tail from an interrupted append
+            }
+            const std::string name(reinterpret_cast<const char*>(bytes.data() + at + 4), length);
+            const LocationID live = LocationTable::global().intern(name);
+            liveToFile.emplace(live, static_cast<std::uint32_t>(fileToLive.size()));
+            fileToLive.push_back(live);
+            at += 4 + length;
+        }
+        if (at != bytes.size() && ::ftruncate(locationFd, static_cast<off_t>(at)) != 0) {
+            fail("Failed to trim location file");
+        }
+        if (::lseek(locationFd, 0, SEEK_END) < 0) {
+            fail("Failed to seek location file");
+        }
+    }
+
+    std::uint32_t fileLocation(LocationID live) {
+        auto found = liveToFile.find(live);
+        if (found != liveToFile.end()) {
+            return found->second;
+        }
+        const std::string& name = LocationTable::global().name(live);
+        std::vector<unsigned char> entry(4 + name.size());
+        ride_binary::detail::storeLE<std::uint32_t>(entry.data(), static_cast<std::uint32_t>(name.size()));
+        std::memcpy(entry.data() + 4, name.data(), name.size());
+        if (::write(locationFd, entry.data(), entry.size()) != static_cast<ssize_t>(entry.size())) {
+            fail("Failed to append location");
+        }
+        const std::uint32_t id = static_cast<std::uint32_t>(fileToLive.size());
+        fileToLive.push_back(live);
+        liveToFile.emplace(live, id);
+        return id;
+    }
+
+    // Links record `number` onto its owner's chain
+    void link(Owner owner, int ownerID, std::uint64_t number) {
+        auto result = owners.emplace(ownerKey(owner, ownerID), Chain{ number + 1, number + 1, 0 });
+        Chain& chain = result.first->second;
+        if (!result.second) {
+            unsigned char* tail = recordAt(chain.tail - 1);
+            if (ride_binary::detail::loadLE<std::uint64_t>(tail) != number + 1) {
+                ride_binary::detail::storeLE<std::uint64_t>(tail, number + 1);
+            }
+            chain.tail = number + 1;
+        }
+        ++chain.count;
+    }
+
+    void recover() {
+        const std::uint64_t capacity = (fileBytes - headerSize) / recordSize;
+        records = 0;
+        while (records < capacity) {
+            const unsigned char* record = recordAt(records);
+            if (!intact(record)) {
+                break;
+            }
+            const Owner owner = static_cast<Owner>(record[12]);
+            link(owner, ride_binary::detail::loadLE<std::int32_t>(record + 8), records);
+            ++records;
+        }
+        // Links are only rewritten where they differ, so a clean reopen dirties no pages
+        for (const auto& entry : owners) {
+            unsigned char* tail = recordAt(entry.second.tail - 1);
+            if (ride_binary::detail::loadLE<std::uint64_t>(tail) != 0) {
+                ride_binary::detail::storeLE<std::uint64_t>(tail, 0);
+            }
+        }
+    }
+
+    std::uint32_t countOf(Owner owner, int id, std::uint64_t& head) const {
+        auto found = owners.find(ownerKey(owner, id));
+        if (found == owners.end()) {
+            head = 0;
+            return 0;
+        }
+        head = found->second.head;
+        return found->second.count;
+    }
+
+public:
+    explicit RideHistoryStore(const std::string& path, std::size_t windowBytes = defaultWindowBytes)
+        : path(path), fd(-1), locationFd(-1), base(nullptr), windowBytes(windowBytes), fileBytes(0), records(0),
+          checksummed(true) {
+        fd = ::open(path.c_str(), O_RDWR | O_CREAT, 0644);
+        if (fd < 0) {
+            fail("Failed to open ride history file " + path);
+        }
+        locationFd = ::open((path + ".loc").c_str(), O_RDWR | O_CREAT, 0644);
+        if (locationFd < 0) {
+            const int error = errno;
+            ::close(fd);
+            errno = error;
+            fail("Failed to open location file for " + path);
+        }
+
+        try {
+            struct stat info;
+            if (::fstat(fd, &info) != 0) {
+                fail("Failed to stat ride history file");
+            }
+            fileBytes = static_cast<std::size_t>(info.st_size);
+            // recover() reads the whole file through the mapping
+            if (fileBytes > windowBytes) {
+                throw std::length_error("Ride history file " + path + " is larger than its mapping window");
+            }
+            const bool fresh = fileBytes < headerSize;
+            if (fresh) {
+                resizeFile(headerSize + growthBytes);
+            }
+
+            void* mapping = ::mmap(nullptr, windowBytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+            if (mapping == MAP_FAILED) {
+                fail("Failed to map ride history file");
+            }
+            base = static_cast<unsigned char*>(mapping);
+
+            if (fresh) {
+                ride_binary::detail::storeLE<std::uint32_t>(base, ride_binary::magic);
+                ride_binary::detail::storeLE<std::uint16_t>(base + 4, ride_binary::version);
+                ride_binary::detail::storeLE<std::uint16_t>(base + 6, historyKind);
+                ride_binary::detail::storeLE<std::uint16_t>(base + 8, checksummedFormat);
+            } else if (ride_binary::detail::loadLE<std::uint32_t>(base) != ride_binary::magic
+                       || ride_binary::detail::loadLE<std::uint16_t>(base + 4) != ride_binary::version
+                       || ride_binary::detail::loadLE<std::uint16_t>(base + 6) != historyKind) {
+                throw std::runtime_error("Not a ride history file: " + path);
+            } else {
+                checksummed = ride_binary::detail::loadLE<std::uint16_t>(base + 8) == checksummedFormat;
+            }
+
+            loadLocations();
+            recover();
+        } catch (...) {
+            if (base) {
+                ::munmap(base, windowBytes);
+            }
+            ::close(locationFd);
+            ::close(fd);
+            throw;
+        }
+    }
+
+    // Trims the growth slack so the file ends at the last record
+    ~RideHistoryStore() {
+        ::munmap(base, windowBytes);
+        // Best effort: leftover slack is zero-filled and skipped by recovery
+        const int trimmed = ::ftruncate(fd, static_cast<off_t>(headerSize + records * recordSize));
+        (void)trimmed;
+        ::close(locationFd);
+        ::close(fd);
+    }
+
+    RideHistoryStore(const RideHistoryStore&) = delete;
+    RideHistoryStore& operator=(const RideHistoryStore&) = delete;
+
+    void append(Owner owner, int ownerID, const ride_binary::RideRecord& ride) {
+        const std::size_t end = headerSize + (records + 1) * recordSize;
+        if (end > fileBytes) {
+            resizeFile(fileBytes + growthBytes);
+        }
+
+        ride_binary::RideRecord stored = ride;
+        stored.pickup = fileLocation(ride.pickup);
+        stored.dropoff = fileLocation(ride.dropoff);
+
+        unsigned char* record = recordAt(records);
+        ride_binary::detail::storeLE<std::uint64_t>(record, 0);
+        ride_binary::detail::storeLE<std::int32_t>(record + 8, ownerID);
+        record[12] = static_cast<unsigned char>(owner);
+        ride_binary::detail::encodeRide(record + rideOffset, stored);
+        const std::uint32_t checksum = checksumOf(record);
+        record[13] = static_cast<unsigned char>(checksum);
+        record[14] = static_cast<unsigned char>(checksum >> 8);
+        record[15] = static_cast<unsigned char>(checksum >> 16);
+
+        link(owner, ownerID, records);
+        ++records;
+    }
+
+    void appendRiderRide(int riderID, const Ride& ride) {
+        append(Owner::Rider, riderID, ride_binary::toRecord(ride));
+    }
+
+    void appendDriverRide(int driverID, const Ride& ride) {
+        append(Owner::Driver, driverID, ride_binary::toRecord(ride));
+    }
+
+    RideHistoryView riderHistory(int riderID) const {
+        std::uint64_t head;
+        const std::uint32_t count = countOf(Owner::Rider, riderID, head);
+        return RideHistoryView(this, head, count);
+    }
+
+    RideHistoryView driverHistory(int driverID) const {
+        std::uint64_t head;
+        const std::uint32_t count = countOf(Owner::Driver, driverID, head);
+        return RideHistoryView(this, head, count);
+    }
+
+    // Flushes new location names, then the mapped records, to disk
+    void sync() {
+        if (::fsync(locationFd) != 0) {
+            fail("Failed to sync location file");
+        }
+        if (::msync(base, headerSize + records * recordSize, MS_SYNC) != 0) {
+            fail("Failed to sync ride history file");
+        }
+    }
+
+    std::uint64_t size() const { return records; }
+    const std::string& getPath() const { return path; }
+};
+
+inline int RideRecordView::getRideID() const {
+    return ride_binary::detail::loadLE<std::int32_t>(record + RideHistoryStore::rideOffset);
+}
+
+inline LocationID RideRecordView::getPickupLocationID() const {
+    return store->liveLocation(ride_binary::detail::loadLE<std::uint32_t>(record + RideHistoryStore::rideOffset + 4));
+}
+
+inline LocationID RideRecordView::getDropoffLocationID() const {
+    return store->liveLocation(ride_binary::detail::loadLE<std::uint32_t>(record + RideHistoryStore::rideOffset + 8));
+}
+
+inline RideType RideRecordView::getRideType() const {
+    return static_cast<RideType>(record[RideHistoryStore::rideOffset + 12]);
+}
+
+inline double RideRecordView::getDistance() const {
+    return ride_binary::detail::loadLE<double>(record + RideHistoryStore::rideOffset + 16);
+}
+
+inline double RideRecordView::getFare() const {
+    return ride_binary::detail::loadLE<double>(record + RideHistoryStore::rideOffset + 24);
+}
+
+inline RideRecordView RideHistoryView::iterator::operator*() const {
+    return RideRecordView(store, store->linkedRecord(link));
+}
+
+inline RideHistoryView::iterator& RideHistoryView::iterator::operator++() {
+    link = ride_binary::detail::loadLE<std::uint64_t>(store->linkedRecord(link));
+    return *this;
+}
+
+// Rider::viewRides served from the mapped history instead of the in-memory vector
+inline void Rider::viewRides(const RideHistoryStore& history) const {
+    std::cout << "Rider ID: " << riderID
+              << "\nName: " << name
+              << "\nRequested Rides History:" << std::endl;
+
+    const RideHistoryView rides = history.riderHistory(riderID);
+    if (rides.empty()) {
+        std::cout << "No rides requested yet." << std::endl;
+        return;
+    }
+
+    for (const RideRecordView& ride : rides) {
+        ride.rideDetails();
+    }
+}
+
+inline void Rider::viewRides(const RideHistoryStore& history, std::string& out) const {
+    out += "Rider ID: ";
+    appendInt(out, riderID);
+    out += "\nName: ";
+    out += name;
+    out += "\nRequested Rides History:\n";
+
+    const RideHistoryView rides = history.riderHistory(riderID);
+    if (rides.empty()) {
+        out += "No rides requested yet.\n";
+        return;
+    }
+
+    for (const RideRecordView& ride : rides) {
+        ride.rideDetails(out);
+    }
+}
+
+#endif // RIDE_SHARING_RIDE_HISTORY_STORE_H
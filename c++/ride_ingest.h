@@ -0,0 +1,114 @@
+#ifndef RIDE_SHARING_RIDE_INGEST_H
+#define RIDE_SHARING_RIDE_INGEST_H
+
+#include <vector>
+#include <utility>
+#include <limits>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+
+#include "ride.h"
+#include "ride_registry.h"
+#include "location_table.h"
+#include "validation.h"
+
+/**
+ * @brief RawRideRecord struct - one row of an ingestion feed, not yet validated
+ */
+struct RawRideRecord {
+    int rideID;
+    LocationID pickup;
+    LocationID dropoff;
+    RideType type;
+    double distance;
+};
+
+struct IngestReport {
+    std::size_t accepted = 0;
+    std::vector<std::pair<std::size_t, ValidationError>> rejected;   // row, reason
+};
+
+/**
+ * @brief Validates a whole batch of rows in one pass
+ * Writes one ValidationError per row and returns how many rows are valid. The
+ * location table size is read once, and each check is a compare folded into a
+ * select, so the loop has no data-dependent branches to mispredict on bad rows.
+ */
+inline std::size_t validateRideRecords(const RawRideRecord* rows, std::size_t count, ValidationError* errors) {
+    const std::size_t locations = LocationTable::global().size();
+    std::size_t valid = 0;
+    for (std::size_t i = 0; i < count; ++i) {
+        const RawRideRecord& row = rows[i];
+        const bool distanceOk = row.distance > 0;
+        const bool finiteOk = std::isfinite(row.distance);
+        const bool locationsOk = row.pickup < locations && row.dropoff < locations;
+        const bool typeOk = isValidRideType(row.type);
+        ValidationError error = ValidationError::None;
+        error = typeOk ? error : ValidationError::InvalidRideType;
+        error = locationsOk ? error : ValidationError::UnknownLocation;
+        error = finiteOk ? error : ValidationError::NonFiniteDistance;
+        error = distanceOk ? error : ValidationError::NonPositiveDistance;
+        errors[i] = error;
+        valid += static_cast<std::size_t>(error == ValidationError::None);
+    }
+    return valid;
+}
+
+inline std::size_t validateRideRecords(const std::vector<RawRideRecord>& rows, std::vector<ValidationError>& errors) {
+    errors.resize(rows.size());
+    return validateRideRecords(rows.data(), rows.size(), errors.data());
+}
+
+/**
+ * @brief Validates rows, then creates a ride for every valid one
+ * Rejected rows are listed in the report with their reason; nothing throws for
+ * a bad row. created (if given) receives the new indices in row order.
+ */
+inline IngestReport ingestRides(RideRegistry& registry, const RawRideRecord* rows, std::size_t count,
+                                std::vector<RideIndex>* created = nullptr) {
+    std::vector<ValidationError> errors(count);
+    IngestReport report;
+    report.accepted = validateRideRecords(rows, count, errors.data());
+    report.rejected.reserve(count - report.accepted);
+    registry.reserve(registry.size() + report.accepted);
+    if (created != nullptr) {
+        created->reserve(created->size() + report.accepted);
+    }
+    for (std::size_t i = 0; i < count; ++i) {
+        if (errors[i] != ValidationError::None) {
+            report.rejected.emplace_back(i, errors[i]);
+            continue;
+        }
+        const RawRideRecord& row = rows[i];
+        if (registry.size() >= std::numeric_limits<RideIndex>::max()) {
+            report.rejected.emplace_back(i, ValidationError::RegistryFull);
+            --report.accepted;
+            continue;
+        }
+        // Already validated, so the constructors below cannot throw
+        RideIndex ride;
+        switch (row.type) {
+            case RideType::Premium:
+                ride = registry.create<PremiumRide>(row.rideID, row.pickup, row.dropoff, row.distance);
+                break;
+            case RideType::Pooled:
+                ride = registry.create<PooledRide>(row.rideID, row.pickup, row.dropoff, row.distance);
+                break;
+            default:
+                ride = registry.create<StandardRide>(row.rideID, row.pickup, row.dropoff, row.distance);
+                break;
+        }
+        if (created != nullptr) {
+            created->push_back(ride);
+        }
+    }
+    return report;
+}
+
+inline IngestReport ingestRides(RideRegistry& registry, const std::vector<RawRideRecord>& rows,
+                                std::vector<RideIndex>* created = nullptr) {
+    return ingestRides(registry, rows.data(), rows.size(), created);
+}
+
+#endif // RIDE_SHARING_RIDE_INGEST_H
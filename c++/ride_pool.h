@@ -0,0 +1,208 @@
+#ifndef RIDE_SHARING_RIDE_POOL_H
+#define RIDE_SHARING_RIDE_POOL_H
+
+#include <vector>
+#include <memory>
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <utility>
+#include <type_traits>
+#include <stdexcept>
+#include <algorithm>
+
+#include "ride.h"
+
+/**
+ * @brief RideHandle class - lightweight non-owning reference to a pooled ride
+ * Copying a handle is two plain words, no allocation and no refcount traffic
+ */
+class RideHandle {
+private:
+    Ride* ride;
+    std::uint32_t epoch;
+
+public:
+    RideHandle() : ride(nullptr), epoch(0) {}
+    RideHandle(Ride* ride, std::uint32_t epoch) : ride(ride), epoch(epoch) {}
+
+    Ride* get() const { return ride; }
+    Ride* operator->() const { return ride; }
+    Ride& operator*() const { return *ride; }
+    explicit operator bool() const { return ride != nullptr; }
+
+    std::uint32_t getEpoch() const { return epoch; }
+};
+
+/**
+ * @brief RidePool class - slab arena that owns Ride objects
+ * Rides are placement-constructed into large chunks grouped by dispatch epoch;
+ * releasing an epoch destroys all of its rides and recycles its chunks at once.
+ * RideRegistry keeps its rides in a single epoch that is never released.
+ * A pool is not thread-safe: use one per thread (see threadLocal()).
+ */
+class RidePool {
+public:
+    using EpochID = std::uint32_t;
+
+    static constexpr std::size_t chunkSize = 64 * 1024;
+
+private:
+    using Chunk = std::unique_ptr<std::max_align_t[]>;
+
+    struct Epoch {
+        EpochID id;
+        std::vector<Chunk> chunks;
+        std::size_t used;           // bytes used in chunks.back()
+        std::vector<Ride*> rides;   // construction order, destroyed in reverse
+    };
+
+    std::vector<Epoch> epochs;      // live epochs, oldest first; back() is current
+    std::vector<Chunk> freeChunks;
+    EpochID nextEpoch;
+
+    static Chunk newChunk() {
+        return Chunk(new std::max_align_t[chunkSize / sizeof(std::max_align_t)]);
+    }
+
+    Epoch& current() { return epochs.back(); }
+
+    Chunk takeChunk() {
+        if (freeChunks.empty()) {
+            return newChunk();
+        }
+        Chunk chunk = std::move(freeChunks.back());
+        freeChunks.pop_back();
+        return chunk;
+    }
+
+    // Bump-allocates from the current epoch, starting a new chunk when the current one is full
+    void* allocate(std::size_t size, std::size_t alignment) {
+        Epoch& epoch = current();
+        std::size_t offset = (epoch.used + alignment - 1) & ~(alignment - 1);
+        if (epoch.chunks.empty() || offset + size > chunkSize) {
+            epoch.chunks.push_back(takeChunk());
+            offset = 0;
+        }
+        epoch.used = offset + size;
+        return reinterpret_cast<unsigned char*>(epoch.chunks.back().get()) + offset;
+    }
+
+    void destroy(Epoch& epoch) {
+        for (auto it = epoch.rides.rbegin(); it != epoch.rides.rend(); ++it) {
+            (*it)->~Ride();
+        }
+        epoch.rides.clear();
+        for (auto& chunk : epoch.chunks) {
+            freeChunks.push_back(std::move(chunk));
+        }
+        epoch.chunks.clear();
+        epoch.used = 0;
+    }
+
+public:
+    RidePool() : nextEpoch(0) {
+        beginEpoch();
+    }
+
+    ~RidePool() {
+        while (!epochs.empty()) {
+            destroy(epochs.back());
+            epochs.pop_back();
+        }
+    }
+
+    RidePool(const RidePool&) = delete;
+    RidePool& operator=(const RidePool&) = delete;
+
+    // Per-thread pool for callers that do not manage their own
+    static RidePool& threadLocal() {
+        thread_local RidePool pool;
+        return pool;
+    }
+
+    /**
+     * @brief Constructs a ride of type T in the current epoch
+     * If the ride constructor throws, the arena space is reclaimed before rethrowing
+     */
+    template <typename T, typename... Args>
+    RideHandle create(Args&&... args) {
+        static_assert(std::is_base_of<Ride, T>::value, "RidePool only holds Ride subclasses");
+        static_assert(sizeof(T) <= chunkSize, "Ride type too large for a pool chunk");
+        static_assert(alignof(T) <= alignof(std::max_align_t), "Ride type over-aligned for a pool chunk");
+
+        Epoch& epoch = current();
+        const std::size_t usedBefore = epoch.used;
+        const std::size_t chunksBefore = epoch.chunks.size();
+        void* memory = allocate(sizeof(T), alignof(T));
+        T* ride;
+        try {
+            ride = new (memory) T(std::forward<Args>(args)...);
+        } catch (...) {
+            if (epoch.chunks.size() != chunksBefore) {
+                freeChunks.push_back(std::move(epoch.chunks.back()));
+                epoch.chunks.pop_back();
+            }
+            epoch.used = usedBefore;
+            throw;
+        }
+        epoch.rides.push_back(ride);
+        return RideHandle(ride, epoch.id);
+    }
+
+    // Pre-allocates enough free chunks for `count` rides of type T, so bulk creation never hits the heap
+    template <typename T>
+    void reserve(std::size_t count) {
+        const std::size_t perChunk = chunkSize / sizeof(T);
+        std::size_t needed = (count + perChunk - 1) / perChunk;
+        current().rides.reserve(current().rides.size() + count);
+        current().chunks.reserve(current().chunks.size() + needed);
+        while (freeChunks.size() < needed) {
+            freeChunks.push_back(newChunk());
+        }
+    }
+
+    // Starts a new dispatch epoch; subsequent rides are allocated into it
+    EpochID beginEpoch() {
+        epochs.push_back(Epoch{ nextEpoch, {}, 0, {} });
+        return nextEpoch++;
+    }
+
+    /**
+     * @brief Destroys every ride of an epoch at once and recycles its memory
+     * Handles into the epoch dangle afterwards; releasing the current epoch starts a fresh one
+     */
+    void releaseEpoch(EpochID id) {
+        auto it = std::find_if(epochs.begin(), epochs.end(),
+                               [id](const Epoch& epoch) { return epoch.id == id; });
+        if (it == epochs.end()) {
+            throw std::invalid_argument("Unknown or already released epoch");
+        }
+        const bool wasCurrent = (it + 1 == epochs.end());
+        destroy(*it);
+        epochs.erase(it);
+        if (wasCurrent) {
+            beginEpoch();
+        }
+    }
+
+    EpochID getCurrentEpoch() const { return epochs.back().id; }
+
+    bool isLive(const RideHandle& handle) const {
+        return handle && std::any_of(epochs.begin(), epochs.end(),
+                                     [&](const Epoch& epoch) { return epoch.id == handle.getEpoch(); });
+    }
+
+    std::size_t liveRideCount() const {
+        std::size_t count = 0;
+        for (const auto& epoch : epochs) {
+            count += epoch.rides.size();
+        }
+        return count;
+    }
+
+    std::size_t liveEpochCount() const { return epochs.size(); }
+    std::size_t freeChunkCount() const { return freeChunks.size(); }
+};
+
+#endif // RIDE_SHARING_RIDE_POOL_H
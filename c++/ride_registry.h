@@ -0,0 +1,111 @@
+#ifndef RIDE_SHARING_RIDE_REGISTRY_H
+#define RIDE_SHARING_RIDE_REGISTRY_H
+
+#include <vector>
+#include <string_view>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <utility>
+#include <stdexcept>
+
+#include "ride.h"
+#include "ride_pool.h"
+#include "validation.h"
+#include "metrics.h"
+
+// Compact reference to a ride in a RideRegistry
+using RideIndex = std::uint32_t;
+
+/**
+ * @brief RideRegistry class - central ride table
+ * Owns every ride (allocated from its own RidePool) and hands out 32-bit indices,
+ * so drivers and riders keep histories as plain index arrays instead of shared pointers.
+ * Rides live until the registry is destroyed: an index stays valid for its
+ * lifetime, so the registry never begins or releases a pool epoch. Per-epoch
+ * release (RidePool::releaseEpoch) is for rides created straight from a
+ * RidePool, which Driver and Rider histories cannot reference.
+ */
+class RideRegistry {
+private:
+    RidePool pool;
+    std::vector<Ride*> rides;
+
+public:
+    RideRegistry() = default;
+
+    RideRegistry(const RideRegistry&) = delete;
+    RideRegistry& operator=(const RideRegistry&) = delete;
+
+    // Registry used by drivers and riders that are not given one explicitly
+    static RideRegistry& global() {
+        static RideRegistry registry;
+        return registry;
+    }
+
+    template <typename T, typename... Args>
+    RideIndex create(Args&&... args) {
+        RIDE_METRICS_TIME(RideConstruction);
+        if (full()) {
+            throw std::length_error("Ride registry is full");
+        }
+        RideHandle handle = pool.create<T>(std::forward<Args>(args)...);
+        rides.push_back(handle.get());
+        return static_cast<RideIndex>(rides.size() - 1);
+    }
+
+    // RideIndex has no room for another ride
+    bool full() const { return rides.size() >= std::numeric_limits<RideIndex>::max(); }
+
+    /**
+     * @brief Non-throwing create for ingestion paths
+     * Checks the ride's preconditions and the registry's capacity first, so a bad
+     * record costs a compare instead of an exception; names are only interned for
+     * rides that will be created
+     */
+    template <typename T>
+    Result<RideIndex> tryCreate(int id, LocationID pickup, LocationID dropoff, double dist) {
+        const ValidationError error = Ride::validate(pickup, dropoff, dist);
+        if (error != ValidationError::None) {
+            return Result<RideIndex>::rejected(error);
+        }
+        if (full()) {
+            return Result<RideIndex>::rejected(ValidationError::RegistryFull);
+        }
+        return create<T>(id, pickup, dropoff, dist);
+    }
+
+    template <typename T>
+    Result<RideIndex> tryCreate(int id, std::string_view pickup, std::string_view dropoff, double dist) {
+        const ValidationError error = Ride::validate(dist);
+        if (error != ValidationError::None) {
+            return Result<RideIndex>::rejected(error);
+        }
+        if (full()) {
+            return Result<RideIndex>::rejected(ValidationError::RegistryFull);
+        }
+        LocationTable& table = LocationTable::global();
+        const LocationID pickupID = table.intern(pickup);
+        return tryCreate<T>(id, pickupID, table.intern(dropoff), dist);
+    }
+
+    void reserve(std::size_t count) { rides.reserve(count); }
+
+    // Reserves index slots and pool memory for count more rides of type T
+    template <typename T>
+    void reserve(std::size_t count) {
+        rides.reserve(rides.size() + count);
+        pool.reserve<T>(count);
+    }
+
+    bool contains(RideIndex index) const { return index < rides.size(); }
+
+    Ride& get(RideIndex index) { return *rides[index]; }
+    const Ride& get(RideIndex index) const { return *rides[index]; }
+    Ride& operator[](RideIndex index) { return *rides[index]; }
+    const Ride& operator[](RideIndex index) const { return *rides[index]; }
+
+    std::size_t size() const { return rides.size(); }
+};
+
+#endif // RIDE_SHARING_RIDE_REGISTRY_H
@@ -0,0 +1,24 @@
+#ifndef RIDE_SHARING_RIDE_REQUEST_H
+#define RIDE_SHARING_RIDE_REQUEST_H
+
+#include <cstdint>
+
+#include "ride.h"
+#include "geo.h"
+#include "location_table.h"
+
+/**
+ * @brief Ride request as it flows from ingestion to dispatch
+ * Plain trivially-copyable data so it can move through lock-free queues
+ */
+struct RideRequest {
+    std::uint64_t requestID;
+    int riderID;
+    LocationID pickupLocation;
+    LocationID dropoffLocation;
+    RideType type;
+    GeoPoint pickupPosition;
+    double distance;
+};
+
+#endif // RIDE_SHARING_RIDE_REQUEST_H
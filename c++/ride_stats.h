@@ -0,0 +1,173 @@
+#ifndef RIDE_SHARING_RIDE_STATS_H
+#define RIDE_SHARING_RIDE_STATS_H
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+#include "ride.h"
+
+// Seconds since the Unix epoch; the clock used when a caller gives no timestamp
+inline std::int64_t currentTimestamp() {
+    return std::chrono::duration_cast<std::chrono::seconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+/**
+ * @brief RideTotals struct - ride count with fare and distance sums
+ */
+struct RideTotals {
+    std::uint64_t count = 0;
+    double fare = 0.0;
+    double distance = 0.0;
+
+    void add(double rideFare, double rideDistance) {
+        ++count;
+        fare += rideFare;
+        distance += rideDistance;
+    }
+
+    double averageFare() const { return count == 0 ? 0.0 : fare / static_cast<double>(count); }
+    double averageDistance() const { return count == 0 ? 0.0 : distance / static_cast<double>(count); }
+};
+
+/**
+ * @brief RollingWindow class - ride totals over the trailing BucketCount * BucketSeconds
+ * A ring of time buckets plus a running total. Adding a ride expires the buckets
+ * that fell out of the window, so inserts are amortized O(1); a query only has to
+ * discount buckets that aged out since the last insert, at most BucketCount of them.
+ */
+template <std::int64_t BucketSeconds, std::size_t BucketCount>
+class RollingWindow {
+private:
+    struct Bucket {
+        std::int64_t slot = 0;
+        RideTotals totals;
+    };
+
+    std::array<Bucket, BucketCount> buckets{};
+    RideTotals running;
+    std::int64_t headSlot = 0;   // newest slot seen; 0 until the first ride
+    bool started = false;
+
+    static std::int64_t slotOf(std::int64_t timestamp) {
+        return timestamp >= 0 ? timestamp / BucketSeconds : (timestamp - BucketSeconds + 1) / BucketSeconds;
+    }
+
+    Bucket& bucketFor(std::int64_t slot) {
+        const std::int64_t wrapped = slot % static_cast<std::int64_t>(BucketCount);
+        return buckets[static_cast<std::size_t>(wrapped < 0 ? wrapped + BucketCount : wrapped)];
+    }
+
+    const Bucket& bucketFor(std::int64_t slot) const {
+        return const_cast<RollingWindow*>(this)->bucketFor(slot);
+    }
+
+    static void subtract(RideTotals& from, const RideTotals& part) {
+        from.count -= part.count;
+        if (from.count == 0) {
+            from = RideTotals{};   // drop accumulated rounding once the window empties
+            return;
+        }
+        from.fare -= part.fare;
+        from.distance -= part.distance;
+    }
+
+    void advance(std::int64_t slot) {
+        if (!started) {
+            headSlot = slot;
+            started = true;
+            return;
+        }
+        if (slot - headSlot >= static_cast<std::int64_t>(BucketCount)) {
+            buckets.fill(Bucket{});
+            running = RideTotals{};
+        } else {
+            for (std::int64_t s = headSlot + 1; s <= slot; ++s) {
+                Bucket& bucket = bucketFor(s);
+                subtract(running, bucket.totals);
+                bucket = Bucket{};
+            }
+        }
+        headSlot = slot;
+    }
+
+public:
+    static constexpr std::int64_t windowSeconds = BucketSeconds * static_cast<std::int64_t>(BucketCount);
+
+    // Rides older than the window are ignored; out-of-order rides inside it still count
+    void add(std::int64_t timestamp, double fare, double distance) {
+        const std::int64_t slot = slotOf(timestamp);
+        if (!started || slot > headSlot) {
+            advance(slot);
+        } else if (headSlot - slot >= static_cast<std::int64_t>(BucketCount)) {
+            return;
+        }
+        Bucket& bucket = bucketFor(slot);
+        bucket.slot = slot;
+        bucket.totals.add(fare, distance);
+        running.add(fare, distance);
+    }
+
+    // Totals for rides in the window ending at now, at bucket granularity
+    RideTotals totals(std::int64_t now) const {
+        if (!started) {
+            return RideTotals{};
+        }
+        const std::int64_t slot = slotOf(now);
+        if (slot <= headSlot) {
+            return running;
+        }
+        if (slot - headSlot >= static_cast<std::int64_t>(BucketCount)) {
+            return RideTotals{};
+        }
+        RideTotals result = running;
+        for (std::int64_t s = headSlot + 1; s <= slot; ++s) {
+            const Bucket& bucket = bucketFor(s);
+            if (bucket.slot == s - static_cast<std::int64_t>(BucketCount)) {
+                subtract(result, bucket.totals);
+            }
+        }
+        return result;
+    }
+};
+
+using HourWindow = RollingWindow<300, 12>;    // five-minute buckets
+using DayWindow = RollingWindow<3600, 24>;    // hourly buckets
+
+/**
+ * @brief RideStats class - running aggregates for one driver or rider
+ * Updated once per ride so reports read in O(1) instead of walking the history.
+ * A ride is counted with the fare it has when it is recorded.
+ */
+class RideStats {
+private:
+    RideTotals lifetime;
+    std::array<std::uint64_t, rideTypeCount> typeCounts{};
+    HourWindow hour;
+    DayWindow day;
+
+public:
+    void record(const Ride& ride, std::int64_t timestamp) {
+        const double fare = ride.getFare();
+        const double distance = ride.getDistance();
+        lifetime.add(fare, distance);
+        ++typeCounts[static_cast<std::size_t>(ride.getRideType())];
+        hour.add(timestamp, fare, distance);
+        day.add(timestamp, fare, distance);
+    }
+
+    std::uint64_t getRideCount() const { return lifetime.count; }
+    std::uint64_t getRideCount(RideType type) const { return typeCounts[static_cast<std::size_t>(type)]; }
+    double getTotalFare() const { return lifetime.fare; }
+    double getTotalDistance() const { return lifetime.distance; }
+    double getAverageFare() const { return lifetime.averageFare(); }
+    double getAverageDistance() const { return lifetime.averageDistance(); }
+    const RideTotals& getTotals() const { return lifetime; }
+
+    RideTotals lastHour(std::int64_t now = currentTimestamp()) const { return hour.totals(now); }
+    RideTotals lastDay(std::int64_t now = currentTimestamp()) const { return day.totals(now); }
+};
+
+#endif // RIDE_SHARING_RIDE_STATS_H
@@ -0,0 +1,262 @@
+#ifndef RIDE_SHARING_RIDE_TIMELINE_H
+#define RIDE_SHARING_RIDE_TIMELINE_H
+
+#include <vector>
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+
+#include "ride_registry.h"
+#include "ride_stats.h"
+
+/**
+ * @brief One timeline record: seconds into its bucket and the ride
+ * Eight bytes per ride; fare and distance are read from the registry when an
+ * edge bucket is scanned
+ */
+struct TimelineEntry {
+    std::uint32_t offset;
+    RideIndex ride;
+};
+
+/**
+ * @brief RideTimeline class - one driver's or rider's rides grouped into time buckets
+ * Buckets are fixed-width spans (a day by default) kept sorted by start time,
+ * each holding its entries sorted by timestamp, its RideTotals and the running
+ * totals through it. record() keeps the running totals current, so range
+ * totals take two binary searches plus a scan of the two edge buckets and
+ * const queries never write; concurrent readers are safe while nobody records.
+ * compactBefore() drops the per-ride entries of old buckets and keeps only
+ * their totals.
+ */
+class RideTimeline {
+public:
+    static constexpr std::int64_t daySeconds = 86400;
+    static constexpr std::int64_t weekSeconds = 7 * daySeconds;
+
+private:
+    struct Bucket {
+        std::int64_t start;
+        RideTotals totals;
+        RideTotals through;                   // totals of every bucket up to and including this one
+        std::vector<TimelineEntry> entries;   // empty once compacted
+        bool compacted = false;
+    };
+
+    const RideRegistry* rideTable;
+    std::int64_t bucketSeconds;
+    std::vector<Bucket> buckets;
+
+    std::int64_t bucketStart(std::int64_t timestamp) const {
+        const std::int64_t slot = timestamp >= 0 ? timestamp / bucketSeconds
+                                                 : (timestamp - bucketSeconds + 1) / bucketSeconds;
+        return slot * bucketSeconds;
+    }
+
+    // First bucket whose start is >= start
+    std::size_t lowerBucket(std::int64_t start) const {
+        return static_cast<std::size_t>(std::lower_bound(buckets.begin(), buckets.end(), start,
+            [](const Bucket& bucket, std::int64_t value) { return bucket.start < value; }) - buckets.begin());
+    }
+
+    // Index of the bucket starting at start, inserted empty if missing
+    std::size_t bucketAt(std::int64_t start) {
+        if (buckets.empty() || buckets.back().start < start) {
+            const RideTotals through = buckets.empty() ? RideTotals{} : buckets.back().through;
+            buckets.push_back(Bucket{ start, RideTotals{}, through, {} });
+            return buckets.size() - 1;
+        }
+        if (buckets.back().start == start) {
+            return buckets.size() - 1;
+        }
+        const std::size_t b = lowerBucket(start);
+        if (buckets[b].start != start) {
+            const RideTotals through = b == 0 ? RideTotals{} : buckets[b - 1].through;
+            buckets.insert(buckets.begin() + static_cast<std::ptrdiff_t>(b), Bucket{ start, RideTotals{}, through, {} });
+        }
+        return b;
+    }
+
+    // Recomputes running totals from bucket first on; O(1) when first is the newest bucket
+    void updateThrough(std::size_t first) {
+        for (std::size_t i = first; i < buckets.size(); ++i) {
+            RideTotals running = i == 0 ? RideTotals{} : buckets[i - 1].through;
+            running.count += buckets[i].totals.count;
+            running.fare += buckets[i].totals.fare;
+            running.distance += buckets[i].totals.distance;
+            buckets[i].through = running;
+        }
+    }
+
+    // Totals of whole buckets [first, last)
+    RideTotals bucketRange(std::size_t first, std::size_t last) const {
+        RideTotals totals;
+        if (first >= last) {
+            return totals;
+        }
+        totals = buckets[last - 1].through;
+        if (first > 0) {
+            totals.count -= buckets[first - 1].through.count;
+            totals.fare -= buckets[first - 1].through.fare;
+            totals.distance -= buckets[first - 1].through.distance;
+        }
+        return totals;
+    }
+
+    // Entries of bucket at or after timestamp
+    static std::vector<TimelineEntry>::const_iterator entriesFrom(const Bucket& bucket, std::int64_t timestamp) {
+        const std::int64_t offset = std::max<std::int64_t>(0, timestamp - bucket.start);
+        return std::lower_bound(bucket.entries.begin(), bucket.entries.end(), offset,
+            [](const TimelineEntry& entry, std::int64_t value) { return entry.offset < value; });
+    }
+
+    // Edge bucket scan; a compacted bucket counts wholly if its start lies in the range
+    void addPartial(RideTotals& totals, const Bucket& bucket, std::int64_t from, std::int64_t to) const {
+        if (bucket.compacted) {
+            if (bucket.start >= from && bucket.start < to) {
+                totals.count += bucket.totals.count;
+                totals.fare += bucket.totals.fare;
+                totals.distance += bucket.totals.distance;
+            }
+            return;
+        }
+        for (auto it = entriesFrom(bucket, from); it != bucket.entries.end() && bucket.start + it->offset < to; ++it) {
+            const Ride& recorded = rideTable->get(it->ride);
+            totals.add(recorded.getFare(), recorded.getDistance());
+        }
+    }
+
+public:
+    // Rides are indices into rides, which must outlive the timeline
+    explicit RideTimeline(const RideRegistry& rides = RideRegistry::global(), std::int64_t bucketSeconds = daySeconds)
+        : rideTable(&rides), bucketSeconds(bucketSeconds) {
+        if (bucketSeconds <= 0 || bucketSeconds > std::numeric_limits<std::uint32_t>::max()) {
+            throw std::invalid_argument("Bucket width must be between 1 second and 2^32 seconds");
+        }
+    }
+
+    /**
+     * @brief Adds a ride at timestamp (Unix seconds)
+     * fare and distance go into the bucket totals and should match the ride in
+     * the registry. Appending in time order touches only the newest bucket;
+     * late entries are inserted in place and update the running totals after them
+     */
+    void record(std::int64_t timestamp, RideIndex ride, double fare, double distance) {
+        const std::int64_t start = bucketStart(timestamp);
+        const std::size_t b = bucketAt(start);
+        Bucket& bucket = buckets[b];
+        bucket.totals.add(fare, distance);
+        if (!bucket.compacted) {
+            const TimelineEntry entry{ static_cast<std::uint32_t>(timestamp - start), ride };
+            if (bucket.entries.empty() || bucket.entries.back().offset <= entry.offset) {
+                bucket.entries.push_back(entry);
+            } else {
+                bucket.entries.insert(std::upper_bound(bucket.entries.begin(), bucket.entries.end(), entry,
+                    [](const TimelineEntry& a, const TimelineEntry& e) { return a.offset < e.offset; }), entry);
+            }
+        }
+        updateThrough(b);
+    }
+
+    /**
+     * @brief Makes room for count more rides in the bucket holding timestamp
+     * A batch recorded within that bucket then appends without allocating
+     */
+    void reserve(std::size_t count, std::int64_t timestamp = currentTimestamp()) {
+        Bucket& bucket = buckets[bucketAt(bucketStart(timestamp))];
+        if (!bucket.compacted) {
+            bucket.entries.reserve(bucket.entries.size() + count);
+        }
+    }
+
+    // Ride count, fare and distance for timestamps in [from, to)
+    RideTotals totalsBetween(std::int64_t from, std::int64_t to) const {
+        RideTotals totals;
+        if (from >= to || buckets.empty()) {
+            return totals;
+        }
+        const std::int64_t firstStart = bucketStart(from);
+        const std::int64_t lastStart = bucketStart(to - 1);
+        const std::size_t first = lowerBucket(firstStart);
+        const std::size_t last = lowerBucket(lastStart + 1);   // one past the bucket holding to - 1
+        if (first >= last) {
+            return totals;
+        }
+        if (first + 1 == last) {
+            addPartial(totals, buckets[first], from, to);
+            return totals;
+        }
+        // Edge buckets are scanned only when the range cuts through them
+        std::size_t wholeFirst = first;
+        std::size_t wholeLast = last;
+        if (buckets[first].start < from) {
+            addPartial(totals, buckets[first], from, to);
+            ++wholeFirst;
+        }
+        if (buckets[last - 1].start + bucketSeconds > to) {
+            addPartial(totals, buckets[last - 1], from, to);
+            --wholeLast;
+        }
+        const RideTotals whole = bucketRange(wholeFirst, wholeLast);
+        totals.count += whole.count;
+        totals.fare += whole.fare;
+        totals.distance += whole.distance;
+        return totals;
+    }
+
+    /**
+     * @brief Calls fn(timestamp, RideIndex) for every retained ride in [from, to), oldest first
+     * Rides in compacted buckets are no longer listed; use totalsBetween for them
+     */
+    template <typename Fn>
+    void forEachBetween(std::int64_t from, std::int64_t to, Fn&& fn) const {
+        if (from >= to) {
+            return;
+        }
+        for (std::size_t b = lowerBucket(bucketStart(from)); b < buckets.size() && buckets[b].start < to; ++b) {
+            const Bucket& bucket = buckets[b];
+            for (auto it = entriesFrom(bucket, from); it != bucket.entries.end(); ++it) {
+                const std::int64_t timestamp = bucket.start + it->offset;
+                if (timestamp >= to) {
+                    break;
+                }
+                fn(timestamp, it->ride);
+            }
+        }
+    }
+
+    std::vector<RideIndex> ridesBetween(std::int64_t from, std::int64_t to) const {
+        std::vector<RideIndex> rides;
+        forEachBetween(from, to, [&rides](std::int64_t, RideIndex ride) { rides.push_back(ride); });
+        return rides;
+    }
+
+    /**
+     * @brief Releases the per-ride entries of every bucket that ends at or before cutoff
+     * Totals are kept, so billing over old periods still works at bucket granularity.
+     * Returns the number of entries released.
+     */
+    std::size_t compactBefore(std::int64_t cutoff) {
+        std::size_t released = 0;
+        for (Bucket& bucket : buckets) {
+            if (bucket.start + bucketSeconds > cutoff) {
+                break;
+            }
+            if (!bucket.compacted) {
+                released += bucket.entries.size();
+                std::vector<TimelineEntry>().swap(bucket.entries);
+                bucket.compacted = true;
+            }
+        }
+        return released;
+    }
+
+    RideTotals totals() const { return bucketRange(0, buckets.size()); }
+
+    std::size_t bucketCount() const { return buckets.size(); }
+    std::int64_t getBucketSeconds() const { return bucketSeconds; }
+};
+
+#endif // RIDE_SHARING_RIDE_TIMELINE_H
@@ -0,0 +1,193 @@
+#ifndef RIDE_SHARING_RIDE_VALUE_H
+#define RIDE_SHARING_RIDE_VALUE_H
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <memory>
+#include <variant>
+#include <iomanip>
+#include <stdexcept>
+
+#include "ride.h"
+#include "location_table.h"
+#include "text_format.h"
+
+/**
+ * @brief Pricing policies for the closed set of ride types
+ * The rate is a compile-time constant shared with the virtual hierarchy
+ */
+struct StandardPricing {
+    static constexpr double ratePerMile = StandardRide::ratePerMile;
+    static constexpr RideType type = RideType::Standard;
+    static constexpr const char* label = "Standard Ride";
+};
+
+struct PremiumPricing {
+    static constexpr double ratePerMile = PremiumRide::ratePerMile;
+    static constexpr RideType type = RideType::Premium;
+    static constexpr const char* label = "Premium Ride";
+};
+
+struct PooledPricing {
+    static constexpr double ratePerMile = PooledRide::ratePerMile;
+    static constexpr RideType type = RideType::Pooled;
+    static constexpr const char* label = "Pooled Ride";
+};
+
+/**
+ * @brief RideT class - value-type ride specialized on its pricing policy
+ * Has no vtable, so rides can be stored by value and priced with direct, inlinable calls
+ */
+template <typename Policy>
+class RideT {
+private:
+    int rideID;
+    LocationID pickupLocation;   // interned in LocationTable::global()
+    LocationID dropoffLocation;
+    double distance;
+    double fare;
+
+public:
+    static constexpr double ratePerMile = Policy::ratePerMile;
+
+    // Same preconditions as the Ride constructors, NaN distances included
+    RideT(int id, std::string_view pickup, std::string_view dropoff, double dist)
+        : rideID(id), pickupLocation(LocationTable::global().intern(pickup)),
+          dropoffLocation(LocationTable::global().intern(dropoff)), distance(dist), fare(0.0) {
+        const ValidationError error = Ride::validate(dist);
+        if (error != ValidationError::None) {
+            throw std::invalid_argument(validationMessage(error));
+        }
+    }
+
+    RideT(int id, LocationID pickup, LocationID dropoff, double dist)
+        : rideID(id), pickupLocation(pickup), dropoffLocation(dropoff), distance(dist), fare(0.0) {
+        const ValidationError error = Ride::validate(pickup, dropoff, dist);
+        if (error != ValidationError::None) {
+            throw std::invalid_argument(validationMessage(error));
+        }
+    }
+
+    void calculateFare() {
+        fare = distance * Policy::ratePerMile;
+    }
+
+    static constexpr RideType getRideType() { return Policy::type; }
+
+    // Same output as the virtual rideDetails() of the matching Ride subclass
+    void rideDetails() const {
+        std::cout << "Ride ID: " << rideID
+                  << "\nPickup: " << getPickupLocation()
+                  << "\nDropoff: " << getDropoffLocation()
+                  << "\nDistance: " << distance << " miles"
+                  << "\nFare: $" << std::fixed << std::setprecision(2) << fare
+                  << " (" << Policy::label << ")" << std::endl;
+    }
+
+    void rideDetails(std::string& out) const {
+        appendRideDetails(out, rideID, getPickupLocation(), getDropoffLocation(), distance, fare);
+        out += " (";
+        out += Policy::label;
+        out += ")\n";
+    }
+
+    double getFare() const { return fare; }
+    void restoreFare(double storedFare) { fare = storedFare; }
+    int getRideID() const { return rideID; }
+    const std::string& getPickupLocation() const { return LocationTable::global().name(pickupLocation); }
+    const std::string& getDropoffLocation() const { return LocationTable::global().name(dropoffLocation); }
+    LocationID getPickupLocationID() const { return pickupLocation; }
+    LocationID getDropoffLocationID() const { return dropoffLocation; }
+    double getDistance() const { return distance; }
+};
+
+using StandardRideValue = RideT<StandardPricing>;
+using PremiumRideValue = RideT<PremiumPricing>;
+using PooledRideValue = RideT<PooledPricing>;
+
+/**
+ * @brief RideValue - closed sum of all ride types
+ * std::visit dispatches through a jump table instead of an indirect virtual call
+ */
+using RideValue = std::variant<StandardRideValue, PremiumRideValue, PooledRideValue>;
+
+inline void calculateFare(RideValue& ride) {
+    std::visit([](auto& r) { r.calculateFare(); }, ride);
+}
+
+inline void calculateFares(std::vector<RideValue>& rides) {
+    for (auto& ride : rides) {
+        calculateFare(ride);
+    }
+}
+
+inline void rideDetails(const RideValue& ride) {
+    std::visit([](const auto& r) { r.rideDetails(); }, ride);
+}
+
+inline void rideDetails(const RideValue& ride, std::string& out) {
+    std::visit([&out](const auto& r) { r.rideDetails(out); }, ride);
+}
+
+inline double getFare(const RideValue& ride) {
+    return std::visit([](const auto& r) { return r.getFare(); }, ride);
+}
+
+inline int getRideID(const RideValue& ride) {
+    return std::visit([](const auto& r) { return r.getRideID(); }, ride);
+}
+
+inline double getDistance(const RideValue& ride) {
+    return std::visit([](const auto& r) { return r.getDistance(); }, ride);
+}
+
+inline RideType getRideType(const RideValue& ride) {
+    return std::visit([](const auto& r) { return r.getRideType(); }, ride);
+}
+
+/**
+ * @brief Converts a virtual Ride into its value form, carrying the fare over unchanged
+ */
+inline RideValue toRideValue(const Ride& ride) {
+    auto convert = [&](auto value) -> RideValue {
+        value.restoreFare(ride.getFare());
+        return value;
+    };
+
+    switch (ride.getRideType()) {
+        case RideType::Standard:
+            return convert(StandardRideValue(ride.getRideID(), ride.getPickupLocationID(),
+                                             ride.getDropoffLocationID(), ride.getDistance()));
+        case RideType::Premium:
+            return convert(PremiumRideValue(ride.getRideID(), ride.getPickupLocationID(),
+                                            ride.getDropoffLocationID(), ride.getDistance()));
+        case RideType::Pooled:
+            return convert(PooledRideValue(ride.getRideID(), ride.getPickupLocationID(),
+                                           ride.getDropoffLocationID(), ride.getDistance()));
+    }
+    throw std::invalid_argument("Unknown ride type");
+}
+
+/**
+ * @brief Converts a value ride back into the virtual hierarchy, carrying the fare over unchanged
+ */
+inline std::unique_ptr<Ride> toRide(const RideValue& value) {
+    std::unique_ptr<Ride> ride = std::visit([](const auto& r) -> std::unique_ptr<Ride> {
+        if (r.getRideType() == RideType::Premium) {
+            return std::make_unique<PremiumRide>(r.getRideID(), r.getPickupLocationID(),
+                                                 r.getDropoffLocationID(), r.getDistance());
+        }
+        if (r.getRideType() == RideType::Pooled) {
+            return std::make_unique<PooledRide>(r.getRideID(), r.getPickupLocationID(),
+                                                r.getDropoffLocationID(), r.getDistance());
+        }
+        return std::make_unique<StandardRide>(r.getRideID(), r.getPickupLocationID(),
+                                              r.getDropoffLocationID(), r.getDistance());
+    }, value);
+
+    ride->restoreFare(getFare(value));
+    return ride;
+}
+
+#endif // RIDE_SHARING_RIDE_VALUE_H
@@ -0,0 +1,45 @@
+#ifndef RIDE_SHARING_RIDE_WRITER_H
+#define RIDE_SHARING_RIDE_WRITER_H
+
+#include <string>
+#include <vector>
+#include <ostream>
+#include <cstddef>
+
+#include "ride.h"
+#include "ride_registry.h"
+
+/**
+ * @brief Bulk ride serialization for export jobs and API responses
+ * Details are formatted into a reusable string and handed to the sink in large
+ * chunks; nothing is flushed, so a history of any size costs a handful of writes
+ */
+constexpr std::size_t rideWriterChunkSize = 64 * 1024;
+
+inline void writeRides(const RideRegistry& registry, const RideIndex* rides, std::size_t count,
+                       std::string& out) {
+    for (std::size_t i = 0; i < count; ++i) {
+        registry.get(rides[i]).rideDetails(out);
+    }
+}
+
+inline void writeRides(const RideRegistry& registry, const RideIndex* rides, std::size_t count,
+                       std::ostream& sink) {
+    std::string buffer;
+    buffer.reserve(rideWriterChunkSize + 512);
+    for (std::size_t i = 0; i < count; ++i) {
+        registry.get(rides[i]).rideDetails(buffer);
+        if (buffer.size() >= rideWriterChunkSize) {
+            sink.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+            buffer.clear();
+        }
+    }
+    sink.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+}
+
+template <typename Sink>
+void writeRides(const RideRegistry& registry, const std::vector<RideIndex>& rides, Sink& sink) {
+    writeRides(registry, rides.data(), rides.size(), sink);
+}
+
+#endif // RIDE_SHARING_RIDE_WRITER_H
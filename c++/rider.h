@@ -0,0 +1,139 @@
+#ifndef RIDE_SHARING_RIDER_H
+#define RIDE_SHARING_RIDER_H
+
+#include <iostream>
+#include <vector>
+#include <string>
+#include <utility>
+#include <stdexcept>
+
+#include "ride.h"
+#include "ride_registry.h"
+#include "text_format.h"
+#include "ride_stats.h"
+#include "ride_timeline.h"
+#include "validation.h"
+#include "metrics.h"
+
+class RideHistoryStore;
+
+/**
+ * @brief Rider class - demonstrates encapsulation
+ * Keeps rider details private and provides public methods for access
+ */
+class Rider {
+private:
+    int riderID;
+    std::string name;
+    const RideRegistry* rideTable;
+    std::vector<RideIndex> requestedRides;
+    RideStats stats;
+    RideTimeline timeline;
+
+public:
+    // name is taken by value so temporaries are moved in rather than copied
+    Rider(int id, std::string name, const RideRegistry& rides = RideRegistry::global())
+        : riderID(id), name(std::move(name)), rideTable(&rides), timeline(rides) {}
+
+    void requestRide(RideIndex ride) { requestRide(ride, currentTimestamp()); }
+
+    // Also reserves the timeline bucket of timestamp, so a batch recorded then does not allocate
+    void reserveRides(std::size_t count, std::int64_t timestamp = currentTimestamp()) {
+        requestedRides.reserve(requestedRides.size() + count);
+        timeline.reserve(count, timestamp);
+    }
+
+    // Same as requestRide, reporting an unknown index instead of throwing
+    ValidationError tryRequestRide(RideIndex ride, std::int64_t timestamp = currentTimestamp()) {
+        RIDE_METRICS_TIME(RequestRide);
+        if (!rideTable->contains(ride)) {
+            return ValidationError::InvalidRideIndex;
+        }
+        requestedRides.push_back(ride);
+        const Ride& recorded = rideTable->get(ride);
+        stats.record(recorded, timestamp);
+        timeline.record(timestamp, ride, recorded.getFare(), recorded.getDistance());
+        RIDE_METRICS_COUNT(RidesRequested, 1);
+        return ValidationError::None;
+    }
+
+    // timestamp (Unix seconds) places the ride in the rolling hour/day windows
+    void requestRide(RideIndex ride, std::int64_t timestamp) {
+        const ValidationError error = tryRequestRide(ride, timestamp);
+        if (error != ValidationError::None) {
+            throw std::invalid_argument(validationMessage(error));
+        }
+    }
+
+    /**
+     * @brief Builds a ride in place in registry, prices it and records the request
+     * registry must be the one this rider was created with
+     */
+    template <typename T, typename... Args>
+    RideIndex emplaceRide(RideRegistry& registry, Args&&... args) {
+        if (&registry != rideTable) {
+            throw std::invalid_argument("Ride registry does not belong to this rider");
+        }
+        const RideIndex ride = registry.create<T>(std::forward<Args>(args)...);
+        const std::int64_t now = currentTimestamp();
+        Ride& created = registry[ride];
+        created.calculateFare();
+        created.markRequested(now);
+        requestedRides.push_back(ride);
+        stats.record(created, now);
+        timeline.record(now, ride, created.getFare(), created.getDistance());
+        RIDE_METRICS_COUNT(RidesRequested, 1);
+        return ride;
+    }
+
+    void viewRides() const {
+        std::cout << "Rider ID: " << riderID
+                  << "\nName: " << name
+                  << "\nRequested Rides History:" << std::endl;
+        
+        if (requestedRides.empty()) {
+            std::cout << "No rides requested yet." << std::endl;
+            return;
+        }
+
+        for (RideIndex ride : requestedRides) {
+            rideTable->get(ride).rideDetails();
+        }
+    }
+
+    // Appends the same history to out; one allocation-amortized string instead of a flush per line
+    void viewRides(std::string& out) const {
+        out += "Rider ID: ";
+        appendInt(out, riderID);
+        out += "\nName: ";
+        out += name;
+        out += "\nRequested Rides History:\n";
+
+        if (requestedRides.empty()) {
+            out += "No rides requested yet.\n";
+            return;
+        }
+
+        for (RideIndex ride : requestedRides) {
+            rideTable->get(ride).rideDetails(out);
+        }
+    }
+
+    // Serve the history from a memory-mapped store; defined in ride_history_store.h
+    void viewRides(const RideHistoryStore& history) const;
+    void viewRides(const RideHistoryStore& history, std::string& out) const;
+
+    int getRiderID() const { return riderID; }
+    const std::string& getName() const { return name; }
+    const std::vector<RideIndex>& getRequestedRides() const { return requestedRides; }
+    const RideRegistry& getRideRegistry() const { return *rideTable; }
+    const RideStats& getStats() const { return stats; }
+
+    // Requested rides by time, for range queries such as the last 30 days
+    const RideTimeline& getTimeline() const { return timeline; }
+
+    // Drops per-ride timeline entries older than cutoff, keeping their bucket totals
+    std::size_t compactTimelineBefore(std::int64_t cutoff) { return timeline.compactBefore(cutoff); }
+};
+
+#endif // RIDE_SHARING_RIDER_H
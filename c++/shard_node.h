@@ -0,0 +1,484 @@
+#ifndef RIDE_SHARING_SHARD_NODE_H
+#define RIDE_SHARING_SHARD_NODE_H
+
+#include <deque>
+#include <vector>
+#include <string>
+#include <string_view>
+#include <functional>
+#include <unordered_map>
+#include <utility>
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+
+#include "ride.h"
+#include "ride_request.h"
+#include "ride_registry.h"
+#include "ride_stats.h"
+#include "driver_index.h"
+#include "participant_registry.h"
+#include "shard_ring.h"
+#include "shard_wire.h"
+
+/**
+ * @brief ShardTransport class - carries encoded shard_wire frames between nodes
+ * A deployment implements send() over its network; LoopbackTransport below
+ * connects nodes inside one process
+ */
+class ShardTransport {
+public:
+    virtual ~ShardTransport() = default;
+
+    // frames holds one or more whole frames for node to
+    virtual void send(NodeID from, NodeID to, const std::vector<unsigned char>& frames) = 0;
+};
+
+struct ShardStats {
+    std::uint64_t localRoutes;       // requests whose pickup region this node owns
+    std::uint64_t forwardedRoutes;   // requests sent to the owning node
+    std::uint64_t servedForOthers;   // requests received from other nodes
+    std::uint64_t driverQueries;     // neighbour nodes asked for a driver near a pickup
+    std::uint64_t delegatedRoutes;   // requests served by a neighbour's closer driver
+    std::uint64_t handoffsOut;
+    std::uint64_t handoffsIn;
+};
+
+/**
+ * @brief ShardNode class - one node's share of drivers, riders and rides
+ *
+ * The node owns the drivers whose positions fall in its ShardRing regions and
+ * matches every request whose pickup it owns. route() forwards other requests
+ * to the owner, whose reply returns through receive(). The owner asks every
+ * other node with ground within reach of the pickup for its nearest driver
+ * (DriverQuery/DriverOffer) and has the closest one serve the request, so a
+ * pickup near a region edge still finds the driver across it.
+ *
+ * A ride lives in the registry of the node that matched it, with the driver's
+ * and rider's history. When a driver moves into another node's region, the
+ * driver is handed off with a reference to the ride in progress, and
+ * completeRide() on the new owner reports the completion back to that home.
+ *
+ * Regions never migrate: the ring is fixed for the lifetime of the nodes, and
+ * a node throws if its ring's membership changes after it was created.
+ * A node is single-threaded: call it from the thread that owns its event loop.
+ */
+class ShardNode {
+public:
+    using RouteCallback = std::function<void(const shard_wire::RouteReplyMessage&)>;
+
+private:
+    struct ActiveRide {
+        NodeID home;
+        RideIndex ride;   // index in home's registry
+        int riderID;
+    };
+
+    // A pickup this node owns, waiting for DriverOffers from its neighbours
+    struct Search {
+        RideRequest request;
+        std::string riderName;
+        RouteCallback done;
+        std::size_t waiting;
+        bool found;
+        NodeID bestNode;
+        double bestKm;
+    };
+
+    NodeID nodeID;
+    const ShardRing& ring;
+    ShardTransport& transport;
+    double maxRadiusKm;
+    std::uint64_t ringVersion;
+    RideRegistry rides;
+    DriverRegistry drivers;
+    RiderRegistry riders;
+    DriverIndex index;
+    std::unordered_map<int, ActiveRide> activeRides;   // by driver ID
+    std::unordered_map<std::uint64_t, RouteCallback> pending;
+    std::unordered_map<std::uint64_t, Search> searches;
+    std::vector<unsigned char> outgoing;
+    ShardStats counters;
+
+    bool isLocal(int driverID) const {
+        GeoPoint position;
+        return index.getPosition(driverID, position);
+    }
+
+    Rider& riderFor(int riderID, std::string_view name) {
+        Rider* rider = riders.find(riderID);
+        return rider != nullptr ? *rider : riders.add(riderID, std::string(name));
+    }
+
+    RideIndex createRide(int rideID, RideType type, LocationID pickup, LocationID dropoff, double miles) {
+        switch (type) {
+            case RideType::Premium:
+                return rides.create<PremiumRide>(rideID, pickup, dropoff, miles);
+            case RideType::Pooled:
+                return rides.create<PooledRide>(rideID, pickup, dropoff, miles);
+            default:
+                return rides.create<StandardRide>(rideID, pickup, dropoff, miles);
+        }
+    }
+
+    void checkRing() const {
+        if (ring.getVersion() != ringVersion) {
+            throw std::logic_error("Shard ring changed under a running node; regions do not migrate");
+        }
+    }
+
+    void sendOutgoing(NodeID to) {
+        transport.send(nodeID, to, outgoing);
+        outgoing.clear();
+    }
+
+    void handOff(int driverID, const GeoPoint& position, NodeID owner) {
+        const Driver& driver = drivers.get(driverID);
+        shard_wire::DriverHandoffMessage handoff{};
+        handoff.driverID = driverID;
+        handoff.name = driver.getName();
+        handoff.rating = driver.getRating();
+        handoff.position = position;
+        handoff.available = drivers.status(driverID)->available;
+        const auto active = activeRides.find(driverID);
+        if (active != activeRides.end()) {
+            handoff.hasRide = true;
+            handoff.riderID = active->second.riderID;
+            handoff.homeNode = active->second.home;
+            handoff.homeRide = active->second.ride;
+            activeRides.erase(active);
+        }
+        shard_wire::encodeDriverHandoff(outgoing, handoff);
+        index.remove(driverID);
+        // The Driver object stays behind with its history and is reused if the driver returns
+        drivers.setAvailable(driverID, false);
+        drivers.updatePosition(driverID, position);
+        ++counters.handoffsOut;
+        sendOutgoing(owner);
+    }
+
+    void adopt(const shard_wire::DriverHandoffMessage& handoff) {
+        if (drivers.find(handoff.driverID) == nullptr) {
+            drivers.add(handoff.driverID, handoff.name, handoff.rating, handoff.position, handoff.available);
+        } else {
+            drivers.updatePosition(handoff.driverID, handoff.position);
+            drivers.setAvailable(handoff.driverID, handoff.available);
+        }
+        index.updatePosition(handoff.driverID, handoff.rating, handoff.position);
+        index.setAvailable(handoff.driverID, handoff.available);
+        if (handoff.hasRide) {
+            activeRides[handoff.driverID] = ActiveRide{ handoff.homeNode, handoff.homeRide, handoff.riderID };
+        }
+        ++counters.handoffsIn;
+    }
+
+    /**
+     * Matches a request whose pickup this node owns. Other nodes owning ground
+     * closer to the pickup than the best local driver are asked for their
+     * nearest driver first; done runs once the closest one has served it
+     */
+    void match(const RideRequest& request, std::string_view riderName, RouteCallback done) {
+        const std::vector<DriverMatch> local = index.nearestAvailable(request.pickupPosition, 1, maxRadiusKm);
+        const double reachKm = local.empty() ? maxRadiusKm : local.front().distanceKm;
+        std::vector<NodeID> neighbours = ring.nodesWithin(request.pickupPosition, reachKm);
+        neighbours.erase(std::remove(neighbours.begin(), neighbours.end(), nodeID), neighbours.end());
+        if (neighbours.empty()) {
+            done(serve(request, riderName));
+            return;
+        }
+        Search search{ request, std::string(riderName), std::move(done), neighbours.size(), !local.empty(), nodeID,
+                       reachKm };
+        if (!searches.emplace(request.requestID, std::move(search)).second) {
+            throw std::invalid_argument("Request ID is already in flight");
+        }
+        const shard_wire::DriverQueryMessage query{ nodeID, request.requestID, request.pickupPosition, reachKm };
+        for (NodeID neighbour : neighbours) {
+            shard_wire::encodeDriverQuery(outgoing, query);
+            ++counters.driverQueries;
+            sendOutgoing(neighbour);
+        }
+    }
+
+    void offered(const shard_wire::DriverOfferMessage& offer) {
+        const auto found = searches.find(offer.requestID);
+        if (found == searches.end()) {
+            return;
+        }
+        Search& search = found->second;
+        if (offer.found && (!search.found || offer.distanceKm < search.bestKm)) {
+            search.found = true;
+            search.bestNode = offer.from;
+            search.bestKm = offer.distanceKm;
+        }
+        if (--search.waiting > 0) {
+            return;
+        }
+        Search finished = std::move(search);
+        searches.erase(found);
+        if (!finished.found || finished.bestNode == nodeID) {
+            finished.done(serve(finished.request, finished.riderName));
+            return;
+        }
+        // The neighbour's driver may be taken by the time it serves; fall back to ours
+        const RideRequest request = finished.request;
+        const std::string riderName = finished.riderName;
+        RouteCallback done = std::move(finished.done);
+        pending.emplace(request.requestID,
+                        [this, request, riderName, done](const shard_wire::RouteReplyMessage& reply) {
+                            done(reply.status == shard_wire::RouteStatus::NoDriver ? serve(request, riderName) : reply);
+                        });
+        shard_wire::encodeRouteRequest(outgoing, nodeID, request, riderName);
+        ++counters.delegatedRoutes;
+        sendOutgoing(finished.bestNode);
+    }
+
+    void routeRequested(const shard_wire::RouteRequestMessage& message) {
+        ++counters.servedForOthers;
+        const NodeID origin = message.origin;
+        auto reply = [this, origin](const shard_wire::RouteReplyMessage& result) {
+            shard_wire::encodeRouteReply(outgoing, result);
+            sendOutgoing(origin);
+        };
+        if (owns(message.request.pickupPosition)) {
+            match(message.request, message.riderName, reply);
+        } else {
+            // Delegated by the pickup's owner because our driver is closest
+            reply(serve(message.request, message.riderName));
+        }
+    }
+
+public:
+    ShardNode(NodeID id, const ShardRing& ring, ShardTransport& transport, double maxRadiusKm = 10.0)
+        : nodeID(id), ring(ring), transport(transport), maxRadiusKm(maxRadiusKm), ringVersion(ring.getVersion()),
+          rides(), drivers(rides),
+          riders(rides), counters{} {
+        if (!ring.contains(id)) {
+            throw std::invalid_argument("Node is not on the shard ring");
+        }
+    }
+
+    ShardNode(const ShardNode&) = delete;
+    ShardNode& operator=(const ShardNode&) = delete;
+
+    bool owns(const GeoPoint& position) const { return ring.nodeFor(position) == nodeID; }
+
+    // Registers a driver here; position must be in one of this node's regions
+    Driver& addDriver(int driverID, std::string name, double rating, const GeoPoint& position) {
+        if (!owns(position)) {
+            throw std::invalid_argument("Driver position belongs to another node");
+        }
+        Driver& driver = drivers.add(driverID, std::move(name), rating, position);
+        index.updatePosition(driverID, rating, position);
+        return driver;
+    }
+
+    /**
+     * @brief Matches request to this node's nearest driver only
+     * Marks the driver busy until completeRide(); NoDriver when nobody is in range
+     */
+    shard_wire::RouteReplyMessage serve(const RideRequest& request, std::string_view riderName) {
+        shard_wire::RouteReplyMessage reply{ request.requestID, shard_wire::RouteStatus::NoDriver, nodeID, -1, 0.0 };
+        if (Ride::validate(request.pickupLocation, request.dropoffLocation, request.distance) != ValidationError::None) {
+            reply.status = shard_wire::RouteStatus::Rejected;
+            return reply;
+        }
+        const std::vector<DriverMatch> matches = index.nearestAvailable(request.pickupPosition, 1, maxRadiusKm);
+        if (matches.empty()) {
+            return reply;
+        }
+        const int driverID = matches.front().driverID;
+        Rider& rider = riderFor(request.riderID, riderName);
+        const RideIndex ride = createRide(static_cast<int>(request.requestID), request.type,
+                                          request.pickupLocation, request.dropoffLocation, request.distance);
+        rides[ride].calculateFare();
+        rides[ride].markRequested(currentTimestamp());
+        drivers.get(driverID).addRide(ride);
+        rider.requestRide(ride);
+        index.setAvailable(driverID, false);
+        drivers.setAvailable(driverID, false);
+        activeRides[driverID] = ActiveRide{ nodeID, ride, request.riderID };
+        reply.status = shard_wire::RouteStatus::Confirmed;
+        reply.driverID = driverID;
+        reply.fare = rides[ride].getFare();
+        return reply;
+    }
+
+    /**
+     * @brief Sends request to the node owning its pickup region
+     * done runs inside route() when this node owns the pickup and no other node
+     * owns ground within reach, otherwise from the receive() call that
+     * delivers the last reply
+     */
+    void route(const RideRequest& request, std::string_view riderName, RouteCallback done) {
+        checkRing();
+        const NodeID owner = ring.nodeFor(request.pickupPosition);
+        if (owner == nodeID) {
+            ++counters.localRoutes;
+            match(request, riderName, std::move(done));
+            return;
+        }
+        if (!pending.emplace(request.requestID, std::move(done)).second) {
+            throw std::invalid_argument("Request ID is already in flight");
+        }
+        shard_wire::encodeRouteRequest(outgoing, nodeID, request, riderName);
+        ++counters.forwardedRoutes;
+        sendOutgoing(owner);
+    }
+
+    // Moves a local driver, handing it off once it crosses into another node's region
+    void updateDriverPosition(int driverID, const GeoPoint& position) {
+        checkRing();
+        if (!isLocal(driverID)) {
+            throw std::invalid_argument("Driver is not on this node");
+        }
+        const NodeID owner = ring.nodeFor(position);
+        if (owner != nodeID) {
+            handOff(driverID, position, owner);
+            return;
+        }
+        index.updatePosition(driverID, drivers.get(driverID).getRating(), position);
+        drivers.updatePosition(driverID, position);
+    }
+
+    // Ends the driver's ride in progress, on its home node, and makes them available again
+    void completeRide(int driverID) {
+        const auto active = activeRides.find(driverID);
+        if (active == activeRides.end()) {
+            throw std::invalid_argument("Driver has no ride in progress on this node");
+        }
+        if (active->second.home == nodeID) {
+            rides[active->second.ride].markCompleted(currentTimestamp());
+        } else {
+            shard_wire::encodeRideCompleted(outgoing, shard_wire::RideCompletedMessage{ active->second.ride, currentTimestamp() });
+            sendOutgoing(active->second.home);
+        }
+        activeRides.erase(active);
+        index.setAvailable(driverID, true);
+        drivers.setAvailable(driverID, true);
+    }
+
+    /**
+     * @brief Handles whole frames received from other nodes; returns how many
+     * Replies and offers for unknown request IDs are ignored; malformed data throws
+     */
+    std::size_t receive(const unsigned char* data, std::size_t size) {
+        checkRing();
+        std::size_t handled = 0;
+        while (size > 0) {
+            shard_wire::FrameView frame;
+            std::size_t consumed = 0;
+            if (!shard_wire::nextFrame(data, size, frame, consumed)) {
+                throw std::runtime_error("Truncated shard message");
+            }
+            switch (frame.kind) {
+                case shard_wire::MessageKind::RouteRequest:
+                    routeRequested(shard_wire::decodeRouteRequest(frame));
+                    break;
+                case shard_wire::MessageKind::RouteReply: {
+                    const shard_wire::RouteReplyMessage reply = shard_wire::decodeRouteReply(frame);
+                    const auto waiting = pending.find(reply.requestID);
+                    if (waiting != pending.end()) {
+                        RouteCallback done = std::move(waiting->second);
+                        pending.erase(waiting);
+                        done(reply);
+                    }
+                    break;
+                }
+                case shard_wire::MessageKind::DriverHandoff:
+                    adopt(shard_wire::decodeDriverHandoff(frame));
+                    break;
+                case shard_wire::MessageKind::DriverQuery: {
+                    const shard_wire::DriverQueryMessage query = shard_wire::decodeDriverQuery(frame);
+                    shard_wire::DriverOfferMessage offer{ query.requestID, nodeID, false, -1, 0.0 };
+                    const std::vector<DriverMatch> nearest = index.nearestAvailable(query.pickup, 1, query.radiusKm);
+                    if (!nearest.empty()) {
+                        offer.found = true;
+                        offer.driverID = nearest.front().driverID;
+                        offer.distanceKm = nearest.front().distanceKm;
+                    }
+                    shard_wire::encodeDriverOffer(outgoing, offer);
+                    sendOutgoing(query.origin);
+                    break;
+                }
+                case shard_wire::MessageKind::DriverOffer:
+                    offered(shard_wire::decodeDriverOffer(frame));
+                    break;
+                case shard_wire::MessageKind::RideCompleted: {
+                    const shard_wire::RideCompletedMessage completed = shard_wire::decodeRideCompleted(frame);
+                    if (!rides.contains(completed.ride)) {
+                        throw std::runtime_error("Completed ride is not on this node");
+                    }
+                    rides[completed.ride].markCompleted(completed.completedAt);
+                    break;
+                }
+                default:
+                    throw std::runtime_error("Unknown shard message kind");
+            }
+            data += consumed;
+            size -= consumed;
+            ++handled;
+        }
+        return handled;
+    }
+
+    bool hasRideInProgress(int driverID) const { return activeRides.count(driverID) != 0; }
+    bool hasDriver(int driverID) const { return isLocal(driverID); }
+
+    NodeID getNodeID() const { return nodeID; }
+    const RideRegistry& getRideRegistry() const { return rides; }
+    const DriverRegistry& getDrivers() const { return drivers; }
+    const RiderRegistry& getRiders() const { return riders; }
+    const DriverIndex& getDriverIndex() const { return index; }
+    const ShardStats& stats() const { return counters; }
+    std::size_t pendingRoutes() const { return pending.size() + searches.size(); }
+};
+
+/**
+ * @brief LoopbackTransport class - queues frames between nodes in one process
+ * pump() delivers them in send order, including replies sent while pumping
+ */
+class LoopbackTransport : public ShardTransport {
+private:
+    struct Message {
+        NodeID to;
+        std::vector<unsigned char> frames;
+    };
+
+    std::unordered_map<NodeID, ShardNode*> nodes;
+    std::deque<Message> queue;
+    std::uint64_t bytes;
+
+public:
+    LoopbackTransport() : bytes(0) {}
+
+    void attach(ShardNode& node) {
+        if (!nodes.emplace(node.getNodeID(), &node).second) {
+            throw std::invalid_argument("Node is already attached");
+        }
+    }
+
+    void send(NodeID, NodeID to, const std::vector<unsigned char>& frames) override {
+        if (nodes.count(to) == 0) {
+            throw std::invalid_argument("Unknown destination node");
+        }
+        bytes += frames.size();
+        queue.push_back(Message{ to, frames });
+    }
+
+    // Returns the number of frames delivered
+    std::size_t pump() {
+        std::size_t delivered = 0;
+        while (!queue.empty()) {
+            Message message = std::move(queue.front());
+            queue.pop_front();
+            delivered += nodes[message.to]->receive(message.frames.data(), message.frames.size());
+        }
+        return delivered;
+    }
+
+    std::uint64_t bytesSent() const { return bytes; }
+    std::size_t queued() const { return queue.size(); }
+};
+
+#endif // RIDE_SHARING_SHARD_NODE_H
@@ -0,0 +1,149 @@
+#ifndef RIDE_SHARING_SHARD_RING_H
+#define RIDE_SHARING_SHARD_RING_H
+
+#include <vector>
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+
+#include "geo.h"
+
+using NodeID = std::uint32_t;
+
+/**
+ * @brief ShardRing class - consistent hashing of geographic regions onto nodes
+ *
+ * The map is cut into regionDegrees x regionDegrees regions (about 5.5 km at the
+ * default), much coarser than DriverIndex cells. Neighbouring regions hash to
+ * unrelated nodes, so a search near a region edge asks nodesWithin() which
+ * other nodes own ground in range. Each node owns replicas points on a 64-bit
+ * ring and a region belongs to the first point at or after its hash; adding or
+ * removing a node therefore moves only the regions next to its points, about
+ * 1/nodes of the map. getVersion() changes with every membership change.
+ */
+class ShardRing {
+public:
+    static constexpr double defaultRegionDegrees = 0.05;
+    static constexpr std::size_t defaultReplicas = 64;
+
+private:
+    struct Point {
+        std::uint64_t hash;
+        NodeID node;
+
+        bool operator<(const Point& other) const {
+            return hash != other.hash ? hash < other.hash : node < other.node;
+        }
+    };
+
+    double regionDegrees;
+    std::size_t replicas;
+    std::vector<Point> points;   // sorted by hash
+    std::vector<NodeID> members;
+    std::uint64_t version = 0;
+
+    static std::uint64_t regionKey(std::int32_t lat, std::int32_t lon) {
+        return (static_cast<std::uint64_t>(static_cast<std::uint32_t>(lat)) << 32) | static_cast<std::uint32_t>(lon);
+    }
+
+    std::int32_t gridIndex(double degrees) const { return static_cast<std::int32_t>(std::floor(degrees / regionDegrees)); }
+
+    static std::uint64_t mix(std::uint64_t x) {
+        // splitmix64 finalizer: every input bit affects every output bit
+        x += 0x9E3779B97F4A7C15ull;
+        x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ull;
+        x = (x ^ (x >> 27)) * 0x94D049BB133111EBull;
+        return x ^ (x >> 31);
+    }
+
+public:
+    explicit ShardRing(double regionDegrees = defaultRegionDegrees, std::size_t replicas = defaultReplicas)
+        : regionDegrees(regionDegrees), replicas(replicas) {
+        if (!(regionDegrees > 0)) {
+            throw std::invalid_argument("Region size must be greater than 0");
+        }
+        if (replicas == 0) {
+            throw std::invalid_argument("Replica count must be greater than 0");
+        }
+    }
+
+    // weight scales the node's share of regions, e.g. 2 for a box with twice the cores
+    void addNode(NodeID node, std::size_t weight = 1) {
+        if (weight == 0) {
+            throw std::invalid_argument("Node weight must be greater than 0");
+        }
+        if (contains(node)) {
+            throw std::invalid_argument("Node is already on the ring");
+        }
+        members.push_back(node);
+        for (std::size_t i = 0; i < replicas * weight; ++i) {
+            points.push_back(Point{ mix((static_cast<std::uint64_t>(node) << 32) ^ i), node });
+        }
+        std::sort(points.begin(), points.end());
+        ++version;
+    }
+
+    void removeNode(NodeID node) {
+        const auto member = std::find(members.begin(), members.end(), node);
+        if (member == members.end()) {
+            throw std::invalid_argument("Node is not on the ring");
+        }
+        members.erase(member);
+        points.erase(std::remove_if(points.begin(), points.end(),
+                                    [node](const Point& point) { return point.node == node; }),
+                     points.end());
+        ++version;
+    }
+
+    bool contains(NodeID node) const {
+        return std::find(members.begin(), members.end(), node) != members.end();
+    }
+
+    // Packs the region's grid coordinates into one key
+    std::uint64_t regionOf(const GeoPoint& p) const { return regionKey(gridIndex(p.lat), gridIndex(p.lon)); }
+
+    NodeID nodeForRegion(std::uint64_t region) const {
+        if (points.empty()) {
+            throw std::logic_error("Shard ring has no nodes");
+        }
+        const std::uint64_t hash = mix(region);
+        auto owner = std::lower_bound(points.begin(), points.end(), Point{ hash, 0 });
+        if (owner == points.end()) {
+            owner = points.begin();   // wrap around the ring
+        }
+        return owner->node;
+    }
+
+    NodeID nodeFor(const GeoPoint& p) const { return nodeForRegion(regionOf(p)); }
+
+    // Distinct owners of every region with ground within radiusKm of p, p's own owner included
+    std::vector<NodeID> nodesWithin(const GeoPoint& p, double radiusKm) const {
+        std::vector<NodeID> owners;
+        const double latSpan = radiusKm / kmPerDegree;
+        const double lonSpan = radiusKm / (kmPerDegree * std::max(1e-6, std::cos(degreesToRadians(p.lat))));
+        for (std::int32_t lat = gridIndex(p.lat - latSpan); lat <= gridIndex(p.lat + latSpan); ++lat) {
+            for (std::int32_t lon = gridIndex(p.lon - lonSpan); lon <= gridIndex(p.lon + lonSpan); ++lon) {
+                // Nearest point of the region to p
+                const GeoPoint nearest{ std::clamp(p.lat, lat * regionDegrees, (lat + 1) * regionDegrees),
+                                        std::clamp(p.lon, lon * regionDegrees, (lon + 1) * regionDegrees) };
+                if (distanceKm(p, nearest) > radiusKm) {
+                    continue;
+                }
+                const NodeID owner = nodeForRegion(regionKey(lat, lon));
+                if (std::find(owners.begin(), owners.end(), owner) == owners.end()) {
+                    owners.push_back(owner);
+                }
+            }
+        }
+        return owners;
+    }
+
+    double getRegionDegrees() const { return regionDegrees; }
+    const std::vector<NodeID>& nodes() const { return members; }
+    std::size_t size() const { return members.size(); }
+    std::uint64_t getVersion() const { return version; }
+};
+
+#endif // RIDE_SHARING_SHARD_RING_H
@@ -0,0 +1,383 @@
+#ifndef RIDE_SHARING_SHARD_WIRE_H
+#define RIDE_SHARING_SHARD_WIRE_H
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+
+#include "ride_binary.h"
+#include "ride_registry.h"
+#include "ride_request.h"
+#include "location_table.h"
+#include "shard_ring.h"
+#include "crc32.h"
+
+/**
+ * @brief Framed little-endian messages between shard nodes
+ *
+ * Frame: uint32 body length, uint8 kind, uint8 version, uint16 zero, uint32 CRC-32
+ * of the body, then the body. Location IDs are local to each process, so
+ * messages carry location names and the receiver interns them. A ride stays in
+ * the registry of the node that matched it; a handed-off driver carries only
+ * that home node and its RideIndex there, and RideCompleted reports the end of
+ * the ride back to it.
+ */
+namespace shard_wire {
+
+constexpr std::uint8_t version = 2;
+constexpr std::size_t frameHeaderSize = 12;
+constexpr std::size_t maxBodySize = 1 << 20;
+
+enum class MessageKind : std::uint8_t {
+    RouteRequest = 1,
+    RouteReply = 2,
+    DriverHandoff = 3,
+    DriverQuery = 4,
+    DriverOffer = 5,
+    RideCompleted = 6
+};
+
+enum class RouteStatus : std::uint8_t {
+    Confirmed = 0,
+    NoDriver = 1,
+    Rejected = 2      // malformed request or unknown participant
+};
+
+// request.pickupLocation/dropoffLocation are the receiver's interned IDs after decoding
+struct RouteRequestMessage {
+    NodeID origin;
+    RideRequest request;
+    std::string riderName;
+};
+
+struct RouteReplyMessage {
+    std::uint64_t requestID;
+    RouteStatus status;
+    NodeID servedBy;
+    int driverID;
+    double fare;
+};
+
+// A driver moving into another node's region, with the ride in progress if any
+struct DriverHandoffMessage {
+    int driverID;
+    std::string name;
+    double rating;
+    GeoPoint position;
+    bool available;
+    bool hasRide;
+    int riderID;
+    NodeID homeNode;      // node whose registry holds the ride
+    RideIndex homeRide;   // the ride's index on homeNode
+};
+
+// Asks another node for its nearest available driver within radiusKm of pickup
+struct DriverQueryMessage {
+    NodeID origin;
+    std::uint64_t requestID;
+    GeoPoint pickup;
+    double radiusKm;
+};
+
+struct DriverOfferMessage {
+    std::uint64_t requestID;
+    NodeID from;
+    bool found;
+    int driverID;
+    double distanceKm;
+};
+
+// Sent to a ride's home node when a handed-off driver finishes it
+struct RideCompletedMessage {
+    RideIndex ride;
+    std::int64_t completedAt;
+};
+
+struct FrameView {
+    MessageKind kind;
+    const unsigned char* body;
+    std::size_t size;
+};
+
+namespace detail {
+
+using ride_binary::detail::storeLE;
+using ride_binary::detail::loadLE;
+
+// Appends to out; frames are patched with length and CRC once the body is done
+class BodyWriter {
+private:
+    std::vector<unsigned char>& out;
+    std::size_t frameStart;
+
+    unsigned char* grow(std::size_t size) {
+        const std::size_t at = out.size();
+        out.resize(at + size);
+        return out.data() + at;
+    }
+
+public:
+    BodyWriter(std::vector<unsigned char>& out, MessageKind kind) : out(out), frameStart(out.size()) {
+        unsigned char* header = grow(frameHeaderSize);
+        header[4] = static_cast<unsigned char>(kind);
+        header[5] = version;
+        header[6] = header[7] = 0;
+    }
+
+    template <typename T>
+    void put(T value) { storeLE<T>(grow(sizeof(T)), value); }
+
+    void putByte(std::uint8_t value) { *grow(1) = value; }
+
+    void putName(std::string_view name) {
+        if (name.size() > 0xFFFF) {
+            throw std::length_error("Name is too long for a shard message");
+        }
+        put<std::uint16_t>(static_cast<std::uint16_t>(name.size()));
+        if (!name.empty()) {
+            std::memcpy(grow(name.size()), name.data(), name.size());
+        }
+    }
+
+    void finish() {
+        const std::size_t bodySize = out.size() - frameStart - frameHeaderSize;
+        unsigned char* header = out.data() + frameStart;
+        storeLE<std::uint32_t>(header, static_cast<std::uint32_t>(bodySize));
+        storeLE<std::uint32_t>(header + 8, crc32(header + frameHeaderSize, bodySize));
+    }
+};
+
+class BodyReader {
+private:
+    const unsigned char* at;
+    const unsigned char* end;
+
+    const unsigned char* take(std::size_t size) {
+        if (static_cast<std::size_t>(end - at) < size) {
+            throw std::runtime_error("Truncated shard message");
+        }
+        const unsigned char* bytes = at;
+        at += size;
+        return bytes;
+    }
+
+public:
+    explicit BodyReader(const FrameView& frame) : at(frame.body), end(frame.body + frame.size) {}
+
+    template <typename T>
+    T get() { return loadLE<T>(take(sizeof(T))); }
+
+    std::uint8_t getByte() { return *take(1); }
+
+    std::string_view getName() {
+        const std::uint16_t length = get<std::uint16_t>();
+        return std::string_view(reinterpret_cast<const char*>(take(length)), length);
+    }
+
+    void expectEnd() const {
+        if (at != end) {
+            throw std::runtime_error("Trailing bytes in shard message");
+        }
+    }
+};
+
+inline RideType checkedType(std::uint8_t raw) {
+    const RideType type = static_cast<RideType>(raw);
+    if (!isValidRideType(type)) {
+        throw std::runtime_error("Unknown ride type in shard message");
+    }
+    return type;
+}
+
+} // namespace detail
+
+/**
+ * @brief Splits the next frame off a byte stream
+ * Returns false when data holds less than one whole frame; throws on a bad
+ * version, oversized body or checksum mismatch
+ */
+inline bool nextFrame(const unsigned char* data, std::size_t size, FrameView& frame, std::size_t& consumed) {
+    if (size < frameHeaderSize) {
+        return false;
+    }
+    const std::uint32_t bodySize = detail::loadLE<std::uint32_t>(data);
+    if (bodySize > maxBodySize) {
+        throw std::runtime_error("Shard message is too large");
+    }
+    if (data[5] != version) {
+        throw std::runtime_error("Unsupported shard message version");
+    }
+    if (size - frameHeaderSize < bodySize) {
+        return false;
+    }
+    const unsigned char* body = data + frameHeaderSize;
+    if (crc32(body, bodySize) != detail::loadLE<std::uint32_t>(data + 8)) {
+        throw std::runtime_error("Shard message checksum mismatch");
+    }
+    frame = FrameView{ static_cast<MessageKind>(data[4]), body, bodySize };
+    consumed = frameHeaderSize + bodySize;
+    return true;
+}
+
+inline void encodeRouteRequest(std::vector<unsigned char>& out, NodeID origin, const RideRequest& request,
+                               std::string_view riderName, const LocationTable& locations = LocationTable::global()) {
+    detail::BodyWriter body(out, MessageKind::RouteRequest);
+    body.put<std::uint32_t>(origin);
+    body.put<std::uint64_t>(request.requestID);
+    body.put<std::int32_t>(request.riderID);
+    body.putByte(static_cast<std::uint8_t>(request.type));
+    body.put<double>(request.pickupPosition.lat);
+    body.put<double>(request.pickupPosition.lon);
+    body.put<double>(request.distance);
+    body.putName(riderName);
+    body.putName(locations.name(request.pickupLocation));
+    body.putName(locations.name(request.dropoffLocation));
+    body.finish();
+}
+
+inline RouteRequestMessage decodeRouteRequest(const FrameView& frame, LocationTable& locations = LocationTable::global()) {
+    detail::BodyReader body(frame);
+    RouteRequestMessage message{};
+    message.origin = body.get<std::uint32_t>();
+    message.request.requestID = body.get<std::uint64_t>();
+    message.request.riderID = body.get<std::int32_t>();
+    message.request.type = detail::checkedType(body.getByte());
+    message.request.pickupPosition.lat = body.get<double>();
+    message.request.pickupPosition.lon = body.get<double>();
+    message.request.distance = body.get<double>();
+    message.riderName = std::string(body.getName());
+    message.request.pickupLocation = locations.intern(body.getName());
+    message.request.dropoffLocation = locations.intern(body.getName());
+    body.expectEnd();
+    return message;
+}
+
+inline void encodeRouteReply(std::vector<unsigned char>& out, const RouteReplyMessage& reply) {
+    detail::BodyWriter body(out, MessageKind::RouteReply);
+    body.put<std::uint64_t>(reply.requestID);
+    body.putByte(static_cast<std::uint8_t>(reply.status));
+    body.put<std::uint32_t>(reply.servedBy);
+    body.put<std::int32_t>(reply.driverID);
+    body.put<double>(reply.fare);
+    body.finish();
+}
+
+inline RouteReplyMessage decodeRouteReply(const FrameView& frame) {
+    detail::BodyReader body(frame);
+    RouteReplyMessage reply{};
+    reply.requestID = body.get<std::uint64_t>();
+    const std::uint8_t status = body.getByte();
+    if (status > static_cast<std::uint8_t>(RouteStatus::Rejected)) {
+        throw std::runtime_error("Unknown route status in shard message");
+    }
+    reply.status = static_cast<RouteStatus>(status);
+    reply.servedBy = body.get<std::uint32_t>();
+    reply.driverID = body.get<std::int32_t>();
+    reply.fare = body.get<double>();
+    body.expectEnd();
+    return reply;
+}
+
+inline void encodeDriverHandoff(std::vector<unsigned char>& out, const DriverHandoffMessage& handoff) {
+    detail::BodyWriter body(out, MessageKind::DriverHandoff);
+    body.put<std::int32_t>(handoff.driverID);
+    body.put<double>(handoff.rating);
+    body.put<double>(handoff.position.lat);
+    body.put<double>(handoff.position.lon);
+    body.putByte(handoff.available ? 1 : 0);
+    body.putByte(handoff.hasRide ? 1 : 0);
+    body.putName(handoff.name);
+    if (handoff.hasRide) {
+        body.put<std::int32_t>(handoff.riderID);
+        body.put<std::uint32_t>(handoff.homeNode);
+        body.put<std::uint32_t>(handoff.homeRide);
+    }
+    body.finish();
+}
+
+inline DriverHandoffMessage decodeDriverHandoff(const FrameView& frame) {
+    detail::BodyReader body(frame);
+    DriverHandoffMessage handoff{};
+    handoff.driverID = body.get<std::int32_t>();
+    handoff.rating = body.get<double>();
+    handoff.position.lat = body.get<double>();
+    handoff.position.lon = body.get<double>();
+    handoff.available = body.getByte() != 0;
+    handoff.hasRide = body.getByte() != 0;
+    handoff.name = std::string(body.getName());
+    if (handoff.hasRide) {
+        handoff.riderID = body.get<std::int32_t>();
+        handoff.homeNode = body.get<std::uint32_t>();
+        handoff.homeRide = body.get<std::uint32_t>();
+    }
+    body.expectEnd();
+    return handoff;
+}
+
+inline void encodeDriverQuery(std::vector<unsigned char>& out, const DriverQueryMessage& query) {
+    detail::BodyWriter body(out, MessageKind::DriverQuery);
+    body.put<std::uint32_t>(query.origin);
+    body.put<std::uint64_t>(query.requestID);
+    body.put<double>(query.pickup.lat);
+    body.put<double>(query.pickup.lon);
+    body.put<double>(query.radiusKm);
+    body.finish();
+}
+
+inline DriverQueryMessage decodeDriverQuery(const FrameView& frame) {
+    detail::BodyReader body(frame);
+    DriverQueryMessage query{};
+    query.origin = body.get<std::uint32_t>();
+    query.requestID = body.get<std::uint64_t>();
+    query.pickup.lat = body.get<double>();
+    query.pickup.lon = body.get<double>();
+    query.radiusKm = body.get<double>();
+    body.expectEnd();
+    return query;
+}
+
+inline void encodeDriverOffer(std::vector<unsigned char>& out, const DriverOfferMessage& offer) {
+    detail::BodyWriter body(out, MessageKind::DriverOffer);
+    body.put<std::uint64_t>(offer.requestID);
+    body.put<std::uint32_t>(offer.from);
+    body.putByte(offer.found ? 1 : 0);
+    body.put<std::int32_t>(offer.driverID);
+    body.put<double>(offer.distanceKm);
+    body.finish();
+}
+
+inline DriverOfferMessage decodeDriverOffer(const FrameView& frame) {
+    detail::BodyReader body(frame);
+    DriverOfferMessage offer{};
+    offer.requestID = body.get<std::uint64_t>();
+    offer.from = body.get<std::uint32_t>();
+    offer.found = body.getByte() != 0;
+    offer.driverID = body.get<std::int32_t>();
+    offer.distanceKm = body.get<double>();
+    body.expectEnd();
+    return offer;
+}
+
+inline void encodeRideCompleted(std::vector<unsigned char>& out, const RideCompletedMessage& completed) {
+    detail::BodyWriter body(out, MessageKind::RideCompleted);
+    body.put<std::uint32_t>(completed.ride);
+    body.put<std::int64_t>(completed.completedAt);
+    body.finish();
+}
+
+inline RideCompletedMessage decodeRideCompleted(const FrameView& frame) {
+    detail::BodyReader body(frame);
+    RideCompletedMessage completed{};
+    completed.ride = body.get<std::uint32_t>();
+    completed.completedAt = body.get<std::int64_t>();
+    body.expectEnd();
+    return completed;
+}
+
+} // namespace shard_wire
+
+#endif // RIDE_SHARING_SHARD_WIRE_H
@@ -0,0 +1,180 @@
+#ifndef RIDE_SHARING_SURGE_PRICING_H
+#define RIDE_SHARING_SURGE_PRICING_H
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+
+#include "cache_line.h"
+#include "location_table.h"
+#include "ride.h"
+#include "ride_stats.h"
+
+using ZoneID = std::uint32_t;
+
+/**
+ * @brief SurgePolicy struct - how demand/supply turns into a multiplier
+ * multiplier = clamp(1 + sensitivity * (demand / supply - 1), 1, maxMultiplier)
+ */
+struct SurgePolicy {
+    double sensitivity = 0.5;
+    double maxMultiplier = 3.0;
+    std::int64_t ttlSeconds = 120;   // an update older than this prices at 1.0
+};
+
+/**
+ * @brief SurgeQuote struct - multiplier in force for a zone
+ * epoch changes whenever the zone's multiplier changes; 0 means base pricing, so
+ * (zone, epoch) identifies a price level for quote caching
+ */
+struct SurgeQuote {
+    double multiplier;
+    std::uint64_t epoch;
+};
+
+/**
+ * @brief SurgePricing class - per-zone surge multipliers with a lock-free read path
+ *
+ * Each zone is one cache line guarded by a sequence counter (seqlock): writers
+ * serialize on a mutex and bump the counter around the update, readers copy the
+ * fields and retry only if the counter moved. A quote is a handful of atomic
+ * loads and never blocks, however often multipliers are refreshed.
+ * Zones are pickup LocationIDs below zoneCount; other locations never surge.
+ */
+class SurgePricing {
+private:
+    struct alignas(cacheLineSize) Zone {
+        std::atomic<std::uint32_t> sequence{0};
+        std::atomic<std::uint64_t> multiplierBits{0};
+        std::atomic<std::int64_t> expiresAt{0};
+        std::atomic<std::uint64_t> epoch{0};
+        std::atomic<std::uint32_t> demand{0};
+        std::atomic<std::uint32_t> supply{0};
+    };
+
+    std::unique_ptr<Zone[]> zones;
+    std::size_t zoneCount;
+    SurgePolicy policy;
+    std::mutex writeMutex;
+    std::uint64_t nextEpoch;
+
+    static std::uint64_t toBits(double value) {
+        std::uint64_t bits;
+        std::memcpy(&bits, &value, sizeof(bits));
+        return bits;
+    }
+
+    static double fromBits(std::uint64_t bits) {
+        double value;
+        std::memcpy(&value, &bits, sizeof(value));
+        return value;
+    }
+
+public:
+    explicit SurgePricing(std::size_t zoneCount, const SurgePolicy& policy = SurgePolicy())
+        : zones(new Zone[zoneCount]), zoneCount(zoneCount), policy(policy), nextEpoch(0) {
+        if (zoneCount == 0) {
+            throw std::invalid_argument("Zone count must be greater than 0");
+        }
+        if (policy.maxMultiplier < 1.0 || policy.sensitivity < 0.0 || policy.ttlSeconds <= 0) {
+            throw std::invalid_argument("Invalid surge policy");
+        }
+    }
+
+    SurgePricing(const SurgePricing&) = delete;
+    SurgePricing& operator=(const SurgePricing&) = delete;
+
+    double multiplierFor(std::uint32_t demand, std::uint32_t supply) const {
+        if (demand == 0) {
+            return 1.0;
+        }
+        if (supply == 0) {
+            return policy.maxMultiplier;
+        }
+        const double ratio = static_cast<double>(demand) / static_cast<double>(supply);
+        return std::clamp(1.0 + policy.sensitivity * (ratio - 1.0), 1.0, policy.maxMultiplier);
+    }
+
+    // Recomputes a zone's multiplier from live counts; valid for ttlSeconds from now
+    void update(ZoneID zone, std::uint32_t demand, std::uint32_t supply,
+                std::int64_t now = currentTimestamp()) {
+        if (zone >= zoneCount) {
+            throw std::invalid_argument("Invalid zone ID");
+        }
+        const double multiplier = multiplierFor(demand, supply);
+        std::lock_guard<std::mutex> lock(writeMutex);
+        Zone& slot = zones[zone];
+        const bool changed = fromBits(slot.multiplierBits.load(std::memory_order_relaxed)) != multiplier
+                          || slot.epoch.load(std::memory_order_relaxed) == 0;
+        const std::uint32_t sequence = slot.sequence.load(std::memory_order_relaxed);
+        slot.sequence.store(sequence + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        slot.multiplierBits.store(toBits(multiplier), std::memory_order_relaxed);
+        slot.expiresAt.store(now + policy.ttlSeconds, std::memory_order_relaxed);
+        if (changed) {
+            slot.epoch.store(++nextEpoch, std::memory_order_relaxed);
+        }
+        slot.demand.store(demand, std::memory_order_relaxed);
+        slot.supply.store(supply, std::memory_order_relaxed);
+        slot.sequence.store(sequence + 2, std::memory_order_release);
+    }
+
+    /**
+     * @brief Multiplier for a zone at time now, without taking any lock
+     * Unknown, never-updated and expired zones quote {1.0, 0}
+     */
+    SurgeQuote quote(ZoneID zone, std::int64_t now) const {
+        if (zone >= zoneCount) {
+            return SurgeQuote{ 1.0, 0 };
+        }
+        const Zone& slot = zones[zone];
+        for (;;) {
+            const std::uint32_t before = slot.sequence.load(std::memory_order_acquire);
+            if ((before & 1u) != 0) {
+                continue;   // writer mid-update
+            }
+            const std::uint64_t bits = slot.multiplierBits.load(std::memory_order_relaxed);
+            const std::int64_t expiresAt = slot.expiresAt.load(std::memory_order_relaxed);
+            const std::uint64_t epoch = slot.epoch.load(std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (slot.sequence.load(std::memory_order_relaxed) != before) {
+                continue;
+            }
+            if (epoch == 0 || now >= expiresAt) {
+                return SurgeQuote{ 1.0, 0 };
+            }
+            return SurgeQuote{ fromBits(bits), epoch };
+        }
+    }
+
+    SurgeQuote quote(ZoneID zone) const { return quote(zone, currentTimestamp()); }
+
+    // Zone key for a ride: its pickup location
+    static ZoneID zoneOf(const Ride& ride) { return ride.getPickupLocationID(); }
+
+    // Prices the ride with its pickup zone's current multiplier; returns the multiplier used
+    double priceRide(Ride& ride, std::int64_t now = currentTimestamp()) const {
+        const double multiplier = quote(zoneOf(ride), now).multiplier;
+        ride.calculateSurgeFare(multiplier);
+        return multiplier;
+    }
+
+    std::uint32_t getDemand(ZoneID zone) const {
+        return zone < zoneCount ? zones[zone].demand.load(std::memory_order_relaxed) : 0;
+    }
+
+    std::uint32_t getSupply(ZoneID zone) const {
+        return zone < zoneCount ? zones[zone].supply.load(std::memory_order_relaxed) : 0;
+    }
+
+    std::size_t getZoneCount() const { return zoneCount; }
+    const SurgePolicy& getPolicy() const { return policy; }
+};
+
+#endif // RIDE_SHARING_SURGE_PRICING_H
@@ -0,0 +1,25 @@
+#ifndef RIDE_SHARING_TEXT_FORMAT_H
+#define RIDE_SHARING_TEXT_FORMAT_H
+
+#include <string>
+#include <charconv>
+#include <cstddef>
+
+/**
+ * @brief Append-only number formatting for the buffered output paths
+ * std::to_chars writes straight into a stack buffer: no locale, no stream state
+ */
+inline void appendInt(std::string& out, long long value) {
+    char buffer[24];
+    auto result = std::to_chars(buffer, buffer + sizeof(buffer), value);
+    out.append(buffer, static_cast<std::size_t>(result.ptr - buffer));
+}
+
+// Two decimals, matching std::fixed << std::setprecision(2)
+inline void appendFixed2(std::string& out, double value) {
+    char buffer[64];
+    auto result = std::to_chars(buffer, buffer + sizeof(buffer), value, std::chars_format::fixed, 2);
+    out.append(buffer, static_cast<std::size_t>(result.ptr - buffer));
+}
+
+#endif // RIDE_SHARING_TEXT_FORMAT_H
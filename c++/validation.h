@@ -0,0 +1,71 @@
+#ifndef RIDE_SHARING_VALIDATION_H
+#define RIDE_SHARING_VALIDATION_H
+
+#include <optional>
+#include <cassert>
+#include <utility>
+#include <cstdint>
+
+/**
+ * @brief ValidationError enum - why a record was rejected, without throwing
+ * Messages match the exceptions the throwing constructors raise
+ */
+enum class ValidationError : std::uint8_t {
+    None = 0,
+    NonPositiveDistance,
+    UnknownLocation,
+    InvalidRideType,
+    InvalidRating,
+    InvalidRideIndex,
+    RegistryFull,
+    NonFiniteDistance
+};
+
+inline const char* validationMessage(ValidationError error) {
+    switch (error) {
+        case ValidationError::None: return "OK";
+        case ValidationError::NonPositiveDistance: return "Distance must be greater than 0";
+        case ValidationError::UnknownLocation: return "Unknown location ID";
+        case ValidationError::InvalidRideType: return "Invalid ride type";
+        case ValidationError::InvalidRating: return "Rating must be between 0 and 5";
+        case ValidationError::InvalidRideIndex: return "Invalid ride index";
+        case ValidationError::RegistryFull: return "Ride registry is full";
+        case ValidationError::NonFiniteDistance: return "Distance must be finite";
+    }
+    return "Unknown validation error";
+}
+
+/**
+ * @brief Result class - a value or the ValidationError that prevented it
+ * Stand-in for std::expected, which needs C++23. Failures are built only by
+ * rejected(), whose error must not be ValidationError::None, so the type
+ * never throws
+ */
+template <typename T>
+class Result {
+private:
+    std::optional<T> stored;
+    ValidationError failure;
+
+    explicit Result(ValidationError error) noexcept : stored(), failure(error) {}
+
+public:
+    Result(T value) : stored(std::move(value)), failure(ValidationError::None) {}
+
+    static Result rejected(ValidationError error) noexcept {
+        assert(error != ValidationError::None && "a rejected Result needs an error");
+        return Result(error);
+    }
+
+    bool ok() const { return failure == ValidationError::None; }
+    explicit operator bool() const { return ok(); }
+    ValidationError error() const { return failure; }
+    const char* message() const { return validationMessage(failure); }
+
+    // Only valid when ok()
+    T& value() & { return *stored; }
+    const T& value() const& { return *stored; }
+    T&& value() && { return std::move(*stored); }
+};
+
+#endif // RIDE_SHARING_VALIDATION_H
@@ -0,0 +1,320 @@
+#ifndef RIDE_SHARING_WRITE_AHEAD_LOG_H
+#define RIDE_SHARING_WRITE_AHEAD_LOG_H
+
+#if !defined(__unix__) && !defined(__APPLE__)
+#error "WriteAheadLog requires POSIX file I/O"
+#endif
+
+#include <string>
+#include <vector>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <cerrno>
+#include <stdexcept>
+#include <system_error>
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "crc32.h"
+#include "ride_binary.h"
+
+/**
+ * @brief WriteAheadLog class - append-only log with group commit
+ *
+ * Each entry is framed as payload length, CRC-32 of kind + payload, kind byte,
+ * payload. append() only copies the entry into an in-memory batch; commit(lsn)
+ * makes it durable. Concurrent committers elect one leader that writes and
+ * fsyncs the whole batch, so durability costs one write + one fsync per batch
+ * rather than per ride. The file header carries a generation number that ties
+ * the log to the snapshot it follows.
+ *
+ * A failed write truncates the file back to the last whole batch and keeps the
+ * batch pending, so a later commit() can retry it. A failed sync is sticky:
+ * the kernel may already have dropped the dirty pages, so every later commit()
+ * throws rather than report entries durable that may not be.
+ */
+class WriteAheadLog {
+public:
+    using LSN = std::uint64_t;
+
+    enum class EntryKind : std::uint8_t {
+        Location = 1,      // uint32 log location ID, name bytes
+        AddDriver = 2,     // int32 driver ID, float64 rating, name bytes
+        AddRider = 3,      // int32 rider ID, name bytes
+        CreateRide = 4,    // 32-byte ride record using log location IDs
+        AssignRide = 5,    // int32 driver ID, uint32 ride index, int64 timestamp
+        RequestRide = 6,   // int32 rider ID, uint32 ride index, int64 timestamp
+        SetFare = 7        // uint32 ride index, float64 fare
+    };
+
+    static constexpr std::uint16_t logKind = 3;
+    static constexpr std::size_t headerSize = 16;
+    static constexpr std::size_t frameSize = 9;
+
+    struct ReplayResult {
+        std::uint64_t generation = 0;
+        std::uint64_t entries = 0;
+        std::size_t validBytes = 0;   // log length up to the last intact entry
+    };
+
+    // Returns false for an entry it cannot apply, e.g. a payload too short for its kind
+    using EntryHandler = std::function<bool(EntryKind, const unsigned char*, std::size_t)>;
+
+private:
+    int fd;
+    std::uint64_t generation;
+
+    std::mutex mutex;
+    std::condition_variable durable;
+    std::vector<unsigned char> pending;
+    LSN nextLsn;
+    LSN durableLsn;
+    bool flushing;
+    bool failed;            // a sync failed; nothing can be reported durable again
+    off_t writtenBytes;     // file length up to the last whole batch
+    std::uint64_t syncCount;
+
+    [[noreturn]] static void fail(const std::string& what) {
+        throw std::system_error(errno, std::generic_category(), what);
+    }
+
+    static void syncFile(int handle) {
+#if defined(__APPLE__)
+        if (::fsync(handle) != 0) {
+#else
+        if (::fdatasync(handle) != 0) {
+#endif
+            fail("Failed to sync write-ahead log");
+        }
+    }
+
+    static void writeAll(int handle, const unsigned char* data, std::size_t size) {
+        while (size > 0) {
+            const ssize_t n = ::write(handle, data, size);
+            if (n < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                fail("Failed to write write-ahead log");
+            }
+            data += n;
+            size -= static_cast<std::size_t>(n);
+        }
+    }
+
+    static std::vector<unsigned char> readFile(const std::string& path) {
+        std::vector<unsigned char> bytes;
+        const int handle = ::open(path.c_str(), O_RDONLY);
+        if (handle < 0) {
+            return bytes;
+        }
+        struct stat info;
+        if (::fstat(handle, &info) == 0) {
+            bytes.resize(static_cast<std::size_t>(info.st_size));
+            std::size_t done = 0;
+            while (done < bytes.size()) {
+                const ssize_t n = ::read(handle, bytes.data() + done, bytes.size() - done);
+                if (n <= 0) {
+                    break;
+                }
+                done += static_cast<std::size_t>(n);
+            }
+            bytes.resize(done);
+        }
+        ::close(handle);
+        return bytes;
+    }
+
+public:
+    /**
+     * @brief Opens (or creates) the log for appending
+     * validBytes from a previous replay() trims a torn tail before new entries go in
+     */
+    WriteAheadLog(const std::string& path, std::uint64_t generation, std::size_t validBytes = 0)
+        : fd(-1), generation(generation), nextLsn(0), durableLsn(0), flushing(false), failed(false),
+          writtenBytes(0), syncCount(0) {
+        fd = ::open(path.c_str(), O_WRONLY | O_CREAT, 0644);
+        if (fd < 0) {
+            fail("Failed to open write-ahead log " + path);
+        }
+        struct stat info;
+        if (::fstat(fd, &info) != 0) {
+            ::close(fd);
+            fail("Failed to stat write-ahead log");
+        }
+        if (validBytes < headerSize) {
+            unsigned char header[headerSize];
+            ride_binary::detail::storeLE<std::uint32_t>(header, ride_binary::magic);
+            ride_binary::detail::storeLE<std::uint16_t>(header + 4, ride_binary::version);
+            ride_binary::detail::storeLE<std::uint16_t>(header + 6, logKind);
+            ride_binary::detail::storeLE<std::uint64_t>(header + 8, generation);
+            if (::ftruncate(fd, 0) != 0) {
+                ::close(fd);
+                fail("Failed to reset write-ahead log");
+            }
+            writeAll(fd, header, headerSize);
+            syncFile(fd);
+        } else if (static_cast<std::size_t>(info.st_size) != validBytes) {
+            if (::ftruncate(fd, static_cast<off_t>(validBytes)) != 0) {
+                ::close(fd);
+                fail("Failed to trim write-ahead log");
+            }
+        }
+        writtenBytes = ::lseek(fd, 0, SEEK_END);
+        if (writtenBytes < 0) {
+            ::close(fd);
+            fail("Failed to seek write-ahead log");
+        }
+    }
+
+    // Makes everything appended so far durable before closing
+    ~WriteAheadLog() {
+        try {
+            commitAll();
+        } catch (...) {
+        }
+        ::close(fd);
+    }
+
+    WriteAheadLog(const WriteAheadLog&) = delete;
+    WriteAheadLog& operator=(const WriteAheadLog&) = delete;
+
+    /**
+     * @brief Reads every intact entry of a log, oldest first
+     * Stops quietly at the first torn or corrupt entry, or one the handler rejects, and
+     * validBytes ends before it; a missing file replays nothing
+     */
+    static ReplayResult replay(const std::string& path, const EntryHandler& handler) {
+        ReplayResult result;
+        const std::vector<unsigned char> bytes = readFile(path);
+        if (bytes.size() < headerSize) {
+            return result;
+        }
+        if (ride_binary::detail::loadLE<std::uint32_t>(bytes.data()) != ride_binary::magic
+            || ride_binary::detail::loadLE<std::uint16_t>(bytes.data() + 4) != ride_binary::version
+            || ride_binary::detail::loadLE<std::uint16_t>(bytes.data() + 6) != logKind) {
+            throw std::runtime_error("Not a write-ahead log: " + path);
+        }
+        result.generation = ride_binary::detail::loadLE<std::uint64_t>(bytes.data() + 8);
+        std::size_t at = headerSize;
+        while (at + frameSize <= bytes.size()) {
+            const std::uint32_t length = ride_binary::detail::loadLE<std::uint32_t>(bytes.data() + at);
+            const std::uint32_t checksum = ride_binary::detail::loadLE<std::uint32_t>(bytes.data() + at + 4);
+            if (at + frameSize + length > bytes.size()) {
+                break;
+            }
+            if (crc32(bytes.data() + at + 8, length + 1) != checksum) {
+                break;
+            }
+            if (!handler(static_cast<EntryKind>(bytes[at + 8]), bytes.data() + at + frameSize, length)) {
+                break;
+            }
+            at += frameSize + length;
+            ++result.entries;
+        }
+        result.validBytes = at;
+        return result;
+    }
+
+    // Buffers one entry; returns its log sequence number for commit()
+    LSN append(EntryKind kind, const unsigned char* payload, std::size_t size) {
+        // The frame stores the length in 32 bits
+        if (size > UINT32_MAX - 1) {
+            throw std::length_error("Log entry is too large");
+        }
+        std::lock_guard<std::mutex> lock(mutex);
+        const std::size_t at = pending.size();
+        pending.resize(at + frameSize + size);
+        unsigned char* frame = pending.data() + at;
+        frame[8] = static_cast<unsigned char>(kind);
+        if (size != 0) {
+            std::memcpy(frame + frameSize, payload, size);
+        }
+        ride_binary::detail::storeLE<std::uint32_t>(frame, static_cast<std::uint32_t>(size));
+        ride_binary::detail::storeLE<std::uint32_t>(frame + 4, crc32(frame + 8, size + 1));
+        return ++nextLsn;
+    }
+
+    /**
+     * @brief Blocks until entry lsn is on disk
+     * The first waiter becomes the leader and flushes the whole pending batch;
+     * everyone else waiting on that batch returns when the leader's fsync completes.
+     * Throws std::system_error if the batch could not be written or synced
+     */
+    void commit(LSN lsn) {
+        std::unique_lock<std::mutex> lock(mutex);
+        while (durableLsn < lsn) {
+            if (failed) {
+                throw std::runtime_error("Write-ahead log is unusable after a failed sync");
+            }
+            if (flushing) {
+                durable.wait(lock);
+                continue;
+            }
+            flushing = true;
+            std::vector<unsigned char> batch;
+            batch.swap(pending);
+            const LSN target = nextLsn;
+            lock.unlock();
+            bool written = false;
+            try {
+                writeAll(fd, batch.data(), batch.size());
+                written = true;
+                syncFile(fd);
+            } catch (...) {
+                // Cut off any torn frame so later batches do not land behind it
+                const bool rolledBack = !written && ::ftruncate(fd, writtenBytes) == 0
+                                        && ::lseek(fd, writtenBytes, SEEK_SET) == writtenBytes;
+                lock.lock();
+                if (rolledBack) {
+                    batch.insert(batch.end(), pending.begin(), pending.end());
+                    pending.swap(batch);
+                } else {
+                    failed = true;
+                }
+                flushing = false;
+                durable.notify_all();
+                throw;
+            }
+            lock.lock();
+            writtenBytes += static_cast<off_t>(batch.size());
+            durableLsn = target;
+            flushing = false;
+            ++syncCount;
+            batch.clear();
+            if (pending.empty()) {
+                pending.swap(batch);   // recycle the batch's capacity
+            }
+            durable.notify_all();
+        }
+    }
+
+    void commitAll() {
+        LSN last;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            last = nextLsn;
+        }
+        commit(last);
+    }
+
+    std::uint64_t getGeneration() const { return generation; }
+
+    LSN lastLsn() {
+        std::lock_guard<std::mutex> lock(mutex);
+        return nextLsn;
+    }
+
+    std::uint64_t syncs() {
+        std::lock_guard<std::mutex> lock(mutex);
+        return syncCount;
+    }
+};
+
+#endif // RIDE_SHARING_WRITE_AHEAD_LOG_H